@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "Side.h"
+#include "Usings.h"
+#include "OrderQueue.h"
+#include "FlatPriceMap.h"
+#include "FenwickTree.h"
+
+// One side of Orderbook's ladder: a FIFO per tick (arrays from the side's
+// LevelArena), the occupancy bitmap, and the per-tick resting quantity (as a Fenwick tree for depth queries and as a
+// plain array for L2). Which end of the ladder is "best" is fixed by S, so the
+// engine picks the side once per request and the rest is straight-line code.
+template<Side S>
+class BookSide
+{
+public:
+    using Traits = SideTraits<S>;
+
+    // levelSlots: queue entries reserved up front for all levels together.
+    BookSide(Price maxPrice, size_t levelSlots)
+        : arena_(levelSlots)
+        , levels_(static_cast<size_t>(maxPrice) + 1)
+        , prices_(static_cast<size_t>(maxPrice))
+        , depth_(static_cast<size_t>(maxPrice) + 1)
+        , quantity_(static_cast<size_t>(maxPrice) + 1)
+    { }
+
+    bool InRange(Price price) const { return prices_.InRange(price); }
+    std::size_t LevelCount() const { return prices_.Count(); }
+
+    std::optional<Price> Best() const
+    {
+        if constexpr (S == Side::Buy) return prices_.GetMax();
+        else return prices_.GetMin();
+    }
+
+    std::optional<Price> Worst() const
+    {
+        if constexpr (S == Side::Buy) return prices_.GetMin();
+        else return prices_.GetMax();
+    }
+
+    // Next occupied level behind `price`.
+    std::optional<Price> NextWorse(Price price) const
+    {
+        if constexpr (S == Side::Buy) return prices_.GetNextLower(price);
+        else return prices_.GetNextHigher(price);
+    }
+
+    OrderQueue& Level(Price price) { return levels_[price]; }
+    const OrderQueue& Level(Price price) const { return levels_[price]; }
+
+    // Queue bookkeeping; the quantity aggregates move separately (AddQuantity).
+    void Push(OrderPool& pool, OrderHandle handle, Price price)
+    {
+        OrderQueue& level = levels_[price];
+        level.PushBack(pool, arena_, handle);
+        if (level.Size() == 1)
+            prices_.AddPrice(price);
+    }
+
+    void Erase(OrderPool& pool, OrderHandle handle, Price price)
+    {
+        levels_[price].Erase(pool, handle);
+        RemoveIfEmpty(price);
+    }
+
+    void RemoveIfEmpty(Price price)
+    {
+        if (levels_[price].IsEmpty())
+            prices_.RemovePrice(price);
+    }
+
+    void AddQuantity(Price price, int64_t delta)
+    {
+        depth_.Add(static_cast<size_t>(price), delta);
+        quantity_[price] += static_cast<uint64_t>(delta);
+    }
+
+    uint64_t QuantityAt(Price price) const { return quantity_[price]; }
+
+    // Resting quantity an opposite-side taker limited at `limit` can reach
+    // (asks <= limit, bids >= limit). O(log n).
+    uint64_t DepthReachedBy(Price limit) const
+    {
+        if (limit < 0)
+            return S == Side::Buy ? depth_.Total() : 0;
+
+        if constexpr (S == Side::Buy) return depth_.SuffixSum(static_cast<size_t>(limit));
+        else return depth_.PrefixSum(static_cast<size_t>(limit));
+    }
+
+    // Visits up to maxLevels occupied levels, best first:
+    // func(price, const OrderQueue&, quantity).
+    template<typename Func>
+    void ForEachLevel(std::size_t maxLevels, Func&& func) const
+    {
+        std::size_t visited = 0;
+        for (auto price = Best(); price && visited < maxLevels; price = NextWorse(*price), ++visited)
+            func(*price, levels_[*price], quantity_[*price]);
+    }
+
+    // Queue entries the arena can hold; more than levelSlots only if the book
+    // outgrew its reservation.
+    size_t LevelCapacity() const { return arena_.Capacity(); }
+
+private:
+    LevelArena arena_; // Before levels_, which point into it
+    std::vector<OrderQueue> levels_;
+    FlatPriceMap prices_;
+    FenwickTree depth_;
+    std::vector<uint64_t> quantity_;
+};
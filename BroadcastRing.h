@@ -0,0 +1,209 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+#include "RingSpan.h"
+
+// Single-producer multi-consumer broadcast ring (Disruptor style).
+//
+// The producer writes each item once; every consumer reads the same slots in
+// place and keeps its own sequence (items it has released), so consumers never
+// write a shared line and nothing is copied per consumer. The producer may not
+// lap the slowest consumer: it caches the minimum consumer sequence and rescans
+// the consumers only when that cached view says the ring is full. With no
+// consumers attached nothing holds the producer back and old items are simply
+// overwritten.
+//
+//   producer: TryClaim(n), write the slots, Commit(k)
+//   consumer: PeekBatch(id, n), read the slots, Release(id, k)
+//
+// Consumers can attach and detach while the producer runs; a new consumer
+// starts at the end of the stream.
+template<typename T>
+class BroadcastRing
+{
+public:
+    using ConsumerId = uint32_t;
+    using Span = RingSpan<T>;
+    using ConstSpan = RingSpan<const T>;
+
+    struct ConsumerStats
+    {
+        uint64_t sequence{ 0 }; // Items released so far (ring index of the next one)
+        uint64_t lag{ 0 };      // Published but not yet released
+        uint64_t maxLag{ 0 };   // Largest backlog the consumer found when it polled
+    };
+
+    BroadcastRing(size_t capacity, size_t maxConsumers)
+        : capacity_{ std::bit_ceil(std::max<size_t>(capacity, 1)) }
+        , mask_{ capacity_ - 1 }
+        , buffer_{ std::make_unique<T[]>(capacity_) }
+        , consumers_{ std::make_unique<Consumer[]>(maxConsumers) }
+        , maxConsumers_{ maxConsumers }
+    {
+        if (capacity == 0 || maxConsumers == 0)
+            throw std::invalid_argument("BroadcastRing capacity and maxConsumers must be non-zero");
+    }
+
+    // Any thread. Throws std::length_error if maxConsumers are attached.
+    ConsumerId AddConsumer()
+    {
+        std::lock_guard lock{ registerMutex_ };
+        for (size_t i = 0; i < maxConsumers_; ++i)
+        {
+            Consumer& consumer = consumers_[i];
+            if (consumer.active.load(std::memory_order_relaxed))
+                continue;
+
+            // The producer may be using a gate computed before it could see
+            // this consumer. Activate with a conservative sequence, then start
+            // at the cursor as of the activation: a producer that missed it
+            // cannot have claimed past that cursor's lap.
+            consumer.sequence.store(cursor_.load(std::memory_order_acquire), std::memory_order_relaxed);
+            consumer.active.store(true, std::memory_order_seq_cst);
+            const uint64_t start = cursor_.load(std::memory_order_seq_cst);
+            consumer.sequence.store(start, std::memory_order_release);
+            consumer.cachedCursor = start;
+            consumer.maxLag.store(0, std::memory_order_relaxed);
+
+            if (i >= consumerSlots_.load(std::memory_order_relaxed))
+                consumerSlots_.store(i + 1, std::memory_order_release);
+            return static_cast<ConsumerId>(i);
+        }
+        throw std::length_error("BroadcastRing has no free consumer slot");
+    }
+
+    // The consumer's own thread, once it has stopped reading. From then on it
+    // no longer holds the producer back.
+    void RemoveConsumer(ConsumerId id)
+    {
+        std::lock_guard lock{ registerMutex_ };
+        consumers_[id].active.store(false, std::memory_order_release);
+    }
+
+    // Producer: up to n slots after the last committed one that every consumer
+    // has released; empty if the slowest consumer is a full ring behind.
+    Span TryClaim(size_t n)
+    {
+        const uint64_t cursor = cursor_.load(std::memory_order_relaxed);
+        if (cursor + n - cachedGate_ > capacity_)
+            cachedGate_ = MinimumSequence(cursor);
+
+        const size_t free = capacity_ - static_cast<size_t>(cursor - cachedGate_);
+        return Span(buffer_.get(), mask_, cursor, std::min(n, free));
+    }
+
+    // Producer: publishes the first n slots of the last claim to every consumer.
+    void Commit(size_t n)
+    {
+        cursor_.store(cursor_.load(std::memory_order_relaxed) + n, std::memory_order_release);
+    }
+
+    // Consumer: up to maxItems published items after its sequence. They are
+    // shared with the other consumers, hence read-only, and stay valid until
+    // Release.
+    ConstSpan PeekBatch(ConsumerId id, size_t maxItems)
+    {
+        Consumer& consumer = consumers_[id];
+        const uint64_t sequence = consumer.sequence.load(std::memory_order_relaxed);
+        if (consumer.cachedCursor - sequence < maxItems)
+            consumer.cachedCursor = cursor_.load(std::memory_order_acquire);
+
+        const size_t available = static_cast<size_t>(consumer.cachedCursor - sequence);
+        if (available > consumer.maxLag.load(std::memory_order_relaxed))
+            consumer.maxLag.store(available, std::memory_order_relaxed);
+        return ConstSpan(buffer_.get(), mask_, sequence, std::min(maxItems, available));
+    }
+
+    // Consumer: done with the first n peeked items; the producer may reuse
+    // their slots once every other consumer is done with them too.
+    void Release(ConsumerId id, size_t n)
+    {
+        std::atomic<uint64_t>& sequence = consumers_[id].sequence;
+        sequence.store(sequence.load(std::memory_order_relaxed) + n, std::memory_order_release);
+    }
+
+    // Consumer: calls func(const T&) for up to maxItems published items, then
+    // releases them. Returns the number visited.
+    template<typename Func>
+    size_t Consume(ConsumerId id, Func&& func, size_t maxItems = SIZE_MAX)
+    {
+        const ConstSpan items = PeekBatch(id, maxItems);
+        for (size_t i = 0; i < items.Size(); ++i)
+            func(items[i]);
+
+        if (!items.IsEmpty())
+            Release(id, items.Size());
+        return items.Size();
+    }
+
+    // Any thread; approximate while the ring is running.
+    ConsumerStats GetConsumerStats(ConsumerId id) const
+    {
+        const Consumer& consumer = consumers_[id];
+        ConsumerStats stats;
+        stats.sequence = consumer.sequence.load(std::memory_order_acquire);
+        const uint64_t published = cursor_.load(std::memory_order_acquire);
+        stats.lag = published > stats.sequence ? published - stats.sequence : 0;
+        stats.maxLag = consumer.maxLag.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    bool IsActive(ConsumerId id) const { return consumers_[id].active.load(std::memory_order_acquire); }
+    size_t ConsumerSlots() const { return consumerSlots_.load(std::memory_order_acquire); } // Ids ever handed out are below this
+
+    uint64_t GetPublished() const { return cursor_.load(std::memory_order_acquire); }
+    size_t Capacity() const { return capacity_; }
+    size_t MaxConsumers() const { return maxConsumers_; }
+
+private:
+    static constexpr size_t CacheLine = 64;
+
+    // One line per consumer: only its owner writes it, the producer reads it
+    // when it rescans.
+    struct alignas(CacheLine) Consumer
+    {
+        std::atomic<uint64_t> sequence{ 0 };
+        std::atomic<bool> active{ false };
+        uint64_t cachedCursor{ 0 };          // Consumer's last view of cursor_
+        std::atomic<uint64_t> maxLag{ 0 };
+    };
+
+    // Slowest attached consumer, or the cursor itself if there is none.
+    uint64_t MinimumSequence(uint64_t cursor)
+    {
+        // Pairs with AddConsumer: the RMW puts `cursor` in the seq_cst order,
+        // so either this scan sees the new consumer or the consumer starts at
+        // or after `cursor`. Only paid when the cached gate runs out.
+        cursor_.fetch_add(0, std::memory_order_seq_cst);
+
+        uint64_t minimum = cursor;
+        const size_t slots = consumerSlots_.load(std::memory_order_acquire);
+        for (size_t i = 0; i < slots; ++i)
+        {
+            const Consumer& consumer = consumers_[i];
+            if (consumer.active.load(std::memory_order_seq_cst))
+                minimum = std::min(minimum, consumer.sequence.load(std::memory_order_acquire));
+        }
+        return minimum;
+    }
+
+    const size_t capacity_;
+    const size_t mask_;
+    const std::unique_ptr<T[]> buffer_;
+    const std::unique_ptr<Consumer[]> consumers_;
+    const size_t maxConsumers_;
+    std::atomic<size_t> consumerSlots_{ 0 }; // Consumer slots ever used; bounds the producer's scan
+    std::mutex registerMutex_;
+
+    // Producer line: its cursor and its last view of the slowest consumer.
+    alignas(CacheLine) std::atomic<uint64_t> cursor_{ 0 };
+    uint64_t cachedGate_{ 0 };
+};
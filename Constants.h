@@ -7,4 +7,5 @@
 struct Constants
 {
     static const Price InvalidPrice = std::numeric_limits<Price>::quiet_NaN();
+    static const OwnerId NoOwner = 0; // Not in any owner index; MassCancel cannot reach it
 };
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "Usings.h"
+
+struct DepthLevel
+{
+    Price price;
+    uint32_t orderCount;
+    uint64_t quantity;
+};
+
+// A reader's copy of the book's best N levels per side, best first.
+struct DepthView
+{
+    uint64_t version{ 0 };      // Publishes so far; unchanged means the book has not moved
+    uint64_t timestamp{ 0 };    // Engine time of the publish (TscClock::NowNs)
+    std::vector<DepthLevel> bids;
+    std::vector<DepthLevel> asks;
+};
+
+// Top-N depth published by the engine thread after each batch and read by any
+// number of strategy / risk threads without locks.
+//
+// Seqlock: the writer makes the sequence odd, stores the levels, and makes it
+// even again; a reader copies the levels between two loads of the sequence
+// and retries if it changed or was odd. The writer never waits for readers and
+// touches no reader-owned cache line. The payload is stored as relaxed atomic
+// words so a torn read is a detected retry, not a data race.
+class DepthSnapshot
+{
+public:
+    struct Stats
+    {
+        uint64_t publishes;
+        uint64_t reads;         // Successful Read()s
+        uint64_t retries;       // Attempts that overlapped a publish
+    };
+
+    explicit DepthSnapshot(size_t depth = 10)
+        : depth_{ depth }
+        , words_(2 * 2 * depth)
+    {
+        if (depth == 0)
+            throw std::invalid_argument("DepthSnapshot depth must be non-zero");
+    }
+
+    size_t Depth() const { return depth_; }
+
+    // Writer (engine thread) only:
+    //   BeginWrite(); SetBid(i, ..)/SetAsk(i, ..) best first; EndWrite(counts).
+    void BeginWrite()
+    {
+        const uint64_t seq = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    void SetBid(size_t i, const DepthLevel& level) { Store((0 * depth_ + i) * 2, level); }
+    void SetAsk(size_t i, const DepthLevel& level) { Store((1 * depth_ + i) * 2, level); }
+
+    void EndWrite(size_t bidCount, size_t askCount, uint64_t timestamp)
+    {
+        bidCount_.store(bidCount < depth_ ? bidCount : depth_, std::memory_order_relaxed);
+        askCount_.store(askCount < depth_ ? askCount : depth_, std::memory_order_relaxed);
+        timestamp_.store(timestamp, std::memory_order_relaxed);
+        sequence_.store(sequence_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Any thread. Single attempt: false if a publish was in progress.
+    bool TryRead(DepthView& view) const
+    {
+        const uint64_t begin = sequence_.load(std::memory_order_acquire);
+        if (begin & 1)
+            return false;
+
+        const size_t bidCount = bidCount_.load(std::memory_order_relaxed);
+        const size_t askCount = askCount_.load(std::memory_order_relaxed);
+        view.bids.resize(bidCount);
+        view.asks.resize(askCount);
+        for (size_t i = 0; i < bidCount; ++i)
+            view.bids[i] = Load((0 * depth_ + i) * 2);
+        for (size_t i = 0; i < askCount; ++i)
+            view.asks[i] = Load((1 * depth_ + i) * 2);
+        view.timestamp = timestamp_.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence_.load(std::memory_order_relaxed) != begin)
+            return false;
+
+        view.version = begin / 2;
+        return true;
+    }
+
+    // Any thread. Retries until it gets a consistent copy; the view's vectors
+    // are reused, so a reader that keeps its view allocates only once.
+    void Read(DepthView& view) const
+    {
+        view.bids.reserve(depth_);
+        view.asks.reserve(depth_);
+
+        uint64_t retries = 0;
+        while (!TryRead(view))
+            ++retries;
+
+        reads_.fetch_add(1, std::memory_order_relaxed);
+        if (retries)
+            retries_.fetch_add(retries, std::memory_order_relaxed);
+    }
+
+    Stats GetStats() const
+    {
+        return {
+            sequence_.load(std::memory_order_relaxed) / 2,
+            reads_.load(std::memory_order_relaxed),
+            retries_.load(std::memory_order_relaxed),
+        };
+    }
+
+private:
+    void Store(size_t word, const DepthLevel& level)
+    {
+        const uint64_t packed = static_cast<uint32_t>(level.price) | (uint64_t{ level.orderCount } << 32);
+        words_[word].store(packed, std::memory_order_relaxed);
+        words_[word + 1].store(level.quantity, std::memory_order_relaxed);
+    }
+
+    DepthLevel Load(size_t word) const
+    {
+        const uint64_t packed = words_[word].load(std::memory_order_relaxed);
+        return {
+            static_cast<Price>(static_cast<uint32_t>(packed)),
+            static_cast<uint32_t>(packed >> 32),
+            words_[word + 1].load(std::memory_order_relaxed),
+        };
+    }
+
+    const size_t depth_;
+
+    // Writer-owned: sequence and payload
+    alignas(64) std::atomic<uint64_t> sequence_{ 0 };
+    std::atomic<size_t> bidCount_{ 0 };
+    std::atomic<size_t> askCount_{ 0 };
+    std::atomic<uint64_t> timestamp_{ 0 };
+    std::vector<std::atomic<uint64_t>> words_; // [side][level] x (price|count, quantity)
+
+    // Reader-owned
+    alignas(64) mutable std::atomic<uint64_t> reads_{ 0 };
+    mutable std::atomic<uint64_t> retries_{ 0 };
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Side.h"
+#include "Usings.h"
+
+// Compact execution record written by the matching loop.
+// `price` is the resting order's price (the execution price).
+struct TradeRecord
+{
+    uint64_t tradeId;
+    OrderId bidOrderId;
+    OrderId askOrderId;
+    uint64_t timestamp;     // Wall clock, ns since epoch
+    Price price;
+    Quantity quantity;
+};
+
+static_assert(sizeof(TradeRecord) == 40, "TradeRecord should stay compact");
+
+// New state of one price level after a processing batch (L2 market data).
+// orderCount == 0 means the level is gone. `sequence` increases by one per
+// delta, so a consumer that attaches mid-stream knows where it joined. The
+// endOfBatch delta is the last of its batch: the subscriber's book is
+// consistent after applying it.
+struct LevelDelta
+{
+    uint64_t sequence;
+    uint64_t quantity;
+    Price price;
+    uint32_t orderCount;
+    Side side;
+    bool endOfBatch;
+};
+
+static_assert(sizeof(LevelDelta) == 32, "LevelDelta should stay compact");
+
+// One slot of the engine's output ring. Every consumer (journal, market data,
+// drop copy, metrics, ...) reads the same event in place and picks the kinds
+// it cares about.
+struct alignas(64) EngineEvent
+{
+    enum class Type : uint8_t
+    {
+        Trade,
+        LevelDelta,
+    };
+
+    union
+    {
+        TradeRecord trade;
+        LevelDelta delta;
+    };
+    Type type;
+};
+
+// A slot per cache line: the engine writing the next event never shares a
+// line with a consumer still reading the previous one.
+static_assert(sizeof(EngineEvent) == 64, "EngineEvent should fill exactly one cache line");
@@ -0,0 +1,294 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include "LockFreeQueue.h"
+#include "SubmitResult.h"
+
+// Multi-producer ingress built from one SPSC LockFreeQueue per producer.
+// Each gateway thread registers once and then pushes only to its own lane, so
+// producers never contend on a shared index (no CAS). The single consumer
+// polls the lanes in one of two orders:
+//
+//   RoundRobin      - rotate the starting lane every poll and take up to an
+//                     equal share of the batch from each lane (fair, cheapest).
+//   TimestampMerged - always take the lane whose head has the smallest
+//                     T::timestamp (ties go to the lower lane id), so requests
+//                     that have arrived are sequenced in submission-time order.
+//                     A lane that is momentarily empty does not hold back others.
+//
+// Flow control is credit based. Each producer may have at most its credit
+// window of requests queued; the consumer hands credits back by draining the
+// lane. A producer with no credits left gets an immediate Throttled (or
+// QueueFull if its window is the whole lane) from TryPush instead of waiting,
+// and only re-reads the consumer's position when it runs out.
+//
+// The consumer reads requests where they sit in the lanes: PeekBatch hands
+// out pointers to ring slots, and the slots (and the producers' credits) come
+// back only when the consumer calls Release after processing them.
+enum class FanInPolicy
+{
+    RoundRobin,
+    TimestampMerged,
+};
+
+template<typename T>
+class FanInQueue
+{
+public:
+    using ProducerId = uint32_t;
+
+    // Per-lane counters, readable from any thread.
+    struct LaneStats
+    {
+        size_t creditWindow;
+        uint64_t accepted;
+        uint64_t queueFull;
+        uint64_t throttled;
+        uint64_t highWaterMark;     // Deepest the lane was when the consumer polled it
+    };
+
+    FanInQueue(size_t laneCapacity, size_t maxProducers, FanInPolicy policy = FanInPolicy::RoundRobin)
+        : laneCapacity_{ std::bit_ceil(laneCapacity) } // LockFreeQueue rounds up the same way
+        , policy_{ policy }
+        , lanes_(maxProducers)
+    {
+        if (maxProducers == 0)
+            throw std::invalid_argument("FanInQueue needs at least one producer lane");
+        if (laneCapacity == 0)
+            throw std::invalid_argument("FanInQueue lanes need at least one slot");
+    }
+
+    // Cold path: allocates the producer's ring. Thread-safe. The credit window
+    // is capped at the lane's free slots; 0 grants all of them.
+    ProducerId RegisterProducer(size_t creditWindow = 0)
+    {
+        std::lock_guard lock(registerMutex_);
+        const size_t id = laneCount_.load(std::memory_order_relaxed);
+        if (id == lanes_.size())
+            throw std::length_error("FanInQueue: all producer lanes are registered");
+
+        const size_t slots = SlotsPerLane();
+        lanes_[id] = std::make_unique<Lane>(laneCapacity_, creditWindow == 0 || creditWindow > slots ? slots : creditWindow);
+        laneCount_.store(id + 1, std::memory_order_release);
+        return static_cast<ProducerId>(id);
+    }
+
+    // Producer side: only the thread that owns `producer` may push to it.
+    // Never waits; see SubmitResult.
+    SubmitResult TryPush(ProducerId producer, const T& item)
+    {
+        return TryEmplace(producer, [&item](T& slot) { slot = item; });
+    }
+
+    // As TryPush, but fill(T&) writes the item straight into its claimed slot.
+    template<typename Fill>
+    SubmitResult TryEmplace(ProducerId producer, Fill&& fill)
+    {
+        Lane& lane = *lanes_[producer];
+        const uint64_t sent = lane.accepted.load(std::memory_order_relaxed);
+        if (sent == lane.creditLimit && !Refill(lane, sent))
+        {
+            const bool throttled = lane.creditWindow < SlotsPerLane();
+            auto& rejects = throttled ? lane.throttled : lane.queueFull;
+            rejects.store(rejects.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return throttled ? SubmitResult::Throttled : SubmitResult::QueueFull;
+        }
+
+        // Cannot come back empty: requests in flight <= window <= free slots
+        fill(lane.queue.TryClaim(1)[0]);
+        lane.queue.Commit(1);
+        lane.accepted.store(sent + 1, std::memory_order_relaxed);
+        return SubmitResult::Accepted;
+    }
+
+    // Producer side: requests `producer` can submit right now.
+    size_t Credits(ProducerId producer)
+    {
+        Lane& lane = *lanes_[producer];
+        const uint64_t sent = lane.accepted.load(std::memory_order_relaxed);
+        Refill(lane, sent);
+        return static_cast<size_t>(lane.creditLimit - sent);
+    }
+
+    LaneStats GetLaneStats(ProducerId producer) const
+    {
+        const Lane& lane = *lanes_[producer];
+        return {
+            lane.creditWindow,
+            lane.accepted.load(std::memory_order_relaxed),
+            lane.queueFull.load(std::memory_order_relaxed),
+            lane.throttled.load(std::memory_order_relaxed),
+            lane.highWaterMark.load(std::memory_order_relaxed),
+        };
+    }
+
+    // Consumer side: points out[] at up to maxItems queued items, continuing
+    // after those already peeked, and returns the count. The items stay in
+    // their lanes, valid until Release. If `producers` is set, producers[i]
+    // is the lane out[i] came from.
+    size_t PeekBatch(const T** out, size_t maxItems, ProducerId* producers = nullptr)
+    {
+        const size_t lanes = laneCount_.load(std::memory_order_acquire);
+        if (lanes == 0 || maxItems == 0)
+            return 0;
+
+        return policy_ == FanInPolicy::RoundRobin
+            ? PeekRoundRobin(out, producers, maxItems, lanes)
+            : PeekMerged(out, producers, maxItems, lanes);
+    }
+
+    // Consumer side: the oldest item in `producer`'s lane (peeked or not), or
+    // nullptr if it is empty.
+    const T* Front(ProducerId producer) const { return lanes_[producer]->queue.Front(); }
+
+    // Consumer side: frees every peeked slot, returning the credits.
+    void Release()
+    {
+        const size_t lanes = laneCount_.load(std::memory_order_acquire);
+        for (size_t i = 0; i < lanes; ++i)
+        {
+            Lane& lane = *lanes_[i];
+            if (lane.peeked == 0)
+                continue;
+
+            lane.queue.Release(lane.peeked);
+            lane.peeked = 0;
+        }
+    }
+
+    bool IsEmpty() const
+    {
+        const size_t lanes = laneCount_.load(std::memory_order_acquire);
+        for (size_t i = 0; i < lanes; ++i)
+            if (!lanes_[i]->queue.IsEmpty())
+                return false;
+        return true;
+    }
+
+    size_t Size(ProducerId producer) const { return lanes_[producer]->queue.Size(); }
+    size_t LaneCapacity() const { return laneCapacity_; }
+    size_t SlotsPerLane() const { return laneCapacity_; }
+    size_t ProducerCount() const { return laneCount_.load(std::memory_order_acquire); }
+    FanInPolicy Policy() const { return policy_; }
+
+private:
+    struct Lane
+    {
+        Lane(size_t capacity, size_t window)
+            : queue(capacity)
+            , creditWindow(window)
+            , creditLimit(window)
+        { }
+
+        LockFreeQueue<T> queue;
+        const size_t creditWindow;
+
+        // Producer
+        alignas(64) std::atomic<uint64_t> accepted{ 0 };
+        uint64_t creditLimit;           // `accepted` may reach this before credits are re-read
+        std::atomic<uint64_t> queueFull{ 0 };
+        std::atomic<uint64_t> throttled{ 0 };
+
+        // Consumer
+        alignas(64) std::atomic<uint64_t> highWaterMark{ 0 };
+        size_t peeked{ 0 };             // Items handed out by PeekBatch, not yet released
+    };
+
+    // Producer: takes back the credits the consumer has returned since the
+    // last refill. False if there are still none.
+    static bool Refill(Lane& lane, uint64_t sent)
+    {
+        lane.creditLimit = sent - lane.queue.Size() + lane.creditWindow;
+        return lane.creditLimit != sent;
+    }
+
+    // Consumer: the lane only grows between polls, so its depth when polled
+    // is the peak since the last one.
+    static void RecordDepth(Lane& lane)
+    {
+        const uint64_t depth = lane.queue.Size();
+        if (depth > lane.highWaterMark.load(std::memory_order_relaxed))
+            lane.highWaterMark.store(depth, std::memory_order_relaxed);
+    }
+
+    size_t PeekRoundRobin(const T** out, ProducerId* producers, size_t maxItems, size_t lanes)
+    {
+        const size_t share = maxItems / lanes > 0 ? maxItems / lanes : 1;
+        size_t count = 0;
+
+        for (size_t visited = 0; visited < lanes && count < maxItems; ++visited)
+        {
+            size_t index = cursor_ + visited;
+            if (index >= lanes) index -= lanes;
+
+            Lane& lane = *lanes_[index];
+            const size_t room = maxItems - count;
+            RecordDepth(lane);
+
+            // The ring span starts at the lane's head, so skip what is already out.
+            const auto items = lane.queue.PeekBatch(lane.peeked + (share < room ? share : room));
+            for (size_t i = lane.peeked; i < items.Size(); ++i)
+            {
+                if (producers) producers[count] = static_cast<ProducerId>(index);
+                out[count++] = &items[i];
+            }
+            lane.peeked = items.Size();
+        }
+
+        if (++cursor_ >= lanes) cursor_ = 0;
+        return count;
+    }
+
+    size_t PeekMerged(const T** out, ProducerId* producers, size_t maxItems, size_t lanes)
+    {
+        for (size_t i = 0; i < lanes; ++i)
+            RecordDepth(*lanes_[i]);
+
+        size_t count = 0;
+        while (count < maxItems)
+        {
+            const T* earliest = nullptr;
+            size_t earliestLane = 0;
+            for (size_t i = 0; i < lanes; ++i)
+            {
+                Lane& lane = *lanes_[i];
+                const auto items = lane.queue.PeekBatch(lane.peeked + 1);
+                if (items.Size() <= lane.peeked)
+                    continue;
+
+                const T* head = &items[lane.peeked];
+                if (!earliest || head->timestamp < earliest->timestamp)
+                {
+                    earliest = head;
+                    earliestLane = i;
+                }
+            }
+
+            if (!earliest)
+                break;
+
+            if (producers) producers[count] = static_cast<ProducerId>(earliestLane);
+            out[count++] = earliest;
+            ++lanes_[earliestLane]->peeked;
+        }
+        return count;
+    }
+
+    const size_t laneCapacity_;
+    const FanInPolicy policy_;
+
+    // Fixed-size table; entries [0, laneCount_) are live and never removed.
+    std::vector<std::unique_ptr<Lane>> lanes_;
+    std::atomic<size_t> laneCount_{ 0 };
+    std::mutex registerMutex_;
+
+    size_t cursor_{ 0 }; // Consumer only
+};
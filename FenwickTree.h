@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Binary indexed (Fenwick) tree of cumulative quantity over a fixed index range
+// (e.g. price ticks). Point update and prefix sum are both O(log n) with no
+// allocation after construction, so "how much rests at or better than P" no
+// longer costs a walk over every level.
+class FenwickTree
+{
+public:
+    explicit FenwickTree(size_t size)
+        : tree_(size + 1, 0)
+    { }
+
+    [[nodiscard]] size_t Size() const { return tree_.size() - 1; }
+    [[nodiscard]] uint64_t Total() const { return total_; }
+
+    // Adds delta (may be negative) at index.
+    void Add(size_t index, int64_t delta)
+    {
+        total_ += static_cast<uint64_t>(delta);
+        for (size_t i = index + 1; i < tree_.size(); i += i & (~i + 1))
+            tree_[i] += static_cast<uint64_t>(delta);
+    }
+
+    // Sum of [0, index]; index past the end is clamped.
+    [[nodiscard]] uint64_t PrefixSum(size_t index) const
+    {
+        uint64_t sum = 0;
+        for (size_t i = index < Size() ? index + 1 : Size(); i > 0; i &= i - 1)
+            sum += tree_[i];
+        return sum;
+    }
+
+    // Sum of [index, Size()).
+    [[nodiscard]] uint64_t SuffixSum(size_t index) const
+    {
+        return index == 0 ? total_ : total_ - PrefixSum(index - 1);
+    }
+
+    // Sum of [first, last]; empty if first > last.
+    [[nodiscard]] uint64_t RangeSum(size_t first, size_t last) const
+    {
+        if (first > last)
+            return 0;
+        return PrefixSum(last) - (first == 0 ? 0 : PrefixSum(first - 1));
+    }
+
+private:
+    // Unsigned wrap-around keeps negative deltas exact; every stored partial sum
+    // is a sum of live quantities, so it is never negative in aggregate.
+    std::vector<uint64_t> tree_;
+    uint64_t total_{ 0 };
+};
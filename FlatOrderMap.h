@@ -0,0 +1,192 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include "Usings.h"
+
+// Open-addressing OrderId -> Value index (linear probing).
+// One flat array of {key, value} slots, sized to a power of two up front for
+// the most entries it must hold, so the hot path never allocates or rehashes:
+// once full, Insert fails and the caller decides what to do. Deletion uses backward shifting instead of
+// tombstones, so probe sequences stay short under cancel-heavy flow and a
+// cancel is a single probe (Extract) rather than contains() + at() + erase().
+//
+// OrderId max() is reserved as the empty-slot marker and cannot be stored.
+template<typename Value>
+class FlatOrderMap
+{
+public:
+    static constexpr OrderId EmptyKey = std::numeric_limits<OrderId>::max();
+
+    // Capacity is chosen so maxEntries stays under MaxLoadPercent.
+    explicit FlatOrderMap(size_t maxEntries = 1024)
+    {
+        Allocate(CapacityFor(maxEntries));
+    }
+
+    [[nodiscard]] Value* Find(OrderId key)
+    {
+        for (size_t i = Home(key);; i = Next(i))
+        {
+            Slot& slot = slots_[i];
+            if (slot.key == EmptyKey) return nullptr; // First, so EmptyKey itself is never found
+            if (slot.key == key) return &slot.value;
+        }
+    }
+
+    [[nodiscard]] const Value* Find(OrderId key) const
+    {
+        return const_cast<FlatOrderMap*>(this)->Find(key);
+    }
+
+    [[nodiscard]] bool Contains(OrderId key) const { return Find(key) != nullptr; }
+
+    // Hint the home slot of key into cache ahead of a Find/Extract.
+    void Prefetch(OrderId key) const
+    {
+        __builtin_prefetch(&slots_[Home(key)]);
+    }
+
+    // Returns false if the key is already present (the stored value is kept),
+    // or if the map is full (see IsFull).
+    bool Insert(OrderId key, Value value)
+    {
+        if (key == EmptyKey || size_ >= maxEntries_)
+            return false;
+
+        for (size_t i = Home(key);; i = Next(i))
+        {
+            Slot& slot = slots_[i];
+            if (slot.key == key) return false;
+            if (slot.key == EmptyKey)
+            {
+                slot.key = key;
+                slot.value = value;
+                ++size_;
+                return true;
+            }
+        }
+    }
+
+    // Find and erase in a single probe sequence.
+    std::optional<Value> Extract(OrderId key)
+    {
+        for (size_t i = Home(key);; i = Next(i))
+        {
+            Slot& slot = slots_[i];
+            if (slot.key == EmptyKey) return std::nullopt;
+            if (slot.key == key)
+            {
+                Value value = slot.value;
+                EraseSlot(i);
+                return value;
+            }
+        }
+    }
+
+    bool Erase(OrderId key) { return Extract(key).has_value(); }
+
+    // Grows the table to hold maxEntries. Rehashes every entry: for setup and
+    // maintenance windows, not the hot path.
+    void Reserve(size_t maxEntries)
+    {
+        if (CapacityFor(maxEntries) > slots_.size())
+            Rehash(CapacityFor(maxEntries));
+    }
+
+    void Clear()
+    {
+        for (auto& slot : slots_) slot.key = EmptyKey;
+        size_ = 0;
+    }
+
+    [[nodiscard]] size_t Size() const { return size_; }
+    [[nodiscard]] bool IsEmpty() const { return size_ == 0; }
+    [[nodiscard]] bool IsFull() const { return size_ >= maxEntries_; }
+    [[nodiscard]] size_t MaxEntries() const { return maxEntries_; }
+    [[nodiscard]] size_t Capacity() const { return slots_.size(); }
+
+    // Visits every live entry in slot order (not insertion order).
+    template<typename Func>
+    void ForEach(Func&& func) const
+    {
+        for (const auto& slot : slots_)
+            if (slot.key != EmptyKey)
+                func(slot.key, slot.value);
+    }
+
+private:
+    static constexpr size_t MaxLoadPercent = 70;
+
+    struct Slot
+    {
+        OrderId key{ EmptyKey };
+        Value value{ };
+    };
+
+    static size_t CapacityFor(size_t entries)
+    {
+        return std::bit_ceil(std::max<size_t>(16, entries * 100 / MaxLoadPercent + 1));
+    }
+
+    // Fibonacci hashing: sequential order ids spread across the whole table.
+    size_t Home(OrderId key) const
+    {
+        return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> shift_);
+    }
+
+    size_t Next(size_t i) const { return (i + 1) & mask_; }
+
+    // Backward-shift deletion: pull later members of the cluster into the hole
+    // whenever the hole lies between their home slot and their current slot.
+    void EraseSlot(size_t hole)
+    {
+        for (size_t i = Next(hole);; i = Next(i))
+        {
+            Slot& slot = slots_[i];
+            if (slot.key == EmptyKey) break;
+
+            const size_t home = Home(slot.key);
+            const size_t distanceFromHome = (i - home) & mask_;
+            const size_t distanceToHole = (i - hole) & mask_;
+            if (distanceToHole <= distanceFromHome)
+            {
+                slots_[hole] = slot;
+                hole = i;
+            }
+        }
+
+        slots_[hole].key = EmptyKey;
+        --size_;
+    }
+
+    void Allocate(size_t capacity)
+    {
+        slots_.assign(capacity, Slot{ });
+        maxEntries_ = capacity * MaxLoadPercent / 100;
+        mask_ = capacity - 1;
+        shift_ = 64 - std::countr_zero(capacity);
+        size_ = 0;
+    }
+
+    void Rehash(size_t capacity)
+    {
+        std::vector<Slot> old;
+        old.swap(slots_);
+        Allocate(capacity);
+        for (const auto& slot : old)
+            if (slot.key != EmptyKey)
+                Insert(slot.key, slot.value);
+    }
+
+    std::vector<Slot> slots_;
+    size_t maxEntries_{ 0 };    // MaxLoadPercent of the slots
+    size_t mask_{ 0 };
+    unsigned shift_{ 0 };
+    size_t size_{ 0 };
+};
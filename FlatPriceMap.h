@@ -1,96 +1,69 @@
 #pragma once
 
 #include "Usings.h"
-#include <vector>
-#include <limits>
+#include "HierarchicalBitmap.h"
 #include <optional>
-#include <iostream>
 
-// O(1) Price Lookup using a Flat Array
-// Assumes prices are integers and fall within a reasonable range (e.g., 0 to 1,000,000).
-// For sparse markets or huge price ranges, a hierarchical bitset (or 2-level array) is better.
+// O(1) Price Level Index backed by a hierarchical occupancy bitmap.
+// Assumes prices are integers within [0, maxPrice] (one bit per tick).
+// Best/worst price and "next non-empty level" are a few count-zeros instructions
+// regardless of the gap, so emptying the top level never triggers a linear rescan.
 class FlatPriceMap
 {
 public:
-    FlatPriceMap(size_t maxPrice = 1000000) 
-        : minPrice_(std::numeric_limits<Price>::max())
-        , maxPrice_(std::numeric_limits<Price>::min())
+    FlatPriceMap(size_t maxPrice = 1000000)
+        : levels_(maxPrice + 1)
+    { }
+
+    bool InRange(Price price) const
     {
-        // Vector<bool> is specialized and not thread safe, but we are single threaded.
-        // 1M entries.
-        try {
-            exists_.resize(maxPrice + 1, false);
-        } catch (const std::exception& e) {
-            std::cerr << "FlatPriceMap alloc failed: " << e.what() << std::endl;
-            throw;
-        }
+        return price >= 0 && static_cast<size_t>(price) < levels_.Bits();
     }
 
     void AddPrice(Price price)
     {
-        if (price > maxPrice_) maxPrice_ = price; // Fast update for Bids
-        if (price < minPrice_) minPrice_ = price; // Fast update for Asks
-        
-        if (price >= 0)
-        {
-            const auto idx = static_cast<size_t>(price);
-            if (idx < exists_.size()) exists_[idx] = true;
-        }
+        if (InRange(price)) levels_.Set(static_cast<size_t>(price));
     }
 
     void RemovePrice(Price price)
     {
-        if (price >= 0)
-        {
-            const auto idx = static_cast<size_t>(price);
-            if (idx < exists_.size()) exists_[idx] = false;
-        }
-            
-        // Lazy update of min/max? 
-        // If we removed the max, we need to scan down to find new max.
-        // This is the trade-off. O(1) Add, but Remove might be O(K) where K is gap.
-        
-        if (price == maxPrice_)
-        {
-            // Scan down
-            while (maxPrice_ > 0)
-            {
-                const auto idx = static_cast<size_t>(maxPrice_);
-                if (idx < exists_.size() && exists_[idx]) break;
-                maxPrice_--;
-            }
-        }
-        
-        if (price == minPrice_)
-        {
-            // Scan up
-            while (minPrice_ >= 0)
-            {
-                const auto idx = static_cast<size_t>(minPrice_);
-                if (idx >= exists_.size()) break;
-                if (exists_[idx]) break;
-                minPrice_++;
-            }
-        }
+        if (InRange(price)) levels_.Clear(static_cast<size_t>(price));
     }
 
-    // O(1) Best Price Lookup
-    std::optional<Price> GetBestBid() const
+    bool Contains(Price price) const
+    {
+        return InRange(price) && levels_.Test(static_cast<size_t>(price));
+    }
+
+    size_t Count() const { return levels_.Count(); }
+    bool IsEmpty() const { return levels_.IsEmpty(); }
+
+    std::optional<Price> GetMin() const { return ToPrice(levels_.FindFirst()); }
+    std::optional<Price> GetMax() const { return ToPrice(levels_.FindLast()); }
+
+    // O(1) Best Price Lookup (bids rank high-to-low, asks low-to-high)
+    std::optional<Price> GetBestBid() const { return GetMax(); }
+    std::optional<Price> GetBestAsk() const { return GetMin(); }
+
+    // Next occupied level strictly beyond `price` in the given direction.
+    std::optional<Price> GetNextHigher(Price price) const
     {
-        if (maxPrice_ == std::numeric_limits<Price>::min() || !exists_[maxPrice_]) 
-            return std::nullopt;
-        return maxPrice_;
+        if (price < 0) return GetMin();
+        return ToPrice(levels_.FindNext(static_cast<size_t>(price) + 1));
     }
 
-    std::optional<Price> GetBestAsk() const
+    std::optional<Price> GetNextLower(Price price) const
     {
-        if (minPrice_ == std::numeric_limits<Price>::max() || !exists_[minPrice_]) 
-            return std::nullopt;
-        return minPrice_;
+        if (price <= 0) return std::nullopt;
+        return ToPrice(levels_.FindPrev(static_cast<size_t>(price) - 1));
     }
 
 private:
-    std::vector<bool> exists_;
-    Price minPrice_;
-    Price maxPrice_;
+    static std::optional<Price> ToPrice(size_t index)
+    {
+        if (index == HierarchicalBitmap::npos) return std::nullopt;
+        return static_cast<Price>(index);
+    }
+
+    HierarchicalBitmap levels_;
 };
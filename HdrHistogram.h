@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+// Fixed-size log-linear (HDR-style) histogram of uint64 values, e.g. latency in ns.
+//
+// Values below 2^SubBucketBits get one bucket each. Above that, every power of
+// two is split into 2^(SubBucketBits-1) linear sub-buckets, so the relative
+// error is at most 2^-(SubBucketBits-1) (1.6% with the default of 7) across the
+// whole uint64 range. The bucket index is a bit_width and two shifts: no
+// floating point and no allocation when recording.
+//
+// Single writer, any number of concurrent readers. Counts are relaxed atomics,
+// so a reader sees a slightly stale but never torn view while the writer runs.
+template<unsigned SubBucketBits = 7>
+class HdrHistogram
+{
+    static_assert(SubBucketBits >= 2 && SubBucketBits < 32, "SubBucketBits out of range");
+
+public:
+    static constexpr uint64_t SubBucketCount = uint64_t{ 1 } << SubBucketBits;
+    static constexpr uint64_t HalfSubBucketCount = SubBucketCount / 2;
+    static constexpr size_t BucketCount = SubBucketCount + (64 - SubBucketBits) * HalfSubBucketCount;
+
+    // Writer thread only.
+    void Record(uint64_t value)
+    {
+        Bump(counts_[IndexOf(value)]);
+        Bump(total_);
+        if (value > max_.load(std::memory_order_relaxed))
+            max_.store(value, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] uint64_t Count() const { return total_.load(std::memory_order_relaxed); }
+    [[nodiscard]] uint64_t Max() const { return max_.load(std::memory_order_relaxed); }
+
+    // Smallest recorded value v such that `percentile`% of samples are <= v,
+    // reported as the upper edge of its bucket (clamped to Max()). 0 if empty.
+    [[nodiscard]] uint64_t ValueAtPercentile(double percentile) const
+    {
+        const uint64_t total = Count();
+        if (total == 0)
+            return 0;
+
+        // Nearest rank: ceil(p/100 * N), at least 1.
+        const double exact = percentile / 100.0 * static_cast<double>(total);
+        uint64_t rank = static_cast<uint64_t>(exact);
+        if (static_cast<double>(rank) < exact) ++rank;
+        if (rank == 0) rank = 1;
+        if (rank > total) rank = total;
+
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i < BucketCount; ++i)
+        {
+            cumulative += counts_[i].load(std::memory_order_relaxed);
+            if (cumulative >= rank)
+            {
+                const uint64_t high = HighestEquivalentValue(i);
+                const uint64_t max = Max();
+                return high < max ? high : max;
+            }
+        }
+        return Max(); // Counts raced ahead of total_ while scanning
+    }
+
+    // Not safe against a concurrent Record(); call while the writer is idle.
+    void Reset()
+    {
+        for (auto& count : counts_)
+            count.store(0, std::memory_order_relaxed);
+        total_.store(0, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+    static constexpr size_t IndexOf(uint64_t value)
+    {
+        if (value < SubBucketCount)
+            return static_cast<size_t>(value);
+
+        // Keep the top SubBucketBits-1 bits below the leading one.
+        const unsigned shift = static_cast<unsigned>(std::bit_width(value)) - SubBucketBits;
+        const uint64_t top = value >> shift; // in [HalfSubBucketCount, SubBucketCount)
+        return static_cast<size_t>(SubBucketCount + (shift - 1) * HalfSubBucketCount + (top - HalfSubBucketCount));
+    }
+
+    static constexpr uint64_t LowestEquivalentValue(size_t index)
+    {
+        if (index < SubBucketCount)
+            return index;
+
+        const uint64_t offset = index - SubBucketCount;
+        const unsigned shift = static_cast<unsigned>(offset / HalfSubBucketCount) + 1;
+        const uint64_t top = offset % HalfSubBucketCount + HalfSubBucketCount;
+        return top << shift;
+    }
+
+    static constexpr uint64_t HighestEquivalentValue(size_t index)
+    {
+        if (index < SubBucketCount)
+            return index;
+        if (index == BucketCount - 1)
+            return UINT64_MAX;
+        return LowestEquivalentValue(index + 1) - 1;
+    }
+
+private:
+    // Plain load/store rather than an RMW: there is only one writer.
+    static void Bump(std::atomic<uint64_t>& counter)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    std::array<std::atomic<uint64_t>, BucketCount> counts_{ };
+    std::atomic<uint64_t> total_{ 0 };
+    std::atomic<uint64_t> max_{ 0 };
+};
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Three-level 64-ary occupancy bitmap over a fixed index range (e.g. price ticks).
+//
+//   leaf_    : one bit per index
+//   middle_  : one bit per non-zero leaf word
+//   summary_ : one bit per non-zero middle word
+//
+// The summary words are scanned linearly (4 words for a 1M-tick ladder), every
+// other step is a single count-trailing/leading-zeros on one word. So first/last
+// and next/previous set index cost a handful of instructions regardless of how
+// far apart the occupied indices are.
+class HierarchicalBitmap
+{
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    explicit HierarchicalBitmap(size_t bits)
+        : bits_{ bits }
+        , leaf_(WordsFor(bits), 0)
+        , middle_(WordsFor(leaf_.size()), 0)
+        , summary_(WordsFor(middle_.size()), 0)
+    { }
+
+    [[nodiscard]] size_t Bits() const { return bits_; }
+    [[nodiscard]] size_t Count() const { return count_; }
+    [[nodiscard]] bool IsEmpty() const { return count_ == 0; }
+
+    [[nodiscard]] bool Test(size_t index) const
+    {
+        return (leaf_[index >> 6] >> (index & 63)) & 1;
+    }
+
+    void Set(size_t index)
+    {
+        const size_t word = index >> 6;
+        const uint64_t bit = Bit(index);
+        if (leaf_[word] & bit)
+            return;
+
+        ++count_;
+        const bool wasEmpty = leaf_[word] == 0;
+        leaf_[word] |= bit;
+        if (!wasEmpty)
+            return;
+
+        const size_t middleWord = word >> 6;
+        const bool middleWasEmpty = middle_[middleWord] == 0;
+        middle_[middleWord] |= Bit(word);
+        if (middleWasEmpty)
+            summary_[middleWord >> 6] |= Bit(middleWord);
+    }
+
+    void Clear(size_t index)
+    {
+        const size_t word = index >> 6;
+        const uint64_t bit = Bit(index);
+        if (!(leaf_[word] & bit))
+            return;
+
+        --count_;
+        leaf_[word] &= ~bit;
+        if (leaf_[word] != 0)
+            return;
+
+        const size_t middleWord = word >> 6;
+        middle_[middleWord] &= ~Bit(word);
+        if (middle_[middleWord] == 0)
+            summary_[middleWord >> 6] &= ~Bit(middleWord);
+    }
+
+    [[nodiscard]] size_t FindFirst() const { return FindNext(0); }
+
+    [[nodiscard]] size_t FindLast() const
+    {
+        return bits_ == 0 ? npos : FindPrev(bits_ - 1);
+    }
+
+    // Lowest set index >= from, or npos.
+    [[nodiscard]] size_t FindNext(size_t from) const
+    {
+        if (from >= bits_)
+            return npos;
+
+        size_t word = from >> 6;
+        uint64_t bits = leaf_[word] & AtOrAbove(from & 63);
+        if (bits)
+            return (word << 6) + std::countr_zero(bits);
+
+        size_t middleWord = word >> 6;
+        bits = middle_[middleWord] & Above(word & 63);
+        if (bits)
+            return DescendFirst(middleWord, bits);
+
+        size_t summaryWord = middleWord >> 6;
+        bits = summary_[summaryWord] & Above(middleWord & 63);
+        while (!bits)
+        {
+            if (++summaryWord == summary_.size())
+                return npos;
+            bits = summary_[summaryWord];
+        }
+
+        middleWord = (summaryWord << 6) + std::countr_zero(bits);
+        return DescendFirst(middleWord, middle_[middleWord]);
+    }
+
+    // Highest set index <= from, or npos.
+    [[nodiscard]] size_t FindPrev(size_t from) const
+    {
+        if (bits_ == 0)
+            return npos;
+        if (from >= bits_)
+            from = bits_ - 1;
+
+        size_t word = from >> 6;
+        uint64_t bits = leaf_[word] & AtOrBelow(from & 63);
+        if (bits)
+            return (word << 6) + HighestBit(bits);
+
+        size_t middleWord = word >> 6;
+        bits = middle_[middleWord] & Below(word & 63);
+        if (bits)
+            return DescendLast(middleWord, bits);
+
+        size_t summaryWord = middleWord >> 6;
+        bits = summary_[summaryWord] & Below(middleWord & 63);
+        while (!bits)
+        {
+            if (summaryWord-- == 0)
+                return npos;
+            bits = summary_[summaryWord];
+        }
+
+        middleWord = (summaryWord << 6) + HighestBit(bits);
+        return DescendLast(middleWord, middle_[middleWord]);
+    }
+
+private:
+    static constexpr size_t WordsFor(size_t bits) { return bits == 0 ? 1 : (bits + 63) >> 6; }
+    static constexpr uint64_t Bit(size_t index) { return uint64_t{ 1 } << (index & 63); }
+    static constexpr size_t HighestBit(uint64_t bits) { return 63 - std::countl_zero(bits); }
+
+    static constexpr uint64_t AtOrAbove(size_t bit) { return ~uint64_t{ 0 } << bit; }
+    static constexpr uint64_t Above(size_t bit) { return bit == 63 ? 0 : ~uint64_t{ 0 } << (bit + 1); }
+    static constexpr uint64_t AtOrBelow(size_t bit) { return bit == 63 ? ~uint64_t{ 0 } : (uint64_t{ 1 } << (bit + 1)) - 1; }
+    static constexpr uint64_t Below(size_t bit) { return (uint64_t{ 1 } << bit) - 1; }
+
+    size_t DescendFirst(size_t middleWord, uint64_t middleBits) const
+    {
+        const size_t word = (middleWord << 6) + std::countr_zero(middleBits);
+        return (word << 6) + std::countr_zero(leaf_[word]);
+    }
+
+    size_t DescendLast(size_t middleWord, uint64_t middleBits) const
+    {
+        const size_t word = (middleWord << 6) + HighestBit(middleBits);
+        return (word << 6) + HighestBit(leaf_[word]);
+    }
+
+    size_t bits_;
+    size_t count_{ 0 };
+    std::vector<uint64_t> leaf_;
+    std::vector<uint64_t> middle_;
+    std::vector<uint64_t> summary_;
+};
@@ -31,6 +31,7 @@
 #include "Usings.h"
 #include "Trade.h"
 #include "Order.h"
+#include "TscClock.h"
 
 /**
  * Zero-Jitter Journaling with Linux io_uring
@@ -86,6 +87,15 @@ struct alignas(64) JournalEntry
     } data;
 };
 
+// An order leaving the book without trading.
+struct OrderCancelled
+{
+    enum class Reason : uint8_t { Client, Expired };
+
+    OrderId order_id;
+    Reason reason;
+};
+
 class IoUringJournaler
 {
 public:
@@ -117,8 +127,7 @@ public:
     {
         JournalEntry entry = convert_to_journal_entry(event);
         entry.sequence_number = sequence_number_.fetch_add(1, std::memory_order_relaxed);
-        entry.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
-            std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+        entry.timestamp = TscClock::WallNs();
         
         // Try to enqueue without blocking
         if (!entry_queue_.try_push(entry))
@@ -136,8 +145,7 @@ public:
     {
         JournalEntry entry = convert_to_journal_entry(event);
         entry.sequence_number = sequence_number_.fetch_add(1, std::memory_order_relaxed);
-        entry.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
-            std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+        entry.timestamp = TscClock::WallNs();
         
         const auto deadline = std::chrono::steady_clock::now() + timeout;
         while (std::chrono::steady_clock::now() < deadline)
@@ -294,7 +302,7 @@ private:
             size_t collected = 0;
             JournalEntry entry;
             
-            auto start_time = std::chrono::high_resolution_clock::now();
+            const uint64_t start_cycles = TscClock::Cycles();
             
             while (collected < batch_size_ && 
                    entry_queue_.try_pop(entry, std::chrono::microseconds(10)))
@@ -313,9 +321,8 @@ private:
                 events_logged_.fetch_add(collected, std::memory_order_relaxed);
                 pending_events_.fetch_sub(collected, std::memory_order_relaxed);
                 
-                auto end_time = std::chrono::high_resolution_clock::now();
-                auto latency_us = std::chrono::duration_cast<std::chrono::microseconds>(
-                    end_time - start_time).count();
+                const double latency_us = static_cast<double>(
+                    TscClock::ToNs(TscClock::Cycles() - start_cycles)) / 1000.0;
                 
                 // Track max latency
                 double current_max = max_latency_us_.load(std::memory_order_relaxed);
@@ -458,6 +465,12 @@ private:
                 entry.data.add.order_type = event->GetOrderType();
             }
         }
+        else if constexpr (std::is_same_v<T, OrderCancelled>)
+        {
+            entry.type = JournalEntry::Type::Cancel;
+            entry.data.cancel.order_id = event.order_id;
+            entry.data.cancel.reason = static_cast<uint8_t>(event.reason);
+        }
         else if constexpr (std::is_same_v<T, Order>)
         {
             entry.type = JournalEntry::Type::Add;
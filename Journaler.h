@@ -8,9 +8,11 @@
 #include <atomic>
 #include <mutex>
 #include <condition_variable>
+#include <cstring>
 #include "Order.h"
 #include "OrderModify.h"
 #include "LockFreeQueue.h" // Reuse the ring buffer
+#include "WaitStrategy.h"
 
 // Async Journaler (Zero-Jitter I/O)
 // Writes to a ring buffer, background thread drains to disk.
@@ -20,15 +22,23 @@ public:
     // Raw bytes structure for logging to avoid complex object lifecycle in buffer
     struct LogEntry
     {
-        // Max size enough for Add order (Type+Id+Side+Price+Qty ~ 32 bytes)
+        // Max size enough for Add order (Type+Id+OrderType+Id+Side+Price+Qty+Owner = 40 bytes)
         // We make it simple: just copy the bytes we need.
         char data[64]; 
         size_t length;
     };
 
-    AsyncJournaler(const std::string& filename) 
+    // The writer parks by default, so an idle journal costs no CPU
+    // and the engine's Log() wakes it only when it is actually asleep.
+    AsyncJournaler(const std::string& filename)
+        : AsyncJournaler(filename, WaitStrategy::Config{ WaitPolicy::Blocking })
+    {
+    }
+
+    AsyncJournaler(const std::string& filename, const WaitStrategy::Config& wait)
         : filename_(filename)
         , queue_(65536) // 64k entries buffer
+        , wait_(wait)
         , running_(true)
         , writerThread_(&AsyncJournaler::WriterLoop, this)
     {
@@ -37,66 +47,100 @@ public:
     ~AsyncJournaler()
     {
         running_.store(false, std::memory_order_release);
+        wait_.Notify();
         if (writerThread_.joinable()) writerThread_.join();
     }
+
+    WaitStrategy::Stats GetWaitStats() const { return wait_.GetStats(); }
     
     template<typename T>
     void Log(const T& req)
     {
-        LogEntry entry;
+        // Claim a slot first and serialize straight into it.
+        // If full, we drop log (or busy wait, here we busy wait slightly or drop)
+        // For zero jitter, we should have large enough buffer.
+        auto slot = queue_.TryClaim(1);
+        while (slot.IsEmpty()) {
+            // Drop or Yield? In strict HFT, dropping log is better than stalling engine.
+            // But for correctness audit, we might stall.
+            // Let's yield once.
+            std::this_thread::yield();
+            slot = queue_.TryClaim(1);
+        }
+        
+        LogEntry& entry = slot[0];
         char* ptr = entry.data;
         
-        // Serialize to stack buffer first
-        *reinterpret_cast<int*>(ptr) = static_cast<int>(req.type); ptr += sizeof(int);
-        *reinterpret_cast<OrderId*>(ptr) = req.orderId; ptr += sizeof(OrderId);
+        // Records are packed, so fields are copied rather than stored through
+        // casts (they are unaligned).
+        ptr = Put(ptr, static_cast<int>(req.type));
+        ptr = Put(ptr, req.orderId);
         
         if (static_cast<int>(req.type) == 0 && req.order) // Add
         {
-            *reinterpret_cast<OrderType*>(ptr) = req.order->GetOrderType(); ptr += sizeof(OrderType);
-            *reinterpret_cast<OrderId*>(ptr) = req.order->GetOrderId(); ptr += sizeof(OrderId);
-            *reinterpret_cast<Side*>(ptr) = req.order->GetSide(); ptr += sizeof(Side);
-            *reinterpret_cast<Price*>(ptr) = req.order->GetPrice(); ptr += sizeof(Price);
-            *reinterpret_cast<Quantity*>(ptr) = req.order->GetInitialQuantity(); ptr += sizeof(Quantity);
+            ptr = Put(ptr, req.order->GetOrderType());
+            ptr = Put(ptr, req.order->GetOrderId());
+            ptr = Put(ptr, req.order->GetSide());
+            ptr = Put(ptr, req.order->GetPrice());
+            ptr = Put(ptr, req.order->GetRemainingQuantity());
+            ptr = Put(ptr, req.owner);
         }
         else if (static_cast<int>(req.type) == 2) // Modify
         {
-             *reinterpret_cast<OrderModify*>(ptr) = req.modify; ptr += sizeof(OrderModify);
+            ptr = Put(ptr, req.modify);
+        }
+        else if (static_cast<int>(req.type) == 3) // MassCancel
+        {
+            ptr = Put(ptr, req.massCancel.owner);
+            ptr = Put(ptr, req.massCancel.minPrice);
+            ptr = Put(ptr, req.massCancel.maxPrice);
+            ptr = Put(ptr, req.massCancel.buys);
+            ptr = Put(ptr, req.massCancel.sells);
         }
         
         entry.length = ptr - entry.data;
         
-        // Push to Ring Buffer (Non-blocking)
-        // If full, we drop log (or busy wait, here we busy wait slightly or drop)
-        // For zero jitter, we should have large enough buffer.
-        while (!queue_.Push(entry)) {
-            // Drop or Yield? In strict HFT, dropping log is better than stalling engine.
-            // But for correctness audit, we might stall.
-            // Let's yield once.
-            std::this_thread::yield();
-        }
+        queue_.Commit(1);
+        wait_.Notify();
     }
     
 private:
+    static constexpr size_t WriteBatch = 256;
+
+    template<typename V>
+    static char* Put(char* ptr, const V& value)
+    {
+        std::memcpy(ptr, &value, sizeof(V));
+        return ptr + sizeof(V);
+    }
+
     void WriterLoop()
     {
         std::ofstream file(filename_, std::ios::binary | std::ios::out | std::ios::trunc);
         
         while (running_.load(std::memory_order_acquire) || !queue_.IsEmpty())
         {
-            LogEntry entry;
-            if (queue_.Pop(entry))
+            // Write the entries out of the ring in place, then free their slots.
+            const auto entries = queue_.PeekBatch(WriteBatch);
+            if (!entries.IsEmpty())
             {
-                file.write(entry.data, entry.length);
+                wait_.OnWork();
+                for (size_t i = 0; i < entries.Size(); ++i)
+                    file.write(entries[i].data, entries[i].length);
+                queue_.Release(entries.Size());
             }
             else
             {
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                wait_.Idle([this] {
+                    return !running_.load(std::memory_order_relaxed) || !queue_.IsEmpty();
+                });
             }
         }
     }
 
     std::string filename_;
     LockFreeQueue<LogEntry> queue_;
+    WaitStrategy wait_;
     std::atomic<bool> running_;
     std::thread writerThread_;
 };
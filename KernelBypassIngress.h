@@ -33,6 +33,8 @@
 #include "Side.h"
 #include "OrderType.h"
 #include "LockFreeQueue.h"
+#include "WaitStrategy.h"
+#include "TscClock.h"
 
 /**
  * Kernel Bypass Network Integration
@@ -119,6 +121,9 @@ public:
         bool hardware_timestamp = true;
         size_t batch_size = 32; // Packets per batch
         size_t burst_size = 64;   // Max packets per read
+        // Idle behaviour when the ring is empty. The kernel/NIC is the producer
+        // and cannot Notify(), so Blocking is treated as Backoff here.
+        WaitStrategy::Config wait{};
     };
     
     explicit KernelBypassIngress(const Config& config)
@@ -130,7 +135,8 @@ public:
           hardware_timestamp_errors_(0),
           avg_batch_size_(0),
           max_latency_ns_(0),
-          packet_queue_(config.ring_size)
+          packet_queue_(config.ring_size),
+          wait_(poll_wait_config(config.wait))
     {
         initialize_backend();
         start_packet_thread();
@@ -172,7 +178,20 @@ public:
         return stats;
     }
     
+    // Packet thread idle time and backoff sleeps.
+    WaitStrategy::Stats GetWaitStats() const
+    {
+        return wait_.GetStats();
+    }
+    
 private:
+    static WaitStrategy::Config poll_wait_config(WaitStrategy::Config config)
+    {
+        if (config.policy == WaitPolicy::Blocking)
+            config.policy = WaitPolicy::Backoff;
+        return config;
+    }
+    
     void initialize_backend()
     {
         switch (config_.backend)
@@ -329,48 +348,45 @@ private:
 #endif
     }
     
+    using PacketSlots = LockFreeQueue<MarketDataPacket>::Span;
+    
     void packet_processor()
     {
-        std::vector<MarketDataPacket> batch;
-        batch.reserve(config_.batch_size);
-        
         while (running_.load(std::memory_order_acquire))
         {
-            auto start_time = std::chrono::high_resolution_clock::now();
+            const uint64_t start_cycles = TscClock::Cycles();
             
+            // Packets are decoded straight into claimed slots of the orderbook
+            // queue; whatever does not fit (the queue is full) is dropped.
+            size_t received = 0;
             switch (config_.backend)
             {
                 case Backend::AF_PACKET:
-                    process_af_packet_batch(batch);
+                    received = process_af_packet_batch(packet_queue_.TryClaim(config_.burst_size));
                     break;
                 case Backend::MOCK:
-                    process_mock_batch(batch);
+                    received = process_mock_batch(packet_queue_.TryClaim(config_.batch_size));
                     break;
                 default:
                     std::this_thread::sleep_for(std::chrono::microseconds(100));
                     break;
             }
             
-            // Submit batch to orderbook queue
-            if (!batch.empty())
+            if (received == 0)
             {
-                for (const auto& packet : batch)
-                {
-                    if (!packet_queue_.Push(packet))
-                    {
-                        packets_dropped_.fetch_add(1, std::memory_order_relaxed);
-                    }
-                }
-                
-                // Update statistics
-                avg_batch_size_.store(static_cast<double>(batch.size()), std::memory_order_relaxed);
-                batch.clear();
+                wait_.Idle([] { return false; }); // Never parks (see poll_wait_config)
+                continue;
             }
+            wait_.OnWork();
+            
+            // Publish the batch to the orderbook
+            packet_queue_.Commit(received);
+            
+            // Update statistics
+            avg_batch_size_.store(static_cast<double>(received), std::memory_order_relaxed);
             
             // Track processing latency
-            auto end_time = std::chrono::high_resolution_clock::now();
-            auto latency_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
-                end_time - start_time).count();
+            const double latency_ns = static_cast<double>(TscClock::ToNs(TscClock::Cycles() - start_cycles));
             
             double current_max = max_latency_ns_.load(std::memory_order_relaxed);
             while (latency_ns > current_max && 
@@ -381,8 +397,10 @@ private:
         }
     }
     
-    void process_af_packet_batch(std::vector<MarketDataPacket>& batch)
+    // Returns the number of slots filled.
+    size_t process_af_packet_batch(const PacketSlots& slots)
     {
+        size_t count = 0;
 #ifdef __linux__
         // Process packets from AF_PACKET ring
         for (size_t i = 0; i < config_.burst_size; ++i)
@@ -393,10 +411,16 @@ private:
             if (tphdr->tp_status & TP_STATUS_USER)
             {
                 // Parse packet and convert to MarketDataPacket
-                MarketDataPacket packet = parse_packet((uint8_t*)tphdr + tphdr->tp_net);
-                packet.timestamp_ns = tphdr->tp_sec * 1000000000ULL + tphdr->tp_nsec;
-                
-                batch.push_back(packet);
+                if (count < slots.Size())
+                {
+                    MarketDataPacket& packet = slots[count++];
+                    packet = parse_packet((uint8_t*)tphdr + tphdr->tp_net);
+                    packet.timestamp_ns = tphdr->tp_sec * 1000000000ULL + tphdr->tp_nsec;
+                }
+                else
+                {
+                    packets_dropped_.fetch_add(1, std::memory_order_relaxed);
+                }
                 
                 // Mark frame as available for kernel
                 tphdr->tp_status = TP_STATUS_KERNEL;
@@ -409,18 +433,13 @@ private:
                 break; // No more packets available
             }
         }
-        
-        // Small yield if no packets
-        if (batch.empty())
-        {
-            std::this_thread::yield();
-        }
 #else
-        (void)batch;
+        (void)slots;
 #endif
+        return count;
     }
     
-    void process_mock_batch(std::vector<MarketDataPacket>& batch)
+    size_t process_mock_batch(const PacketSlots& slots)
     {
         // Generate synthetic market data for testing
         static std::mt19937 gen(std::random_device{}());
@@ -428,14 +447,20 @@ private:
         static std::uniform_int_distribution<> price_dist(99, 101);
         static std::uniform_int_distribution<> qty_dist(1, 100);
         
-        for (size_t i = 0; i < config_.batch_size; ++i)
+        // The synthetic feed does not wait for a full queue either.
+        if (slots.Size() < config_.batch_size)
+        {
+            packets_dropped_.fetch_add(config_.batch_size - slots.Size(), std::memory_order_relaxed);
+        }
+        
+        for (size_t i = 0; i < slots.Size(); ++i)
         {
-            MarketDataPacket packet{};
+            MarketDataPacket& packet = slots[i];
+            packet = MarketDataPacket{};
             packet.version = 1;
             packet.message_type = (i % 4 == 0) ? 1 : 0; // Mix of add and cancel orders
             packet.sequence_number = mock_sequence_++;
-            packet.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
-                std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+            packet.timestamp_ns = static_cast<uint32_t>(TscClock::WallNs());
             packet.symbol_id = mock_symbol_id_;
             
             if (packet.message_type == 0) // Add order
@@ -452,13 +477,13 @@ private:
                 packet.data.cancel_order.reason = 1; // User cancel
             }
             
-            batch.push_back(packet);
             packets_received_.fetch_add(1, std::memory_order_relaxed);
             bytes_received_.fetch_add(sizeof(MarketDataPacket), std::memory_order_relaxed);
         }
         
         // Simulate realistic inter-packet timing
         std::this_thread::sleep_for(std::chrono::microseconds(10));
+        return slots.Size();
     }
     
     MarketDataPacket parse_packet(const uint8_t* data)
@@ -492,6 +517,7 @@ private:
     
     // Packet queue for orderbook consumption
     LockFreeQueue<MarketDataPacket> packet_queue_;
+    WaitStrategy wait_;
     std::thread packet_thread_;
     
     // Backend-specific data
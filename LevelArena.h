@@ -0,0 +1,103 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "Usings.h"
+
+// Backing store for OrderQueue's per-level arrays. A block holds `capacity`
+// entries (a handle value and a Quantity each, as two parallel arrays), with
+// capacity a power of two from MinCapacity up. Blocks are carved from a chunk
+// reserved and faulted in up front, and a block a level outgrows goes on a
+// free list for its size, so opening or doubling a level normally takes no
+// heap allocation. Once the reservation is used up another chunk is
+// allocated (counted in Capacity()).
+//
+// Single-threaded (one book side, on the engine thread). Blocks never move
+// and only go back to the heap with the arena.
+class LevelArena
+{
+public:
+    using HandleValue = std::uint64_t;
+
+    static constexpr std::uint32_t MinCapacity = 8;
+    static constexpr size_t EntryBytes = sizeof(HandleValue) + sizeof(Quantity);
+    static constexpr size_t ChunkEntries = size_t{ 1 } << 16; // Growth step once the reservation is used
+
+    struct Block
+    {
+        HandleValue* handles;
+        Quantity* quantities;
+    };
+
+    explicit LevelArena(size_t reservedEntries = 0)
+    {
+        freeLists_.fill(nullptr);
+        if (reservedEntries > 0)
+            AddChunk(reservedEntries);
+    }
+
+    LevelArena(const LevelArena&) = delete;
+    LevelArena& operator=(const LevelArena&) = delete;
+
+    // capacity: a power of two >= MinCapacity.
+    Block Allocate(std::uint32_t capacity)
+    {
+        std::byte*& head = freeLists_[ClassOf(capacity)];
+        std::byte* bytes = head;
+        if (bytes)
+            std::memcpy(&head, bytes, sizeof(head)); // A free block holds the next one's address
+        else
+            bytes = Carve(capacity);
+        return { reinterpret_cast<HandleValue*>(bytes), reinterpret_cast<Quantity*>(bytes + capacity * sizeof(HandleValue)) };
+    }
+
+    void Free(Block block, std::uint32_t capacity)
+    {
+        std::byte* bytes = reinterpret_cast<std::byte*>(block.handles);
+        std::byte*& head = freeLists_[ClassOf(capacity)];
+        std::memcpy(bytes, &head, sizeof(head));
+        head = bytes;
+    }
+
+    // Entries the chunks allocated so far can hold.
+    size_t Capacity() const { return capacity_; }
+
+private:
+    static size_t ClassOf(std::uint32_t capacity) { return static_cast<size_t>(std::countr_zero(capacity / MinCapacity)); }
+
+    std::byte* Carve(std::uint32_t capacity)
+    {
+        const size_t bytes = capacity * EntryBytes;
+        if (chunkLeft_ < bytes)
+            AddChunk(std::max<size_t>(ChunkEntries, capacity));
+
+        std::byte* block = chunkCursor_;
+        chunkCursor_ += bytes;
+        chunkLeft_ -= bytes;
+        return block;
+    }
+
+    // The tail of the previous chunk, if any, is left unused.
+    void AddChunk(size_t entries)
+    {
+        const size_t bytes = entries * EntryBytes;
+        chunks_.push_back(std::make_unique_for_overwrite<std::byte[]>(bytes));
+        std::memset(chunks_.back().get(), 0, bytes); // Fault the pages in here, not on the engine's first push
+        chunkCursor_ = chunks_.back().get();
+        chunkLeft_ = bytes;
+        capacity_ += entries;
+    }
+
+    std::vector<std::unique_ptr<std::byte[]>> chunks_;
+    std::array<std::byte*, 32> freeLists_;  // Per size class: MinCapacity << class entries
+    std::byte* chunkCursor_{ nullptr };
+    size_t chunkLeft_{ 0 };                 // Bytes left to carve in the current chunk
+    size_t capacity_{ 0 };
+};
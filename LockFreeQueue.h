@@ -1,62 +1,149 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
-#include <vector>
-#include <optional>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
 
+#include "RingSpan.h"
+
+// Single-producer single-consumer ring.
+//
+// The size is rounded up to a power of two and head_/tail_ are free-running
+// 64-bit counters, so a slot is `index & mask_` and every slot is usable (full
+// is tail - head == capacity). Each index sits on its own cache line next to
+// its owner's cached copy of the other one: the producer re-reads head_ only
+// when its cached view says the ring is full, the consumer re-reads tail_ only
+// when its view says it is empty, so in steady state neither side pulls in the
+// other's line.
+//
+// Both sides can work on spans of slots in place instead of copying items:
+//   producer: TryClaim(n), write the slots, Commit(k)
+//   consumer: PeekBatch(n), read the slots, Release(k)
+// Push/Pop/PopBatch are the one-item and copying forms of the same calls.
 template<typename T>
 class LockFreeQueue
 {
 public:
-    explicit LockFreeQueue(size_t size) : buffer_(size), capacity_(size), head_(0), tail_(0) {}
+    using Span = RingSpan<T>;
 
-    bool Push(const T& item)
+    explicit LockFreeQueue(size_t size)
+        : capacity_{ std::bit_ceil(std::max<size_t>(size, 1)) }
+        , mask_{ capacity_ - 1 }
+        , buffer_{ std::make_unique<T[]>(capacity_) }
+    { }
+
+    // Producer: up to n free slots after the last committed one, empty if the
+    // ring is full. The consumer sees none of them until Commit.
+    Span TryClaim(size_t n)
+    {
+        const uint64_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail + n - cachedHead_ > capacity_)
+            cachedHead_ = head_.load(std::memory_order_acquire);
+
+        const size_t free = capacity_ - static_cast<size_t>(tail - cachedHead_);
+        return Span(buffer_.get(), mask_, tail, std::min(n, free));
+    }
+
+    // Producer: publishes the first n slots of the last claim.
+    void Commit(size_t n)
     {
-        size_t currentTail = tail_.load(std::memory_order_relaxed);
-        size_t nextTail = (currentTail + 1) % capacity_;
+        tail_.store(tail_.load(std::memory_order_relaxed) + n, std::memory_order_release);
+    }
+
+    // Consumer: up to maxItems published slots from the head, empty if there
+    // are none. They stay owned by the consumer until Release.
+    Span PeekBatch(size_t maxItems)
+    {
+        const uint64_t head = head_.load(std::memory_order_relaxed);
+        if (cachedTail_ - head < maxItems)
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+
+        const size_t available = static_cast<size_t>(cachedTail_ - head);
+        return Span(buffer_.get(), mask_, head, std::min(maxItems, available));
+    }
+
+    // Consumer: hands the first n peeked slots back to the producer.
+    void Release(size_t n)
+    {
+        head_.store(head_.load(std::memory_order_relaxed) + n, std::memory_order_release);
+    }
 
-        if (nextTail == head_.load(std::memory_order_acquire))
-        {
+    bool Push(const T& item)
+    {
+        const Span slot = TryClaim(1);
+        if (slot.IsEmpty())
             return false; // Full
-        }
 
-        buffer_[currentTail] = item;
-        tail_.store(nextTail, std::memory_order_release);
+        slot[0] = item;
+        Commit(1);
         return true;
     }
 
     bool Pop(T& item)
     {
-        size_t currentHead = head_.load(std::memory_order_relaxed);
-
-        if (currentHead == tail_.load(std::memory_order_acquire))
-        {
+        const Span slot = PeekBatch(1);
+        if (slot.IsEmpty())
             return false; // Empty
-        }
 
-        item = buffer_[currentHead];
-        head_.store((currentHead + 1) % capacity_, std::memory_order_release);
+        item = std::move(slot[0]);
+        Release(1);
         return true;
     }
 
+    // Consumer side: the next item to be popped, or nullptr if empty. Reads
+    // tail_ directly, so it is usable from const consumer code.
+    const T* Front() const
+    {
+        const uint64_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire))
+            return nullptr;
+        return &buffer_[head & mask_];
+    }
+
+    // Pops up to maxItems into out with a single acquire of tail_ and a single
+    // release of head_. Returns the number popped (0 if empty).
+    size_t PopBatch(T* out, size_t maxItems)
+    {
+        const Span items = PeekBatch(maxItems);
+        for (size_t i = 0; i < items.Size(); ++i)
+            out[i] = std::move(items[i]);
+
+        if (!items.IsEmpty())
+            Release(items.Size());
+        return items.Size();
+    }
+
     bool IsEmpty() const
     {
         return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
     }
-    
+
+    // Either side, or a third thread for monitoring (then only approximate).
     size_t Size() const
     {
-        size_t head = head_.load(std::memory_order_acquire);
-        size_t tail = tail_.load(std::memory_order_acquire);
-        if (tail >= head) return tail - head;
-        return capacity_ - (head - tail);
+        const uint64_t head = head_.load(std::memory_order_acquire);
+        const uint64_t tail = tail_.load(std::memory_order_acquire);
+        return tail > head ? static_cast<size_t>(tail - head) : 0;
     }
-    
+
     size_t Capacity() const { return capacity_; }
 
 private:
-    std::vector<T> buffer_;
-    size_t capacity_;
-    std::atomic<size_t> head_;
-    std::atomic<size_t> tail_;
+    static constexpr size_t CacheLine = 64;
+
+    const size_t capacity_;
+    const size_t mask_;
+    const std::unique_ptr<T[]> buffer_;
+
+    // Producer line: its index and its last view of the consumer's.
+    alignas(CacheLine) std::atomic<uint64_t> tail_{ 0 };
+    uint64_t cachedHead_{ 0 };
+
+    // Consumer line.
+    alignas(CacheLine) std::atomic<uint64_t> head_{ 0 };
+    uint64_t cachedTail_{ 0 };
 };
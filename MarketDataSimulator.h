@@ -13,6 +13,7 @@
 #include "KernelBypassIngress.h"
 #include "LockFreeQueue.h"
 #include "SharedMemoryMetrics.h"
+#include "TscClock.h"
 
 /**
  * Market Data Simulation Framework (Digital Twin)
@@ -427,12 +428,11 @@ private:
         last_processed_sequence_.store(packet.sequence_number, std::memory_order_relaxed);
         
         // Queue packet for engine processing
-        auto start_process = std::chrono::high_resolution_clock::now();
+        const uint64_t start_cycles = TscClock::Cycles();
         
         if (output_queue_ && output_queue_->Push(packet))
         {
-            auto process_latency = std::chrono::duration_cast<std::chrono::nanoseconds>(
-                std::chrono::high_resolution_clock::now() - start_process);
+            const std::chrono::nanoseconds process_latency{ TscClock::ToNs(TscClock::Cycles() - start_cycles) };
             metrics_->RecordMessageProcessed(process_latency);
         }
         else
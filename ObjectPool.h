@@ -1,56 +1,169 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <algorithm>
 #include <vector>
 #include <memory>
 #include <mutex>
-#include <functional>
-#include <concepts>
-#include <memory_resource>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
 
-template<typename T>
+#include "PoolHandle.h"
+
+// Lock policy for a pool that is only acquired from and released to by one
+// thread (e.g. the engine's own slab): no lock at all.
+struct NoPoolLock
+{
+    void lock() { }
+    void unlock() { }
+};
+
+// Slab allocator handing out generation-checked handles.
+// Objects live in fixed-size chunks that never move once allocated, so a handle
+// can be resolved from any thread that received it through a release/acquire
+// hand-off (e.g. the request queue); resolving a handle is a plain index
+// computation. Acquire/Release share a free list guarded by `Lock`: the
+// default NoPoolLock is for a pool with a single owning thread, std::mutex
+// for one that several threads acquire from. Release and the checked
+// Get/IsLive belong to the owning thread.
+//
+// An optional `Cold` type adds a second per-slot record, stored in its own
+// array beside the objects: same handle, same lifetime, but it never shares a
+// cache line with T. Use it for data the hot path does not read.
+template<typename T, typename Cold = void, typename Lock = NoPoolLock, typename HandleType = PoolHandle>
 class ObjectPool
 {
 public:
-    using ObjectPtr = std::shared_ptr<T>;
+    using Handle = HandleType;
+
+    static constexpr std::uint32_t ChunkBits = 16;
+    static constexpr std::uint32_t ChunkSize = 1u << ChunkBits;
+    static constexpr size_t DefaultMaxSize = size_t{ 1 } << 26; // 64M slots
 
-    ObjectPool(size_t initialSize = 10000) 
-        // Default init for resource_ (uses heap)
+    // Slots are allocated initialSize up front and a chunk at a time after
+    // that, up to maxSize (capped by what the handle can index).
+    explicit ObjectPool(size_t initialSize = 10000, size_t maxSize = DefaultMaxSize)
+        : maxChunks_{ static_cast<std::uint32_t>((std::min<size_t>(std::max(maxSize, initialSize), Handle::MaxSlots) + ChunkSize - 1) >> ChunkBits) }
+        , chunks_{ std::make_unique<std::unique_ptr<Chunk>[]>(maxChunks_) }
     {
-        pool_.reserve(initialSize);
-        for (size_t i = 0; i < initialSize; ++i)
-        {
-             // Let's try standard allocation to debug.
-             T* obj = new T(); 
-             pool_.push_back(std::shared_ptr<T>(obj)); // Standard deleter
-        }
+        std::lock_guard<Lock> lock(lock_);
+        while (capacity_.load(std::memory_order_relaxed) < initialSize)
+            Grow();
+    }
+
+    Handle Acquire()
+    {
+        std::lock_guard<Lock> lock(lock_);
+
+        if (freeList_.empty())
+            Grow();
+
+        const std::uint32_t index = freeList_.back();
+        freeList_.pop_back();
+        return Handle{ index, Generation(index) };
     }
 
-    ObjectPtr Acquire()
+    void Release(Handle handle)
     {
-        std::lock_guard<std::mutex> lock(mutex_);
-        
-        if (pool_.empty())
+        std::lock_guard<Lock> lock(lock_);
+        const std::uint32_t index = handle.Index();
+        if (!handle.IsValid() || Generation(index) != handle.Generation())
+            return; // Stale or double release
+
+        // The last generation is never handed out: a slot that reaches it is
+        // retired, so no stale handle can match a later occupant.
+        std::uint32_t& generation = ChunkOf(index).generations[index & (ChunkSize - 1)];
+        if (++generation == Handle::MaxGeneration)
         {
-            // Standard alloc for fallback
-            T* obj = new T();
-            return std::shared_ptr<T>(obj);
+            ++retired_;
+            return;
         }
+        freeList_.push_back(index);
+    }
+    // Unchecked access for handles the caller owns (book links, request payloads).
+    T& operator[](Handle handle) { return ChunkOf(handle.Index()).objects[handle.Index() & (ChunkSize - 1)]; }
+    const T& operator[](Handle handle) const { return ChunkOf(handle.Index()).objects[handle.Index() & (ChunkSize - 1)]; }
+
+    // Unchecked access to the slot's cold record.
+    template<typename C = Cold> requires (!std::is_void_v<C>)
+    C& ColdOf(Handle handle) { return ChunkOf(handle.Index()).cold.items[handle.Index() & (ChunkSize - 1)]; }
+
+    template<typename C = Cold> requires (!std::is_void_v<C>)
+    const C& ColdOf(Handle handle) const { return ChunkOf(handle.Index()).cold.items[handle.Index() & (ChunkSize - 1)]; }
+
+    // Checked access: nullptr if the slot has been released since the handle was issued.
+    T* Get(Handle handle)
+    {
+        return IsLive(handle) ? &(*this)[handle] : nullptr;
+    }
 
-        ObjectPtr obj = pool_.back();
-        pool_.pop_back();
-        return obj;
+    const T* Get(Handle handle) const
+    {
+        return IsLive(handle) ? &(*this)[handle] : nullptr;
     }
 
-    void Release(ObjectPtr obj)
+    bool IsLive(Handle handle) const
     {
-        std::lock_guard<std::mutex> lock(mutex_);
-        pool_.push_back(obj);
+        return handle.IsValid()
+            && handle.Index() < capacity_.load(std::memory_order_acquire)
+            && Generation(handle.Index()) == handle.Generation();
     }
 
+    size_t Capacity() const { return capacity_.load(std::memory_order_acquire); }
+    size_t MaxSize() const { return std::min<size_t>(size_t{ maxChunks_ } << ChunkBits, Handle::MaxSlots); }
+
+    // Slots taken out of use because their generation ran out. Owning thread.
+    size_t Retired() const { return retired_; }
+
 private:
-    // std::vector<std::byte> buffer_; // Removed backing store to let PMR manage heap
-    std::pmr::monotonic_buffer_resource resource_;
-    
-    std::vector<ObjectPtr> pool_;
-    std::mutex mutex_;
+    template<typename C>
+    struct ColdArray
+    {
+        std::array<C, ChunkSize> items;
+    };
+    struct NoCold { };
+
+    struct Chunk
+    {
+        std::array<T, ChunkSize> objects;
+        std::conditional_t<std::is_void_v<Cold>, NoCold, ColdArray<Cold>> cold;
+        std::array<std::uint32_t, ChunkSize> generations{ };
+    };
+
+    Chunk& ChunkOf(std::uint32_t index) { return *chunks_[index >> ChunkBits]; }
+    const Chunk& ChunkOf(std::uint32_t index) const { return *chunks_[index >> ChunkBits]; }
+
+    std::uint32_t Generation(std::uint32_t index) const
+    {
+        return ChunkOf(index).generations[index & (ChunkSize - 1)];
+    }
+
+    void Grow()
+    {
+        const std::uint32_t chunk = static_cast<std::uint32_t>(capacity_.load(std::memory_order_relaxed) >> ChunkBits);
+        if (chunk >= maxChunks_)
+            throw std::length_error("ObjectPool exhausted: every slot up to its maximum size is in use");
+
+        // Chunks are never moved or freed, so outstanding handles stay valid.
+        chunks_[chunk] = std::make_unique<Chunk>();
+
+        const std::uint32_t first = chunk << ChunkBits;
+        const std::uint32_t last = static_cast<std::uint32_t>(std::min<size_t>(size_t{ first } + ChunkSize, Handle::MaxSlots));
+        freeList_.reserve(freeList_.size() + (last - first));
+        // Push in reverse so Acquire hands out ascending (cache-adjacent) slots.
+        for (std::uint32_t index = last; index-- > first;)
+            freeList_.push_back(index);
+
+        capacity_.store(last, std::memory_order_release);
+    }
+
+    // Sized once, so resolving a handle never races with the table growing.
+    const std::uint32_t maxChunks_;
+    const std::unique_ptr<std::unique_ptr<Chunk>[]> chunks_;
+    std::vector<std::uint32_t> freeList_;
+    std::atomic<size_t> capacity_{ 0 };
+    size_t retired_{ 0 };
+    Lock lock_;
 };
@@ -1,27 +1,31 @@
 #pragma once
 
-#include <list>
 #include <exception>
+#include <memory>
 #include <format>
 
 #include "OrderType.h"
 #include "Side.h"
 #include "Usings.h"
 #include "Constants.h"
+#include "PoolHandle.h"
+#include "ObjectPool.h"
 
 
-class alignas(64) Order
+// Hot part of an order: the fields the matching loop reads and writes, packed
+// so two records share a cache line. Everything else about the order lives in
+// OrderDetails, in a side table beside the slab (see OrderPool).
+class alignas(32) Order
 {
 public:
     Order() = default;
 
     Order(OrderType orderType, OrderId orderId, Side side, Price price, Quantity quantity)
-        : orderType_{ orderType }
-        , orderId_{ orderId }
-        , side_{ side }
+        : orderId_{ orderId }
         , price_{ price }
-        , initialQuantity_{ quantity }
         , remainingQuantity_{ quantity }
+        , orderType_{ static_cast<std::uint8_t>(orderType) }
+        , side_{ static_cast<std::uint8_t>(side) }
     { }
 
     Order(OrderId orderId, Side side, Quantity quantity)
@@ -29,12 +33,10 @@ public:
     { }
 
     OrderId GetOrderId() const { return orderId_; }
-    Side GetSide() const { return side_; }
+    Side GetSide() const { return static_cast<Side>(side_); }
     Price GetPrice() const { return price_; }
-    OrderType GetOrderType() const { return orderType_; }
-    Quantity GetInitialQuantity() const { return initialQuantity_; }
+    OrderType GetOrderType() const { return static_cast<OrderType>(orderType_); }
     Quantity GetRemainingQuantity() const { return remainingQuantity_; }
-    Quantity GetFilledQuantity() const { return GetInitialQuantity() - GetRemainingQuantity(); }
     bool IsFilled() const { return GetRemainingQuantity() == 0; }
     void Fill(Quantity quantity)
     {
@@ -43,34 +45,69 @@ public:
 
         remainingQuantity_ -= quantity;
     }
+    // Quantity-down amend: the order keeps its place in the queue. The caller
+    // adjusts OrderDetails::initialQuantity by the same amount.
+    void ReduceQuantity(Quantity remaining)
+    {
+        if (remaining > GetRemainingQuantity())
+            throw std::logic_error(std::format("Order ({}) cannot be amended up in place.", GetOrderId()));
+
+        remainingQuantity_ = remaining;
+    }
     void ToGoodTillCancel(Price price) 
     { 
         if (GetOrderType() != OrderType::Market)
             throw std::logic_error(std::format("Order ({}) cannot be filled for more than its remaining quantity.", GetOrderId()));
 
         price_ = price;
-        orderType_ = OrderType::GoodTillCancel;
+        orderType_ = static_cast<std::uint8_t>(OrderType::GoodTillCancel);
     }
 
     void Reset(OrderType orderType, OrderId orderId, Side side, Price price, Quantity quantity)
     {
-        orderType_ = orderType;
         orderId_ = orderId;
-        side_ = side;
         price_ = price;
-        initialQuantity_ = quantity;
         remainingQuantity_ = quantity;
+        queueSlot_ = 0;
+        orderType_ = static_cast<std::uint8_t>(orderType);
+        side_ = static_cast<std::uint8_t>(side);
     }
 
 private:
-    OrderType orderType_;
-    OrderId orderId_;
-    Side side_;
-    Price price_;
-    Quantity initialQuantity_;
-    Quantity remainingQuantity_;
+    // Index of this order in its price level's arrays (see OrderQueue.h), so a
+    // cancel or amend finds its entry without a search.
+    friend class OrderQueue;
+
+    OrderId orderId_{ 0 };
+    Price price_{ 0 };
+    Quantity remainingQuantity_{ 0 };
+    std::uint32_t queueSlot_{ 0 };
+    std::uint8_t orderType_{ 0 };
+    std::uint8_t side_{ 0 };
+    // 6 bytes spare for flags
+};
+
+static_assert(sizeof(Order) == 32, "Order should stay two per cache line");
+
+// Cold part of an order: read on add, amend, cancel and expiry, never while
+// matching. Per-order metadata (owner, client ids, timestamps) goes here.
+struct OrderDetails
+{
+    PoolHandle expiryTimer{ };      // Engine-side expiry (GoodForDay) timer, if one is scheduled
+    PoolHandle ownerPrev{ };        // Links in the owner's list of resting orders
+    PoolHandle ownerNext{ };
+    Quantity initialQuantity{ 0 };  // Less any in-place amends
+    OwnerId owner{ Constants::NoOwner };
 };
 
+static_assert(sizeof(OrderDetails) == 32, "OrderDetails should stay two per cache line");
+
+// Order slab with OrderDetails in a parallel array: same handle, same lifetime.
+// OrderPool belongs to one thread (the engine) and takes no lock;
+// SharedOrderPool is for slabs that gateway threads acquire from too.
+using OrderPool = ObjectPool<Order, OrderDetails>;
+using SharedOrderPool = ObjectPool<Order, OrderDetails, std::mutex>;
+
 #include <memory_resource>
 
 // Forward declare for OrderPointer
@@ -83,5 +120,9 @@ class Order;
 // But to keep it simple for now, let's just make Order compatible with PMR vectors if needed.
 
 using OrderPointer = std::shared_ptr<Order>;
-using OrderPointers = std::list<OrderPointer>;
+
+// Engine-side reference to an Order living in an OrderPool slab.
+// Used on the hot path instead of OrderPointer: copying it is a one-word move
+// with no reference counting.
+using OrderHandle = PoolHandle;
 
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "Order.h"
+#include "ObjectPool.h"
+#include "LevelArena.h"
+#include "SweepKernel.h"
+
+// FIFO of the orders resting at one price level, kept as two parallel arrays
+// (structure of arrays): the remaining quantity of each entry and its handle.
+// A sweep reads only the quantity array, so it can find how many orders an
+// aggressor consumes in one vectorised pass (CountFullyFilled) and retire them
+// in bulk instead of one order at a time.
+//
+// Each order stores its slot index, so cancel and amend are O(1). A cancel
+// leaves a zero-quantity tombstone that the front skips (and a sweep consumes
+// for free); tombstones are packed out when the arrays fill up, and the arrays
+// are reused for the life of the book. They come from the book side's
+// LevelArena, reserved at startup, so a push that opens or doubles a level
+// does not go to the heap.
+// The queue owns neither the slab nor the arena; every call that needs them is
+// given them.
+class OrderQueue
+{
+public:
+    using Pool = OrderPool;
+
+    OrderQueue() = default;
+    OrderQueue(OrderQueue&&) noexcept = default;
+    OrderQueue& operator=(OrderQueue&&) noexcept = default;
+
+    bool IsEmpty() const { return size_ == 0; }
+    std::size_t Size() const { return size_; }
+
+    OrderHandle Front() const { return IsEmpty() ? OrderHandle::Invalid() : ToHandle(Handles()[head_]); }
+
+    void PushBack(Pool& pool, LevelArena& arena, OrderHandle handle)
+    {
+        if (tail_ == capacity_)
+            MakeRoom(pool, arena);
+
+        Order& order = pool[handle];
+        order.queueSlot_ = tail_;
+        Quantities()[tail_] = order.GetRemainingQuantity();
+        Handles()[tail_] = handle.Value();
+        ++tail_;
+        ++size_;
+    }
+
+    // O(1) removal of an order known to be in this queue.
+    void Erase(Pool& pool, OrderHandle handle)
+    {
+        const std::uint32_t slot = pool[handle].queueSlot_;
+        Quantities()[slot] = 0;
+        Handles()[slot] = Tombstone;
+        --size_;
+        Trim();
+    }
+
+    void PopFront(Pool& pool) { Erase(pool, Front()); }
+
+    // Re-reads an order's remaining quantity after an in-place amend.
+    void SyncQuantity(const Pool& pool, OrderHandle handle)
+    {
+        const Order& order = pool[handle];
+        Quantities()[order.queueSlot_] = order.GetRemainingQuantity();
+    }
+
+    // Fills up to `quantity` against the queue in time priority and returns the
+    // quantity filled. onFill(handle, filled) runs for each order touched, after
+    // its Order has been filled; an order it fully fills has already left the
+    // queue, so the callback may retire it.
+    template<typename OnFill>
+    Quantity Fill(Pool& pool, Quantity quantity, OnFill&& onFill)
+    {
+        if (IsEmpty())
+            return 0;
+
+        Quantity* quantities = Quantities();
+        const HandleValue* handles = Handles();
+
+        std::uint64_t consumed = 0;
+        const std::uint32_t begin = head_;
+        const std::uint32_t end = begin + static_cast<std::uint32_t>(
+            CountFullyFilled(quantities + begin, tail_ - begin, quantity, consumed));
+
+        // Whole orders: leave the queue first, then report.
+        for (std::uint32_t slot = begin; slot < end; ++slot)
+        {
+            if (handles[slot] == Tombstone)
+                continue;
+
+            --size_;
+            const OrderHandle handle = ToHandle(handles[slot]);
+            pool[handle].Fill(quantities[slot]);
+            onFill(handle, quantities[slot]);
+        }
+        head_ = end;
+
+        // At most one order is partly filled, and it keeps its place.
+        Quantity filled = static_cast<Quantity>(consumed);
+        const Quantity rest = quantity - filled;
+        if (rest > 0 && head_ < tail_)
+        {
+            const OrderHandle handle = ToHandle(handles[head_]);
+            quantities[head_] -= rest;
+            pool[handle].Fill(rest);
+            onFill(handle, rest);
+            filled += rest;
+        }
+
+        Trim();
+        return filled;
+    }
+
+    // Visits orders in time priority.
+    template<typename Func>
+    void ForEach(const Pool& pool, Func&& func) const
+    {
+        const HandleValue* handles = Handles();
+        for (std::uint32_t slot = head_; slot < tail_; ++slot)
+            if (handles[slot] != Tombstone)
+                func(pool[ToHandle(handles[slot])]);
+    }
+
+private:
+    using HandleValue = LevelArena::HandleValue;
+    static_assert(std::is_same_v<HandleValue, OrderHandle::ValueType>, "LevelArena stores OrderHandle values");
+    static constexpr HandleValue Tombstone = OrderHandle::Invalid().Value();
+
+    Quantity* Quantities() const { return quantities_; }
+    HandleValue* Handles() const { return handles_; }
+
+    static OrderHandle ToHandle(HandleValue value) { return OrderHandle::FromValue(value); }
+
+    // Drops tombstones from both ends; an empty queue starts over at slot 0.
+    void Trim()
+    {
+        if (size_ == 0)
+        {
+            head_ = tail_ = 0;
+            return;
+        }
+
+        const HandleValue* handles = Handles();
+        while (handles[head_] == Tombstone)
+            ++head_;
+        while (handles[tail_ - 1] == Tombstone)
+            --tail_;
+    }
+
+    // The arrays are full. If at most half of the entries are live, pack them
+    // down to slot 0 (dropping tombstones; moved orders get their new slot),
+    // else double the arrays (the old block goes back to the arena).
+    void MakeRoom(Pool& pool, LevelArena& arena)
+    {
+        if (capacity_ > 0 && size_ <= capacity_ / 2)
+        {
+            Quantity* quantities = Quantities();
+            HandleValue* handles = Handles();
+            std::uint32_t count = 0;
+            for (std::uint32_t slot = head_; slot < tail_; ++slot)
+            {
+                if (handles[slot] == Tombstone)
+                    continue;
+
+                quantities[count] = quantities[slot];
+                handles[count] = handles[slot];
+                pool[ToHandle(handles[count])].queueSlot_ = count;
+                ++count;
+            }
+            head_ = 0;
+            tail_ = count;
+            return;
+        }
+
+        // Slots keep their index when the arrays grow.
+        const std::uint32_t capacity = std::max(LevelArena::MinCapacity, capacity_ * 2);
+        const LevelArena::Block block = arena.Allocate(capacity);
+        if (capacity_ > 0)
+        {
+            std::memcpy(block.quantities, Quantities(), std::size_t{ tail_ } * sizeof(Quantity));
+            std::memcpy(block.handles, Handles(), std::size_t{ tail_ } * sizeof(HandleValue));
+            arena.Free({ handles_, quantities_ }, capacity_);
+        }
+        quantities_ = block.quantities;
+        handles_ = block.handles;
+        capacity_ = capacity;
+    }
+
+    // Owned by the arena.
+    Quantity* quantities_{ nullptr };
+    HandleValue* handles_{ nullptr };
+    std::uint32_t capacity_{ 0 };
+    std::uint32_t head_{ 0 };   // First live entry
+    std::uint32_t tail_{ 0 };   // One past the last live entry
+    std::uint32_t size_{ 0 };   // Live entries
+};
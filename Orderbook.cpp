@@ -1,13 +1,95 @@
 #include "Orderbook.h"
 
-#include <numeric>
-#include <chrono>
 #include <ctime>
 #include <iostream>
+#include <iterator>
+#include <stdexcept>
 
-Orderbook::Orderbook() 
-    : requestQueue_(65536)
-    , orderPool_(100000)
+#if !defined(_WIN32)
+#include "SharedMemoryMetrics.h"
+#else
+class SharedMemoryMetrics { }; // shm_open/mmap only; OpenMetrics() rejects a name
+#endif
+
+namespace
+{
+    // What AsyncJournaler::Log writes for one request.
+    struct JournalRecord
+    {
+        Orderbook::Request::Type type;
+        OrderId orderId;
+        const Order* order;
+        OwnerId owner;
+        OrderModify modify;
+        Orderbook::MassCancelFilter massCancel;
+    };
+
+    std::unique_ptr<SharedMemoryMetrics> OpenMetrics(const std::string& name)
+    {
+        if (name.empty())
+            return nullptr;
+#if defined(_WIN32)
+        throw std::invalid_argument("Config::metricsShmName needs POSIX shared memory");
+#else
+        return std::make_unique<SharedMemoryMetrics>(name);
+#endif
+    }
+
+    constexpr size_t ClassIndex(Orderbook::IngressClass ingress) { return static_cast<size_t>(ingress); }
+
+    // Request payload writers; each sets every field its type reads.
+    void EncodeAdd(Orderbook::Request& slot, OrderType type, OrderId orderId, Side side, Price price, Quantity quantity, OwnerId owner)
+    {
+        slot.orderId = orderId;
+        slot.order = { price, quantity, owner };
+        slot.side = static_cast<uint8_t>(side);
+        slot.orderType = static_cast<uint8_t>(type);
+    }
+
+    void EncodeModify(Orderbook::Request& slot, const OrderModify& modify)
+    {
+        slot.orderId = modify.GetOrderId();
+        slot.order = { modify.GetPrice(), modify.GetQuantity(), Constants::NoOwner };
+        slot.side = static_cast<uint8_t>(modify.GetSide());
+    }
+
+    void EncodeMassCancel(Orderbook::Request& slot, const Orderbook::MassCancelFilter& filter)
+    {
+        slot.massCancel = { filter.owner, filter.minPrice, filter.maxPrice };
+        slot.massCancelSides = static_cast<uint8_t>((filter.buys ? 1 : 0) | (filter.sells ? 2 : 0));
+    }
+}
+
+Orderbook::Orderbook(const Config& config)
+    : bids_(MaxPrice, config.levelSlots)
+    , asks_(MaxPrice, config.levelSlots)
+    , touchedBits_((2 * (MaxPrice + 1) + 63) / 64)
+    , events_(config.eventRingCapacity, config.maxEventConsumers)
+    , depthSnapshot_(config.snapshotDepth)
+    , config_(config)
+    , batch_(std::max<size_t>(1, config.batchSize))
+    , batchProducers_(batch_.size())
+    , heldRequests_([&config] {
+        std::vector<HeldRequest> held;
+        if (config.priorityLanes)
+            held.reserve(config.requestQueueSize); // A lane's worth, so holding does not allocate in the loop
+        return held;
+    }())
+    , requestQueues_{ {
+        { config.requestQueueSize, config.maxProducers, config.fanInPolicy },
+        { config.requestQueueSize, config.maxProducers, config.fanInPolicy },
+        { config.requestQueueSize, config.maxProducers, config.fanInPolicy } } }
+    , drainWeights_(DrainWeightsOf(config))
+    , drainBudget_(drainWeights_)
+    , defaultProducer_(RegisterProducer(config.creditWindow))
+    , waitStrategy_(config.wait)
+    , orderPool_(config.orderPoolSize, config.maxLiveOrders)
+    , stagingPool_(0) // Grows on first use
+    , orders_(config.maxLiveOrders)
+    , expiryTimers_(config.timerTickNs, TscClock::WallNs(), config.maxLiveOrders) // At most one timer per resting order
+    , ownerOrders_(std::max<size_t>(1, config.maxOwners))
+    , journaler_(config.journalPath.empty() ? nullptr : std::make_unique<AsyncJournaler>(config.journalPath))
+    , metrics_(OpenMetrics(config.metricsShmName))
     , processingThread_{ [this] { 
         // CPU Pinning (Simple implementation for macOS/Linux compat attempts)
         // Note: macOS uses thread_policy_set, Linux uses pthread_setaffinity_np.
@@ -21,7 +103,6 @@ Orderbook::Orderbook()
         ProcessRequests(); 
     } } 
 { 
-    latencies_.reserve(1000000); // Pre-reserve for stats
     // Warmup(); // Run warmup!
     // Warmup might be causing segfault if it calls AddOrder before things are ready or memory issues.
     // Let's disable Warmup temporarily to verify.
@@ -30,561 +111,1036 @@ Orderbook::Orderbook()
 Orderbook::~Orderbook()
 {
     shutdown_.store(true, std::memory_order_release);
+    waitStrategy_.Notify();
     if (processingThread_.joinable())
         processingThread_.join();
 }
 
 void Orderbook::ProcessRequests()
 {
-    while (!shutdown_.load(std::memory_order_acquire) || !requestQueue_.IsEmpty())
+    const size_t prefetchDistance = config_.prefetchDistance;
+
+    while (!shutdown_.load(std::memory_order_acquire) || !IngressEmpty())
     {
         // Update Queue Depth Metric
         // metrics_.PublishQueueDepth(requestQueue_.Size());
+
+        if (statsResetRequested_.load(std::memory_order_acquire))
+            ResetStats();
         
-        Request req;
-        if (requestQueue_.Pop(req))
+        const bool expiryBacklog = ExpireOrders();
+        if (!touchedLevels_.empty())
+            PublishBookDeltas();
+
+        const size_t count = DrainRequests();
+        if (count == 0)
         {
-            // --- Latency Start (Ingress Time) ---
-            // Actually, we use the timestamp from the request as start time.
-            // If request timestamp is 0 (not set), we skip latency.
-            
-            // --- Risk Check ---
-            if (req.type == Request::Type::Add)
-            {
-                auto riskResult = riskManager_.CheckOrder(req.order);
-                if (riskResult != RiskManager::Result::Allowed)
-                {
-                    // Rejected!
-                    // In a real system, we'd generate a Reject Event.
-                    // Here we just release the order back to pool and skip processing.
-                    orderPool_.Release(req.order);
-                    ordersProcessed_.fetch_add(1, std::memory_order_relaxed);
-                    continue; 
-                }
-            }
-            
-            // --- Journaling (Event Sourcing) ---
-            // journaler_.Log(req);
+            if (expiryBacklog)
+                continue;
+
+            // Busy-spin on an isolated core, yield/park on a laptop (Config::wait).
+            // A park or sleep ends by the next expiry, so a quiet book still
+            // expires its GoodForDay orders on time.
+            waitStrategy_.Idle([this] {
+                return shutdown_.load(std::memory_order_relaxed) || !IngressEmpty()
+                    || statsResetRequested_.load(std::memory_order_relaxed);
+            }, NextExpiryWait());
+            continue;
+        }
+        waitStrategy_.OnWork();
 
-            switch (req.type)
-            {
-            case Request::Type::Add:
-                HandleAddOrder(req.order);
-                break;
-            case Request::Type::Cancel:
-                HandleCancelOrder(req.orderId);
-                break;
-            case Request::Type::Modify:
-                HandleModifyOrder(req.modify);
-                break;
-            }
-            ordersProcessed_.fetch_add(1, std::memory_order_relaxed);
-            // metrics_.IncrementOrdersProcessed();
+        if (prefetchDistance > 0)
+        {
+            for (size_t i = 0; i < std::min(prefetchDistance, count); ++i)
+                PrefetchRequest(*batch_[i]);
+        }
 
-            // --- Latency End ---
-            if (req.timestamp > 0)
+        for (size_t i = 0; i < count; ++i)
+        {
+            // Lookahead: bring in the slot for request i+k, and the level header
+            // for request i+1 (its order slot was prefetched k-1 requests ago).
+            if (prefetchDistance > 0)
             {
-                auto now = std::chrono::high_resolution_clock::now();
-                auto end = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
-                if (end > 0)
-                {
-                    const auto end_u = static_cast<uint64_t>(end);
-                    if (end_u > req.timestamp) latencies_.push_back(end_u - req.timestamp);
-                }
+                if (i + prefetchDistance < count)
+                    PrefetchRequest(*batch_[i + prefetchDistance]);
+                if (i + 1 < count)
+                    PrefetchLevel(*batch_[i + 1]);
             }
+
+            ProcessRequest(*batch_[i], batchProducers_[i]);
         }
-        else
+
+        // The batch was read in place; only now do its slots (and the
+        // producers' credits) go back.
+        for (FanInQueue<Request>& queue : requestQueues_)
+            queue.Release();
+        if (!heldRequests_.empty())
+            DropPassedHeldRequests();
+
+        // Before the processed count, so a caller that waits on it sees the deltas.
+        PublishBookDeltas();
+        tradesExecuted_.store(lastTradeId_, std::memory_order_relaxed);
+        ordersProcessed_.fetch_add(count, std::memory_order_relaxed);
+        if (metrics_)
+            PublishEventMetrics();
+    }
+}
+
+// Points batch_ at queued requests and returns the count. Without priority
+// lanes: one span per producer ring. With them: weighted rounds over the classes
+// in priority order. Each class takes up to its weight per round; a round ends
+// when every class has used its share or run dry, and an unfinished round
+// carries into the next batch. The order depends only on what is queued.
+size_t Orderbook::DrainRequests()
+{
+    const Request** out = batch_.data();
+    const size_t maxItems = batch_.size();
+    if (!config_.priorityLanes)
+        return QueueFor(IngressClass::NewOrders).PeekBatch(out, maxItems);
+
+    size_t count = 0;
+    while (count < maxItems)
+    {
+        const bool freshRound = drainBudget_ == drainWeights_;
+        size_t popped = 0;
+        for (size_t ingress = 0; ingress < IngressClassCount && count < maxItems; ++ingress)
         {
-            // Busy wait or yield? For HFT, busy wait is better for latency, 
-            // but for a laptop, yield is polite.
-            std::this_thread::yield();
+            const size_t take = std::min(drainBudget_[ingress], maxItems - count);
+            if (take == 0)
+                continue;
+
+            const size_t taken = requestQueues_[ingress].PeekBatch(out + count, take, batchProducers_.data() + count);
+            drainBudget_[ingress] -= taken;
+            popped += taken;
+            count += taken;
         }
+
+        if (count == maxItems || (popped == 0 && freshRound))
+            break;
+        drainBudget_ = drainWeights_;
     }
+    return count;
 }
 
-void Orderbook::PruneGoodForDayOrders()
-{    
-    // Logic to be adapted if needed, for now simplified or disabled in event loop
-    // to keep the example focused on the architecture.
+bool Orderbook::IngressEmpty() const
+{
+    return std::all_of(requestQueues_.begin(), requestQueues_.end(),
+        [](const FanInQueue<Request>& queue) { return queue.IsEmpty(); });
 }
 
-void Orderbook::CancelOrders(OrderIds orderIds)
+// Without priority lanes every class maps to the one FIFO lane.
+FanInQueue<Orderbook::Request>& Orderbook::QueueFor(IngressClass ingress)
 {
-    for (const auto& orderId : orderIds)
-        CancelOrderInternal(orderId);
+    return requestQueues_[ClassIndex(config_.priorityLanes ? ingress : IngressClass::NewOrders)];
 }
 
-void Orderbook::CancelOrderInternal(OrderId orderId)
+const FanInQueue<Orderbook::Request>& Orderbook::QueueFor(IngressClass ingress) const
 {
-    if (!orders_.contains(orderId))
-        return;
+    return requestQueues_[ClassIndex(config_.priorityLanes ? ingress : IngressClass::NewOrders)];
+}
 
-    const auto [order, iterator] = orders_.at(orderId);
-    orders_.erase(orderId);
+std::array<size_t, Orderbook::IngressClassCount> Orderbook::DrainWeightsOf(const Config& config)
+{
+    const DrainWeights& weights = config.drainWeights;
+    if (config.priorityLanes && (weights.cancels == 0 || weights.amends == 0 || weights.newOrders == 0))
+        throw std::invalid_argument("Orderbook: a drain weight of 0 would never drain that class");
+    return { weights.cancels, weights.amends, weights.newOrders };
+}
 
-    if (order->GetSide() == Side::Sell)
+void Orderbook::ProcessRequest(const Request& req, ProducerId producer)
+{
+    // --- Latency Start (Ingress Time) ---
+    // Actually, we use the timestamp from the request as start time.
+    // If request timestamp is 0 (not set), we skip latency.
+    
+    // --- Risk Check ---
+    if (req.type == Request::Type::Add)
     {
-        auto price = order->GetPrice();
-        auto& orders = asks_.at(price);
-        orders.erase(iterator);
-        if (orders.empty()) {
-/*
-             asks_.erase(price);
-             askMap_.RemovePrice(price);
-*/
-         }
+        auto riskResult = riskManager_.CheckOrder(req.GetOrderType(), req.order.price, req.order.quantity);
+        if (riskResult != RiskManager::Result::Allowed)
+        {
+            // Rejected!
+            // In a real system, we'd generate a Reject Event.
+            // The order never took a slot, so there is nothing to release.
+            return;
+        }
     }
-    else
+    
+    // Only requests that reach the book are journaled, each in processed
+    // order. Under priority lanes that may differ from submission order; a
+    // request held for its add is journaled when it is applied.
+    switch (req.type)
     {
-        auto price = order->GetPrice();
-        auto& orders = bids_.at(price);
-        orders.erase(iterator);
-        if (orders.empty()) {
-/*
-             bids_.erase(price);
-             bidMap_.RemovePrice(price);
-*/
-         }
+    case Request::Type::Add:
+        Journal(req);
+        HandleAddOrder(NewOrder{ req.GetOrderType(), req.orderId, req.GetSide(),
+            req.order.price, req.order.quantity, req.order.owner });
+        if (!heldRequests_.empty())
+            ApplyHeldRequests(req, producer);
+        break;
+    case Request::Type::Cancel:
+        if (HandleCancelOrder(req.orderId))
+            Journal(req);
+        else if (config_.priorityLanes)
+            HoldRequest(req, producer);
+        break;
+    case Request::Type::Modify:
+        // Journaled after: an amend re-adds internally but journals nothing else.
+        if (HandleModifyOrder(req.GetModify()))
+            Journal(req);
+        else if (config_.priorityLanes)
+            HoldRequest(req, producer);
+        break;
+    case Request::Type::MassCancel:
+        Journal(req);
+        HandleMassCancel(req.GetMassCancel());
+        if (config_.priorityLanes && req.massCancel.owner != Constants::NoOwner)
+            HoldRequest(req, producer); // For the owner's adds it may have overtaken
+        break;
     }
 
-    OnOrderCancelled(order);
+    // --- Latency End ---
+    if (req.timestamp > 0)
+    {
+        const uint64_t end = TscClock::NowNs();
+        if (end > req.timestamp) latencyHistogram_.Record(end - req.timestamp);
+    }
 }
 
-void Orderbook::OnOrderCancelled(OrderPointer order)
+// Priority lanes: keeps a request that found nothing (or, for a mass cancel,
+// not everything) in case an earlier add of its producer is still queued.
+// Kept in submission order.
+void Orderbook::HoldRequest(const Request& req, ProducerId producer)
 {
-    UpdateLevelData(order->GetPrice(), order->GetRemainingQuantity(), LevelData::Action::Remove);
-    // Release back to pool
-    orderPool_.Release(order);
+    auto position = heldRequests_.end();
+    while (position != heldRequests_.begin() && std::prev(position)->request.timestamp > req.timestamp)
+        --position;
+    heldRequests_.insert(position, HeldRequest{ req, producer });
 }
 
-void Orderbook::OnOrderAdded(OrderPointer order)
+// Runs the held requests an add overtook, right after it, as FIFO order would
+// have: a cancel or amend of the order, and a mass cancel that covers it.
+void Orderbook::ApplyHeldRequests(const Request& add, ProducerId producer)
 {
-    UpdateLevelData(order->GetPrice(), order->GetInitialQuantity(), LevelData::Action::Add);
+    for (size_t i = 0; i < heldRequests_.size(); )
+    {
+        const Request& held = heldRequests_[i].request;
+        if (heldRequests_[i].producer != producer || held.timestamp < add.timestamp)
+        {
+            ++i;
+            continue;
+        }
+
+        switch (held.type)
+        {
+        case Request::Type::Cancel:
+        case Request::Type::Modify:
+            if (held.orderId != add.orderId)
+            {
+                ++i;
+                continue;
+            }
+            if (held.type == Request::Type::Cancel ? HandleCancelOrder(held.orderId) : HandleModifyOrder(held.GetModify()))
+                Journal(held);
+            heldRequests_.erase(heldRequests_.begin() + i);
+            break;
+        case Request::Type::MassCancel:
+            // Journaled as a cancel of the one order, like an expiry.
+            if (add.order.owner == held.massCancel.owner
+                && held.GetMassCancel().Covers(add.GetSide(), add.order.price)
+                && CancelOrderInternal(add.orderId))
+            {
+                Request cancel{ };
+                cancel.type = Request::Type::Cancel;
+                cancel.orderId = add.orderId;
+                Journal(cancel);
+            }
+            ++i;
+            break;
+        case Request::Type::Add:
+            ++i;
+            break;
+        }
+    }
 }
 
-void Orderbook::OnOrderMatched(Price price, Quantity quantity, bool isFullyFilled)
+// After a batch: a held request whose producer has no add queued from before
+// it can no longer be overtaken, so a cancel or amend that is still held
+// simply found nothing.
+void Orderbook::DropPassedHeldRequests()
 {
-    UpdateLevelData(price, quantity, isFullyFilled ? LevelData::Action::Remove : LevelData::Action::Match);
+    const FanInQueue<Request>& newOrders = QueueFor(IngressClass::NewOrders);
+    std::erase_if(heldRequests_, [&newOrders](const HeldRequest& held)
+    {
+        const Request* next = newOrders.Front(held.producer);
+        return !next || next->timestamp > held.request.timestamp;
+    });
 }
 
-void Orderbook::UpdateLevelData(Price price, Quantity quantity, LevelData::Action action)
+void Orderbook::Journal(const Request& req)
 {
-    auto& data = data_[price];
+    if (!journaler_)
+        return;
 
-    data.count_ += action == LevelData::Action::Remove ? -1 : action == LevelData::Action::Add ? 1 : 0;
-    if (action == LevelData::Action::Remove || action == LevelData::Action::Match)
+    // The journal format writes an add from an Order; this one is only a view.
+    Order order;
+    JournalRecord record{ req.type, req.orderId, nullptr, Constants::NoOwner, { req.orderId, Side::Buy, 0, 0 }, { } };
+    switch (req.type)
     {
-        data.quantity_ -= quantity;
-    }
-    else
-    {
-        data.quantity_ += quantity;
+    case Request::Type::Add:
+        order = Order{ req.GetOrderType(), req.orderId, req.GetSide(), req.order.price, req.order.quantity };
+        record.order = &order;
+        record.owner = req.order.owner;
+        break;
+    case Request::Type::Modify:
+        record.modify = req.GetModify();
+        break;
+    case Request::Type::MassCancel:
+        record.massCancel = req.GetMassCancel();
+        break;
+    case Request::Type::Cancel:
+        break;
     }
+    journaler_->Log(record);
+}
+
+void Orderbook::PrefetchRequest(const Request& req) const
+{
+    // An add probes the index too (duplicate id check).
+    if (req.type != Request::Type::MassCancel)
+        orders_.Prefetch(req.orderId);
+}
+
+void Orderbook::PrefetchLevel(const Request& req) const
+{
+    if (req.type != Request::Type::Add)
+        return;
+
+    const Price price = req.order.price;
+    if (!bids_.InRange(price))
+        return;
 
-    if (data.count_ == 0)
+    // Write intent: the level is about to be pushed to.
+    __builtin_prefetch(req.GetSide() == Side::Buy ? &bids_.Level(price) : &asks_.Level(price), 1);
+}
+
+// Runs at most Config::expiryBatch due expiries through the cancel path.
+// Returns true if more may be due.
+bool Orderbook::ExpireOrders()
+{
+    if (expiryTimers_.IsEmpty())
+        return false;
+
+    const size_t budget = std::max<size_t>(1, config_.expiryBatch);
+    const size_t expired = expiryTimers_.Advance(TscClock::WallNs(), budget, [this](OrderHandle handle)
     {
-        data_.erase(price);
-        // Note: We handle matcher removal in Cancel/Match logic explicitly 
-        // because UpdateLevelData is generic. 
-        // But for Adds, we need to add to matcher if it's new level.
-    }
-    else if (data.count_ == 1 && action == LevelData::Action::Add)
+        Request cancel{ };
+        cancel.type = Request::Type::Cancel;
+        cancel.orderId = orderPool_[handle].GetOrderId();
+        Journal(cancel);
+        CancelOrderInternal(cancel.orderId);
+    });
+
+    if (expired > 0)
+        ordersExpired_.store(ordersExpired_.load(std::memory_order_relaxed) + expired, std::memory_order_relaxed);
+
+    return expired == budget;
+}
+
+// Longest the engine may sleep before ExpireOrders() has work again.
+std::chrono::nanoseconds Orderbook::NextExpiryWait() const
+{
+    if (expiryTimers_.IsEmpty())
+        return WaitStrategy::NoTimeout;
+
+    const uint64_t deadline = expiryTimers_.NextDeadlineNs();
+    const uint64_t now = TscClock::WallNs();
+    return std::chrono::nanoseconds(deadline > now ? std::min<uint64_t>(deadline - now, INT64_MAX) : 0);
+}
+
+// Wall-clock ns of the next Config::sessionClose in local time. Cached until it passes.
+uint64_t Orderbook::NextSessionClose()
+{
+    const uint64_t now = TscClock::WallNs();
+    if (now < sessionCloseNs_)
+        return sessionCloseNs_;
+
+    const std::time_t seconds = static_cast<std::time_t>(now / 1'000'000'000);
+    std::tm local{ };
+#if defined(_WIN32)
+    localtime_s(&local, &seconds);
+#else
+    localtime_r(&seconds, &local);
+#endif
+
+    const auto timeOfDay = config_.sessionClose.count();
+    for (int days = 0; days < 2; ++days)
     {
-        // New level created (was 0, now 1)
-        // Check side to add to correct matcher? 
-        // UpdateLevelData doesn't know side easily without looking up.
-        // Let's move matcher updates to the call sites (AddOrder/CancelOrder) 
-        // or pass side here.
+        std::tm close = local;
+        close.tm_mday += days;
+        close.tm_hour = static_cast<int>(timeOfDay / 3600);
+        close.tm_min = static_cast<int>(timeOfDay / 60 % 60);
+        close.tm_sec = static_cast<int>(timeOfDay % 60);
+        close.tm_isdst = -1;
+
+        const std::time_t closeSeconds = std::mktime(&close);
+        if (closeSeconds > seconds)
+        {
+            sessionCloseNs_ = static_cast<uint64_t>(closeSeconds) * 1'000'000'000;
+            break;
+        }
     }
+    return sessionCloseNs_;
 }
 
-bool Orderbook::CanFullyFill(Side side, Price price, Quantity quantity) const
+void Orderbook::CancelOrders(OrderIds orderIds)
+{
+    for (const auto& orderId : orderIds)
+        CancelOrderInternal(orderId);
+}
+
+bool Orderbook::CancelOrderInternal(OrderId orderId)
 {
-    if (!CanMatch(side, price))
+    // Single probe: lookup and erase together.
+    const auto extracted = orders_.Extract(orderId);
+    if (!extracted)
         return false;
 
-    std::optional<Price> threshold;
+    const OrderHandle handle = *extracted;
 
-    if (side == Side::Buy)
-    {
-        const auto [askPrice, _] = *asks_.begin();
-        threshold = askPrice;
-    }
+    const Order& order = orderPool_[handle];
+    if (const PoolHandle timer = orderPool_.ColdOf(handle).expiryTimer; timer.IsValid())
+        expiryTimers_.Cancel(timer);
+    UnlinkOwner(handle);
+
+    if (order.GetSide() == Side::Buy)
+        RemoveOrder<Side::Buy>(handle);
     else
+        RemoveOrder<Side::Sell>(handle);
+    return true;
+}
+
+// Takes a resting order off its level and returns the slot to the pool.
+template<Side S>
+void Orderbook::RemoveOrder(OrderHandle handle)
+{
+    const Order& order = orderPool_[handle];
+    SideOf<S>().Erase(orderPool_, handle, order.GetPrice());
+    UpdateLevelData<S>(order.GetPrice(), order.GetRemainingQuantity(), LevelData::Action::Remove);
+    orderPool_.Release(handle);
+}
+
+template<Side S>
+void Orderbook::UpdateLevelData(Price price, Quantity quantity, LevelData::Action action)
+{
+    // Level occupancy is maintained by BookSide's queue calls, which know when
+    // a FIFO becomes empty; here only the quantity aggregates move.
+    const int64_t delta = action == LevelData::Action::Add ? static_cast<int64_t>(quantity) : -static_cast<int64_t>(quantity);
+    SideOf<S>().AddQuantity(price, delta);
+
+    const uint32_t key = static_cast<uint32_t>(price) * 2 + (S == Side::Sell ? 1 : 0);
+    uint64_t& word = touchedBits_[key / 64];
+    const uint64_t bit = uint64_t{ 1 } << (key % 64);
+    if (!(word & bit))
     {
-        const auto [bidPrice, _] = *bids_.begin();
-        threshold = bidPrice;
+        word |= bit;
+        touchedLevels_.push_back(key);
     }
+}
 
-    for (const auto& [levelPrice, levelData] : data_)
+// Writes one event into the next slot of the output ring. If the slowest
+// consumer is a full ring behind, the engine waits for it under its own
+// WaitStrategy; consumers never Notify(), so a Blocking engine re-polls every
+// Config::wait.maxBackoff. At shutdown a consumer that stopped reading can no
+// longer hold it: the event is dropped and counted in GetEventsDropped().
+template<typename Fill>
+void Orderbook::PublishEvent(Fill&& fill)
+{
+    auto slot = events_.TryClaim(1);
+    if (slot.IsEmpty())
     {
-        if (threshold.has_value() && (
-            (side == Side::Buy && threshold.value() > levelPrice) ||
-            (side == Side::Sell && threshold.value() < levelPrice)))
-            continue;
-
-        if ((side == Side::Buy && levelPrice > price) ||
-            (side == Side::Sell && levelPrice < price))
-            continue;
-
-        if (quantity <= levelData.quantity_)
-            return true;
-
-        quantity -= levelData.quantity_;
+        eventStalls_.store(eventStalls_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        const auto hasRoom = [this] { return shutdown_.load(std::memory_order_relaxed) || !events_.TryClaim(1).IsEmpty(); };
+        do
+        {
+            if (shutdown_.load(std::memory_order_relaxed))
+            {
+                eventsDropped_.store(eventsDropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return;
+            }
+            waitStrategy_.Idle(hasRoom, config_.wait.maxBackoff);
+            slot = events_.TryClaim(1);
+        } while (slot.IsEmpty());
+        waitStrategy_.OnWork();
     }
 
-    return false;
+    // Warmup's events are built like any other but never published.
+    fill(slot[0]);
+    if (!eventsMuted_.load(std::memory_order_relaxed))
+        events_.Commit(1);
 }
 
-bool Orderbook::CanMatch(Side side, Price price) const
+void Orderbook::PublishBookDeltas()
 {
-    (void)price;
-    if (side == Side::Buy)
+    const size_t count = touchedLevels_.size();
+    if (count == 0)
+        return;
+
+    PublishDepthSnapshot();
+
+    for (size_t i = 0; i < count; ++i)
     {
-        // Use O(1) Matcher!
-        // auto bestAsk = askMap_.GetBestAsk();
-        // return bestAsk.has_value() && price >= bestAsk.value();
-        return false;
+        const uint32_t key = touchedLevels_[i];
+        touchedBits_[key / 64] &= ~(uint64_t{ 1 } << (key % 64));
+
+        const Price price = static_cast<Price>(key / 2);
+        const Side side = (key & 1) ? Side::Sell : Side::Buy;
+        const uint64_t quantity = side == Side::Buy ? bids_.QuantityAt(price) : asks_.QuantityAt(price);
+        const size_t orders = side == Side::Buy ? bids_.Level(price).Size() : asks_.Level(price).Size();
+
+        PublishEvent([&](EngineEvent& event)
+        {
+            event.type = EngineEvent::Type::LevelDelta;
+            event.delta.sequence = ++lastDeltaSequence_;
+            event.delta.quantity = quantity;
+            event.delta.price = price;
+            event.delta.orderCount = static_cast<uint32_t>(orders);
+            event.delta.side = side;
+            event.delta.endOfBatch = i + 1 == count;
+        });
     }
-    else
+    touchedLevels_.clear();
+}
+
+// Once per batch. Reads each attached consumer's sequence line, so it costs
+// a cache miss per consumer that moved since the last batch.
+void Orderbook::PublishEventMetrics()
+{
+#if !defined(_WIN32)
+    metrics_->UpdateEventRing(events_.GetPublished(), eventStalls_.load(std::memory_order_relaxed));
+
+    const size_t consumers = std::min(events_.ConsumerSlots(), SharedMetrics::MAX_EVENT_CONSUMERS);
+    for (size_t id = 0; id < consumers; ++id)
     {
-        // Use O(1) Matcher!
-        // auto bestBid = bidMap_.GetBestBid();
-        // return bestBid.has_value() && price <= bestBid.value();
-        return false;
+        const auto consumer = static_cast<BroadcastRing<EngineEvent>::ConsumerId>(id);
+        if (events_.IsActive(consumer))
+        {
+            const auto stats = events_.GetConsumerStats(consumer);
+            metrics_->UpdateEventConsumer(id, stats.lag, stats.maxLag);
+        }
+        else
+        {
+            metrics_->UpdateEventConsumer(id, 0, 0);
+        }
     }
+#endif
 }
 
-Trades Orderbook::MatchOrders()
+void Orderbook::PublishDepthSnapshot()
 {
-    Trades trades;
-    trades.reserve(orders_.size());
+    const size_t depth = depthSnapshot_.Depth();
+    size_t bidCount = 0;
+    size_t askCount = 0;
 
-    while (true)
+    depthSnapshot_.BeginWrite();
+    bids_.ForEachLevel(depth, [&](Price price, const OrderQueue& level, uint64_t quantity)
     {
-        if (bids_.empty() || asks_.empty())
-            break;
+        depthSnapshot_.SetBid(bidCount++, { price, static_cast<uint32_t>(level.Size()), quantity });
+    });
+    asks_.ForEachLevel(depth, [&](Price price, const OrderQueue& level, uint64_t quantity)
+    {
+        depthSnapshot_.SetAsk(askCount++, { price, static_cast<uint32_t>(level.Size()), quantity });
+    });
+    depthSnapshot_.EndWrite(bidCount, askCount, TscClock::NowNs());
+}
 
-        auto& [bidPrice, bids] = *bids_.begin();
-        auto& [askPrice, asks] = *asks_.begin();
+template<Side S>
+bool Orderbook::CanFullyFill(Price price, Quantity quantity) const
+{
+    if (!CanMatch<S>(price))
+        return false;
 
-        if (bidPrice < askPrice)
-            break;
+    return SideOf<SideTraits<S>::Opposite>().DepthReachedBy(price) >= quantity;
+}
 
-        while (!bids.empty() && !asks.empty())
-        {
-            auto bid = bids.front();
-            auto ask = asks.front();
+uint64_t Orderbook::GetDepthAtOrBetter(Side side, Price price) const
+{
+    return side == Side::Buy ? asks_.DepthReachedBy(price) : bids_.DepthReachedBy(price);
+}
 
-            Quantity quantity = std::min(bid->GetRemainingQuantity(), ask->GetRemainingQuantity());
+template<Side S>
+bool Orderbook::CanMatch(Price price) const
+{
+    const auto best = SideOf<SideTraits<S>::Opposite>().Best();
+    return best.has_value() && SideTraits<S>::Crosses(price, *best);
+}
 
-            bid->Fill(quantity);
-            ask->Fill(quantity);
+// Sweeps the opposite side with an incoming order limited at `price` and
+// returns the quantity filled. The incoming order is not in the book yet: the
+// book was uncrossed before it arrived, so only it can trade.
+template<Side Aggressor>
+Quantity Orderbook::MatchOrders(OrderId orderId, Price price, Quantity quantity)
+{
+    constexpr bool buying = Aggressor == Side::Buy;
+    auto& restingSide = SideOf<SideTraits<Aggressor>::Opposite>();
 
-            if (bid->IsFilled())
-            {
-                bids.pop_front();
-                orders_.erase(bid->GetOrderId());
-                // Release bid? No, we might need it for the trade record. 
-                // But after matching, it's gone from book.
-                // We should release it if it's not referenced elsewhere.
-                // For now, let's assume Trade holds values, not pointers (checked Trade.h?)
-                // Trade holds TradeInfo which holds ID/Price/Quantity. So safe to release.
-                 orderPool_.Release(bid);
-            }
+    uint64_t matchTime = 0; // Taken on the first fill only; most adds don't trade
+    Quantity remaining = quantity;
 
-            if (ask->IsFilled())
+    while (remaining > 0)
+    {
+        const auto restingPrice = restingSide.Best();
+        if (!restingPrice || !SideTraits<Aggressor>::Crosses(price, *restingPrice))
+            break;
+
+        // Sweep the resting level in one pass.
+        auto& restingLevel = restingSide.Level(*restingPrice);
+        const Quantity filled = restingLevel.Fill(orderPool_, remaining,
+            [&](OrderHandle restingHandle, Quantity fillQuantity)
             {
-                asks.pop_front();
-                orders_.erase(ask->GetOrderId());
-                orderPool_.Release(ask);
-            }
+                const Order& resting = orderPool_[restingHandle];
+                if (matchTime == 0)
+                    matchTime = TscClock::WallNs();
 
-            trades.push_back(Trade{
-                TradeInfo{ bid->GetOrderId(), bid->GetPrice(), quantity },
-                TradeInfo{ ask->GetOrderId(), ask->GetPrice(), quantity } 
+                // Written in place; executes at the resting order's price.
+                PublishEvent([&](EngineEvent& event)
+                {
+                    event.type = EngineEvent::Type::Trade;
+                    event.trade.tradeId = ++lastTradeId_;
+                    event.trade.bidOrderId = buying ? orderId : resting.GetOrderId();
+                    event.trade.askOrderId = buying ? resting.GetOrderId() : orderId;
+                    event.trade.timestamp = matchTime;
+                    event.trade.price = *restingPrice;
+                    event.trade.quantity = fillQuantity;
                 });
 
-            OnOrderMatched(bid->GetPrice(), quantity, bid->IsFilled());
-            OnOrderMatched(ask->GetPrice(), quantity, ask->IsFilled());
-        }
-
-        if (bids.empty())
-        {
-/*
-            bids_.erase(bidPrice);
-            data_.erase(bidPrice);
-            bidMap_.RemovePrice(bidPrice);
-*/
-        }
+                // The queue has already dropped it, and the trade is recorded:
+                // the slot can go back to the pool.
+                if (resting.IsFilled())
+                    RetireOrder(restingHandle);
+            });
 
-        if (asks.empty())
-        {
-/*
-            asks_.erase(askPrice);
-            data_.erase(askPrice);
-            askMap_.RemovePrice(askPrice);
-*/
-        }
+        remaining -= filled;
+        UpdateLevelData<SideTraits<Aggressor>::Opposite>(*restingPrice, filled, LevelData::Action::Match);
+        restingSide.RemoveIfEmpty(*restingPrice);
     }
 
-    if (!bids_.empty())
-    {
-        auto& [_, bids] = *bids_.begin();
-        auto& order = bids.front();
-        if (order->GetOrderType() == OrderType::FillAndKill)
-            CancelOrderInternal(order->GetOrderId());
-    }
+    return quantity - remaining;
+}
 
-    if (!asks_.empty())
-    {
-        auto& [_, asks] = *asks_.begin();
-        auto& order = asks.front();
-        if (order->GetOrderType() == OrderType::FillAndKill)
-            CancelOrderInternal(order->GetOrderId());
-    }
+void Orderbook::RetireOrder(OrderHandle handle)
+{
+    const Order& order = orderPool_[handle];
+    if (const PoolHandle timer = orderPool_.ColdOf(handle).expiryTimer; timer.IsValid())
+        expiryTimers_.Cancel(timer);
+    UnlinkOwner(handle);
+
+    orders_.Erase(order.GetOrderId());
+    orderPool_.Release(handle);
+}
+
+// Resting orders of an owner form a doubly linked list through their
+// OrderDetails, newest first, so MassCancel visits only that owner's orders.
+void Orderbook::LinkOwner(OrderHandle handle)
+{
+    OrderDetails& details = orderPool_.ColdOf(handle);
+    if (details.owner == Constants::NoOwner)
+        return;
+
+    OrderHandle& head = ownerOrders_[details.owner];
+    details.ownerPrev = OrderHandle::Invalid();
+    details.ownerNext = head;
+    if (head.IsValid())
+        orderPool_.ColdOf(head).ownerPrev = handle;
+    head = handle;
+}
+
+void Orderbook::UnlinkOwner(OrderHandle handle)
+{
+    OrderDetails& details = orderPool_.ColdOf(handle);
+    if (details.owner == Constants::NoOwner)
+        return;
+
+    if (details.ownerPrev.IsValid())
+        orderPool_.ColdOf(details.ownerPrev).ownerNext = details.ownerNext;
+    else
+        ownerOrders_[details.owner] = details.ownerNext;
 
-    return trades;
+    if (details.ownerNext.IsValid())
+        orderPool_.ColdOf(details.ownerNext).ownerPrev = details.ownerPrev;
+
+    details.ownerPrev = OrderHandle::Invalid();
+    details.ownerNext = OrderHandle::Invalid();
 }
 
 void Orderbook::Warmup()
 {
-    // Ensure we are running. Wait for thread?
-    // Actually, Warmup() pushes to queue. The consumer thread processes it.
-    // BUT if we call Warmup in constructor, the consumer thread is just starting.
-    // It's fine.
-    
-    // Process some dummy orders to heat up instruction cache
+    // Matching pairs through the normal request path heat up the engine's code
+    // and data; each pair trades out, so the book is left as it was.
+    const size_t target = GetOrdersProcessed() + 20000;
+    eventsMuted_.store(true, std::memory_order_release); // Seen by the engine before the first pair
     for (int i = 0; i < 10000; ++i)
     {
-        // Add Buy
-        auto buy = orderPool_.Acquire();
-        // Ensure price is within bounds for FlatMap!
-        // FlatMap size is 1M (default). Price 1M + i will segfault/bus error if map not resized.
-        // We need to resize FlatMap or use safe prices.
-        // Default FlatMap(1000000) -> indices 0..1000000.
-        // Let's use prices < 1000000.
-        
-        buy->Reset(OrderType::GoodTillCancel, 1000000 + i, Side::Buy, 500000, 10);
-        AddOrder(buy);
-        
-        // Add Sell (Match)
-        auto sell = orderPool_.Acquire();
-        sell->Reset(OrderType::GoodTillCancel, 2000000 + i, Side::Sell, 500000, 10);
-        AddOrder(sell);
+        while (AddOrder(OrderType::GoodTillCancel, 1000000 + i, Side::Buy, 500000, 10) != SubmitResult::Accepted)
+            std::this_thread::yield();
+        while (AddOrder(OrderType::GoodTillCancel, 2000000 + i, Side::Sell, 500000, 10) != SubmitResult::Accepted)
+            std::this_thread::yield();
     }
-    
-    // Wait for drain?
-    // Since we are single threaded consumer, we can't wait here if we are the consumer thread?
-    // No, Warmup is called BEFORE starting the main loop thread or BY the main loop thread.
-    // If called from main(), it pushes to queue.
-    // The processing thread must be running.
-    
-    // Busy wait until processed
-    while (GetOrdersProcessed() < 20000) {
+
+    while (GetOrdersProcessed() < target)
+        std::this_thread::yield();
+
+    // The stats have a single writer, so the engine thread clears them.
+    statsResetRequested_.store(true, std::memory_order_release);
+    waitStrategy_.Notify();
+    while (statsResetRequested_.load(std::memory_order_acquire))
         std::this_thread::yield();
-    }
-    
-    // Reset stats
-    ordersProcessed_.store(0);
-    latencies_.clear();
 }
 
-void Orderbook::AddOrder(OrderPointer order)
+// Engine thread: drops the warmup from the latency, throughput, trade and
+// event stats, and starts trade ids and delta sequences over.
+void Orderbook::ResetStats()
 {
-    // Rate Limit Check (Ingress)
-    /*
-    if (!rateLimiter_.TryAcquire(1))
+    latencyHistogram_.Reset();
+    ordersProcessed_.store(0, std::memory_order_relaxed);
+    lastTradeId_ = 0;
+    tradesExecuted_.store(0, std::memory_order_relaxed);
+    lastDeltaSequence_ = 0;
+    eventStalls_.store(0, std::memory_order_relaxed);
+    eventsDropped_.store(0, std::memory_order_relaxed);
+    eventsMuted_.store(false, std::memory_order_relaxed);
+    statsResetRequested_.store(false, std::memory_order_release);
+}
+
+// Registers the producer on every class under one lock, so its id is the same in each.
+Orderbook::ProducerId Orderbook::RegisterProducer(size_t creditWindow)
+{
+    const size_t window = creditWindow != 0 ? creditWindow : config_.creditWindow;
+
+    std::lock_guard lock(registerMutex_);
+    const ProducerId producer = QueueFor(IngressClass::NewOrders).RegisterProducer(window);
+    if (config_.priorityLanes)
     {
-        // Rejected by Rate Limiter
-        // In real system, send Reject message.
-        // Here we just release order and return.
-        // We need to return or throw? Void return type.
-        // Just drop it.
-        orderPool_.Release(order);
-        return; 
+        QueueFor(IngressClass::Cancels).RegisterProducer(window);
+        QueueFor(IngressClass::Amends).RegisterProducer(window);
     }
-    */
+    return producer;
+}
 
-    Request req;
-    req.type = Request::Type::Add;
-    req.order = order;
-    
-    // Add Timestamp for latency tracking
-    auto now = std::chrono::high_resolution_clock::now();
-    req.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
-    
-    // Backpressure: If queue > 80% full, shed load or spin with warning
-    if (requestQueue_.Size() > requestQueue_.Capacity() * 0.8)
+SubmitResult Orderbook::AddOrder(OrderHandle order)
+{
+    return AddOrder(defaultProducer_, order);
+}
+
+SubmitResult Orderbook::CancelOrder(OrderId orderId)
+{
+    return CancelOrder(defaultProducer_, orderId);
+}
+
+SubmitResult Orderbook::ModifyOrder(OrderModify order)
+{
+    return ModifyOrder(defaultProducer_, order);
+}
+
+SubmitResult Orderbook::AddOrder(ProducerId producer, OrderHandle order)
+{
+    const Order& o = stagingPool_[order];
+    const SubmitResult result = AddOrder(producer, o.GetOrderType(), o.GetOrderId(), o.GetSide(),
+        o.GetPrice(), o.GetRemainingQuantity(), stagingPool_.ColdOf(order).owner);
+
+    // The request carries the fields, so the slot is done with.
+    if (result == SubmitResult::Accepted)
+        stagingPool_.Release(order);
+    return result;
+}
+
+SubmitResult Orderbook::AddOrder(OrderType type, OrderId orderId, Side side, Price price, Quantity quantity, OwnerId owner)
+{
+    return AddOrder(defaultProducer_, type, orderId, side, price, quantity, owner);
+}
+
+SubmitResult Orderbook::AddOrder(ProducerId producer, OrderType type, OrderId orderId, Side side, Price price, Quantity quantity, OwnerId owner)
+{
+    if (owner != Constants::NoOwner && owner >= config_.maxOwners)
+        throw std::out_of_range(std::format("Owner ({}) is outside the configured owner range.", owner));
+
+    return Submit(producer, Request::Type::Add, [&](Request& slot)
     {
-        // For this demo, we'll just busy wait (throttle producer)
-        // In real HFT, we might reject the order immediately
-    }
+        EncodeAdd(slot, type, orderId, side, price, quantity, owner);
+    });
+}
 
-    while (!requestQueue_.Push(req)) { 
-        // Spin if full (backpressure)
-        std::this_thread::yield(); 
-    }
+SubmitResult Orderbook::CancelOrder(ProducerId producer, OrderId orderId)
+{
+    return Submit(producer, Request::Type::Cancel, [&](Request& slot)
+    {
+        slot.orderId = orderId;
+    });
 }
 
-void Orderbook::CancelOrder(OrderId orderId)
+SubmitResult Orderbook::ModifyOrder(ProducerId producer, OrderModify order)
 {
-    Request req;
-    req.type = Request::Type::Cancel;
-    req.orderId = orderId;
-    
-    auto now = std::chrono::high_resolution_clock::now();
-    req.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
-    
-    while (!requestQueue_.Push(req)) { std::this_thread::yield(); }
+    return Submit(producer, Request::Type::Modify, [&](Request& slot)
+    {
+        EncodeModify(slot, order);
+    });
 }
 
-void Orderbook::ModifyOrder(OrderModify order)
+SubmitResult Orderbook::MassCancel(const MassCancelFilter& filter)
 {
-    Request req;
-    req.type = Request::Type::Modify;
-    req.modify = order;
-    
-    auto now = std::chrono::high_resolution_clock::now();
-    req.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+    return MassCancel(defaultProducer_, filter);
+}
 
-    while (!requestQueue_.Push(req)) { std::this_thread::yield(); }
+SubmitResult Orderbook::MassCancel(ProducerId producer, const MassCancelFilter& filter)
+{
+    return Submit(producer, Request::Type::MassCancel, [&](Request& slot)
+    {
+        EncodeMassCancel(slot, filter);
+    });
 }
 
-Trades Orderbook::HandleAddOrder(OrderPointer order)
+SubmitResult Orderbook::CancelOnDisconnect(ProducerId producer, OwnerId owner)
 {
-    if (orders_.contains(order->GetOrderId()))
-        return { };
+    return MassCancel(producer, MassCancelFilter{ .owner = owner });
+}
 
-    if (order->GetOrderType() == OrderType::Market)
+Orderbook::IngressClass Orderbook::IngressClassOf(Request::Type type)
+{
+    switch (type)
     {
-        if (order->GetSide() == Side::Buy && !asks_.empty())
-        {
-            const auto& [worstAsk, _] = *asks_.rbegin();
-            order->ToGoodTillCancel(worstAsk);
-        }
-        else if (order->GetSide() == Side::Sell && !bids_.empty())
-        {
-            const auto& [worstBid, _] = *bids_.rbegin();
-            order->ToGoodTillCancel(worstBid);
-        }
-        else
-            return { };
+    case Request::Type::Cancel:
+    case Request::Type::MassCancel:
+        return IngressClass::Cancels;
+    case Request::Type::Modify:
+        return IngressClass::Amends;
+    default:
+        return IngressClass::NewOrders;
     }
+}
 
-    if (order->GetOrderType() == OrderType::FillAndKill && !CanMatch(order->GetSide(), order->GetPrice()))
-        return { };
-
-    if (order->GetOrderType() == OrderType::FillOrKill && !CanFullyFill(order->GetSide(), order->GetPrice(), order->GetInitialQuantity()))
-        return { };
+// The request is written straight into the ring slot; nothing is built on the
+// producer's stack and copied in.
+template<typename Encode>
+SubmitResult Orderbook::Submit(ProducerId producer, Request::Type type, Encode&& encode)
+{
+    const SubmitResult result = QueueFor(IngressClassOf(type)).TryEmplace(producer, [&](Request& slot)
+    {
+        slot.type = type;
+        encode(slot);
+        // Timestamp for latency tracking (and ordering under TimestampMerged)
+        slot.timestamp = TscClock::NowNs();
+    });
+
+    if (result == SubmitResult::Accepted)
+        waitStrategy_.Notify();
+    return result;
+}
 
-    OrderPointers::iterator iterator;
+Orderbook::IngressStats Orderbook::GetIngressStats(ProducerId producer) const
+{
+    IngressStats total{ };
+    for (const FanInQueue<Request>& queue : requestQueues_)
+    {
+        if (producer >= queue.ProducerCount())
+            continue; // Class unused without priority lanes
+
+        const IngressStats lane = queue.GetLaneStats(producer);
+        total.creditWindow += lane.creditWindow;
+        total.accepted += lane.accepted;
+        total.queueFull += lane.queueFull;
+        total.throttled += lane.throttled;
+        total.highWaterMark = std::max(total.highWaterMark, lane.highWaterMark);
+    }
+    return total;
+}
 
-    if (order->GetSide() == Side::Buy)
+Orderbook::IngressStats Orderbook::GetIngressStats() const
+{
+    IngressStats total{ };
+    for (ProducerId producer = 0; producer < QueueFor(IngressClass::NewOrders).ProducerCount(); ++producer)
     {
-        auto& orders = bids_[order->GetPrice()];
-        orders.push_back(order);
-        iterator = std::prev(orders.end());
-        
-        /*
-        if (orders.size() == 1) // New Level
-            bidMap_.AddPrice(order->GetPrice());
-*/
+        const IngressStats lanes = GetIngressStats(producer);
+        total.creditWindow += lanes.creditWindow;
+        total.accepted += lanes.accepted;
+        total.queueFull += lanes.queueFull;
+        total.throttled += lanes.throttled;
+        total.highWaterMark = std::max(total.highWaterMark, lanes.highWaterMark);
     }
+    return total;
+}
+
+void Orderbook::HandleAddOrder(const NewOrder& order)
+{
+    if (order.side == Side::Buy)
+        HandleAddOrder<Side::Buy>(order);
     else
+        HandleAddOrder<Side::Sell>(order);
+}
+
+template<Side S>
+void Orderbook::HandleAddOrder(const NewOrder& order)
+{
+    if (orders_.Contains(order.orderId))
+        return;
+
+    OrderType type = order.type;
+    Price price = order.price;
+    if (type == OrderType::Market)
     {
-        auto& orders = asks_[order->GetPrice()];
-        orders.push_back(order);
-        iterator = std::prev(orders.end());
-        
-/*
-        if (orders.size() == 1) // New Level
-            askMap_.AddPrice(order->GetPrice());
-*/
+        const auto worstPrice = SideOf<SideTraits<S>::Opposite>().Worst();
+        if (!worstPrice)
+            return;
+
+        type = OrderType::GoodTillCancel;
+        price = *worstPrice;
     }
 
-    orders_.insert({ order->GetOrderId(), OrderEntry{ order, iterator } });
-    
-    OnOrderAdded(order);
-    
-    return MatchOrders();
+    if (!SideOf<S>().InRange(price))
+        return;
+
+    if (type == OrderType::FillAndKill && !CanMatch<S>(price))
+        return;
+
+    if (type == OrderType::FillOrKill && !CanFullyFill<S>(price, order.quantity))
+        return;
+
+    const Quantity filled = MatchOrders<S>(order.orderId, price, order.quantity);
+    if (filled == order.quantity || type == OrderType::FillAndKill)
+        return;
+
+    // Only an order that rests takes a slot, and only while the book has room.
+    if (orders_.Size() >= config_.maxLiveOrders)
+    {
+        ordersOverCapacity_.store(ordersOverCapacity_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return;
+    }
+
+    const OrderHandle handle = AllocateOrder(type, order.orderId, S, price, order.quantity, order.owner);
+    orderPool_[handle].Fill(filled);
+
+    SideOf<S>().Push(orderPool_, handle, price);
+    orders_.Insert(order.orderId, handle);
+    LinkOwner(handle);
+
+    // Cancelled by RetireOrder if the order fills later.
+    if (type == OrderType::GoodForDay)
+        orderPool_.ColdOf(handle).expiryTimer = expiryTimers_.Schedule(NextSessionClose(), handle);
+
+    UpdateLevelData<S>(price, order.quantity - filled, LevelData::Action::Add);
 }
 
-void Orderbook::HandleCancelOrder(OrderId orderId)
+bool Orderbook::HandleCancelOrder(OrderId orderId)
 {
-    CancelOrderInternal(orderId);
+    return CancelOrderInternal(orderId);
 }
 
-Trades Orderbook::HandleModifyOrder(OrderModify order)
+bool Orderbook::HandleModifyOrder(OrderModify order)
 {
-    OrderType orderType;
+    const OrderHandle* existing = orders_.Find(order.GetOrderId());
+    if (!existing)
+        return false;
+
+    Order& resting = orderPool_[*existing];
 
-    if (!orders_.contains(order.GetOrderId()))
-        return { };
+    // Same side and price, quantity down: amend in place and keep priority.
+    // Anything else loses its place (cancel/replace).
+    if (resting.GetSide() == order.GetSide() && resting.GetPrice() == order.GetPrice()
+        && order.GetQuantity() > 0 && order.GetQuantity() <= resting.GetRemainingQuantity())
+    {
+        if (resting.GetSide() == Side::Buy)
+            AmendOrder<Side::Buy>(*existing, order.GetQuantity());
+        else
+            AmendOrder<Side::Sell>(*existing, order.GetQuantity());
+        return true;
+    }
 
-    const auto& [existingOrder, _] = orders_.at(order.GetOrderId());
-    orderType = existingOrder->GetOrderType();
+    const OrderType orderType = resting.GetOrderType();
+    const OwnerId owner = orderPool_.ColdOf(*existing).owner;
 
     CancelOrderInternal(order.GetOrderId());
-    
-    // Use pool to get new order
-    auto newOrder = AcquireOrder(orderType, order.GetOrderId(), order.GetSide(), order.GetPrice(), order.GetQuantity());
-    return HandleAddOrder(newOrder);
+    HandleAddOrder(NewOrder{ orderType, order.GetOrderId(), order.GetSide(), order.GetPrice(), order.GetQuantity(), owner });
+    return true;
+}
+
+template<Side S>
+void Orderbook::AmendOrder(OrderHandle handle, Quantity quantity)
+{
+    Order& resting = orderPool_[handle];
+    const Quantity reduction = resting.GetRemainingQuantity() - quantity;
+    orderPool_.ColdOf(handle).initialQuantity -= reduction;
+    resting.ReduceQuantity(quantity);
+    SideOf<S>().Level(resting.GetPrice()).SyncQuantity(orderPool_, handle);
+    UpdateLevelData<S>(resting.GetPrice(), reduction, LevelData::Action::Reduce);
+}
+
+void Orderbook::HandleMassCancel(const MassCancelFilter& filter)
+{
+    if (filter.owner == Constants::NoOwner || filter.owner >= ownerOrders_.size())
+        return;
+
+    for (OrderHandle handle = ownerOrders_[filter.owner]; handle.IsValid();)
+    {
+        const OrderHandle next = orderPool_.ColdOf(handle).ownerNext; // The cancel unlinks `handle`
+        const Order& order = orderPool_[handle];
+
+        if (filter.Covers(order.GetSide(), order.GetPrice()))
+            CancelOrderInternal(order.GetOrderId());
+
+        handle = next;
+    }
 }
 
 std::size_t Orderbook::Size() const
 {
-    return orders_.size(); 
+    return orders_.Size(); 
 }
 
 OrderbookLevelInfos Orderbook::GetOrderInfos() const
 {
     LevelInfos bidInfos, askInfos;
-    bidInfos.reserve(orders_.size());
-    askInfos.reserve(orders_.size());
+    bidInfos.reserve(bids_.LevelCount());
+    askInfos.reserve(asks_.LevelCount());
 
-    auto CreateLevelInfos = [](Price price, const OrderPointers& orders)
+    // O(levels): aggregates are kept per tick, no walk over the orders.
+    bids_.ForEachLevel(SIZE_MAX, [&](Price price, const OrderQueue&, uint64_t quantity)
     {
-        return LevelInfo{ price, std::accumulate(orders.begin(), orders.end(), (Quantity)0,
-            [](Quantity runningSum, const OrderPointer& order)
-            { return runningSum + order->GetRemainingQuantity(); }) };
-    };
-
-    for (const auto& [price, orders] : bids_)
-        bidInfos.push_back(CreateLevelInfos(price, orders));
-
-    for (const auto& [price, orders] : asks_)
-        askInfos.push_back(CreateLevelInfos(price, orders));
+        bidInfos.push_back(LevelInfo{ price, static_cast<Quantity>(quantity) });
+    });
+    asks_.ForEachLevel(SIZE_MAX, [&](Price price, const OrderQueue&, uint64_t quantity)
+    {
+        askInfos.push_back(LevelInfo{ price, static_cast<Quantity>(quantity) });
+    });
 
     return OrderbookLevelInfos{ bidInfos, askInfos };
 }
 
-OrderPointer Orderbook::AcquireOrder(OrderType type, OrderId orderId, Side side, Price price, Quantity quantity)
+OrderHandle Orderbook::AcquireOrder(OrderType type, OrderId orderId, Side side, Price price, Quantity quantity, OwnerId owner)
 {
-    auto order = orderPool_.Acquire();
-    order->Reset(type, orderId, side, price, quantity);
+    if (owner >= ownerOrders_.size())
+        throw std::out_of_range(std::format("Owner ({}) is outside the configured owner range.", owner));
+
+    const OrderHandle order = stagingPool_.Acquire();
+    stagingPool_[order].Reset(type, orderId, side, price, quantity);
+    stagingPool_.ColdOf(order) = OrderDetails{ .initialQuantity = quantity, .owner = owner };
     return order;
 }
 
-Orderbook::LatencyStats Orderbook::GetLatencyStats()
+// Engine thread: a slot in the book's own slab for an order that rests.
+OrderHandle Orderbook::AllocateOrder(OrderType type, OrderId orderId, Side side, Price price, Quantity quantity, OwnerId owner)
 {
-    if (latencies_.empty())
-        return { 0, 0, 0, 0 };
+    const OrderHandle order = orderPool_.Acquire();
+    orderPool_[order].Reset(type, orderId, side, price, quantity);
+    orderPool_.ColdOf(order) = OrderDetails{ .initialQuantity = quantity, .owner = owner };
+    return order;
+}
 
-    std::sort(latencies_.begin(), latencies_.end());
-    
-    size_t p50_idx = latencies_.size() * 0.50;
-    size_t p99_idx = latencies_.size() * 0.99;
-    size_t p999_idx = latencies_.size() * 0.999;
-    
-    // Clamp
-    if (p99_idx >= latencies_.size()) p99_idx = latencies_.size() - 1;
-    if (p999_idx >= latencies_.size()) p999_idx = latencies_.size() - 1;
-    
+Orderbook::LatencyStats Orderbook::GetLatencyStats() const
+{
     return {
-        latencies_[p50_idx],
-        latencies_[p99_idx],
-        latencies_[p999_idx],
-        latencies_.back()
+        latencyHistogram_.ValueAtPercentile(50.0),
+        latencyHistogram_.ValueAtPercentile(99.0),
+        latencyHistogram_.ValueAtPercentile(99.9),
+        latencyHistogram_.ValueAtPercentile(99.99),
+        latencyHistogram_.Max()
     };
 }
@@ -1,142 +1,465 @@
 #pragma once
 
-#include <map>
-#include <unordered_map>
 #include <thread>
 #include <condition_variable>
 #include <mutex>
 #include <variant>
 #include <atomic>
+#include <chrono>
+#include <array>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
 
 #include "Usings.h"
 #include "Order.h"
+#include "OrderQueue.h"
+#include "BookSide.h"
 #include "OrderModify.h"
 #include "OrderbookLevelInfos.h"
 #include "Trade.h"
+#include "EngineEvents.h"
+#include "BroadcastRing.h"
+#include "DepthSnapshot.h"
+#include "HdrHistogram.h"
+#include "TscClock.h"
 #include "LockFreeQueue.h"
+#include "FanInQueue.h"
+#include "SubmitResult.h"
+#include "WaitStrategy.h"
 #include "ObjectPool.h"
 #include "RiskManager.h"
 #include "SimdPriceMatcher.h"
 #include "FlatPriceMap.h"
+#include "FlatOrderMap.h"
+#include "FenwickTree.h"
+#include "TimerWheel.h"
 #include "Journaler.h"
 #include "RateLimiter.h"
 #include "MetricsPublisher.h"
 #include <vector>
 #include <algorithm>
 
+class SharedMemoryMetrics;
+
 class Orderbook
 {
 public:
-    struct alignas(64) Request
+    // Which of one owner's resting orders a MassCancel removes. The defaults
+    // take all of them.
+    struct MassCancelFilter
+    {
+        OwnerId owner{ Constants::NoOwner };
+        Price minPrice{ std::numeric_limits<Price>::min() };
+        Price maxPrice{ std::numeric_limits<Price>::max() };
+        bool buys{ true };
+        bool sells{ true };
+
+        bool Covers(Side side, Price price) const
+        {
+            return (side == Side::Buy ? buys : sells) && price >= minPrice && price <= maxPrice;
+        }
+    };
+
+    // Ingress lanes of a producer under Config::priorityLanes, in drain order.
+    enum class IngressClass { Cancels, Amends, NewOrders };
+    static constexpr size_t IngressClassCount = 3;
+
+    // Requests each class may take per drain round.
+    struct DrainWeights
+    {
+        size_t cancels = 4;     // Cancel and MassCancel
+        size_t amends = 2;      // Modify
+        size_t newOrders = 1;   // Add
+    };
+
+    // One ingress ring slot: 32 bytes, trivially copyable, two per cache line.
+    // Producers fill it in place in the ring; `type` selects the live payload.
+    // An add carries the order's fields inline, and the engine takes a slab
+    // slot for it only if it rests.
+    struct alignas(32) Request
     {
-        enum class Type { Add, Cancel, Modify };
+        enum class Type : uint8_t { Add, Cancel, Modify, MassCancel };
+
+        struct OrderFields          // Add; Modify leaves owner unset
+        {
+            Price price;
+            Quantity quantity;
+            OwnerId owner;
+        };
+
+        struct MassCancelFields
+        {
+            OwnerId owner;
+            Price minPrice;
+            Price maxPrice;
+        };
+
+        uint64_t timestamp;         // TscClock::NowNs() at submission, for latency and merge order
+        OrderId orderId;            // Add, Cancel, Modify
+        union
+        {
+            OrderFields order;
+            MassCancelFields massCancel;
+        };
         Type type;
-        OrderPointer order{ nullptr };
-        OrderId orderId{ 0 };
-        OrderModify modify{ 0, Side::Buy, 0, 0 };
-        uint64_t timestamp{ 0 }; // For latency tracking
+        uint8_t side;               // Side: Add, Modify
+        uint8_t orderType;          // OrderType: Add
+        uint8_t massCancelSides;    // Bit 0 bids, bit 1 asks
+
+        Side GetSide() const { return static_cast<Side>(side); }
+        OrderType GetOrderType() const { return static_cast<OrderType>(orderType); }
+        OrderModify GetModify() const { return { orderId, GetSide(), order.price, order.quantity }; }
+        MassCancelFilter GetMassCancel() const
+        {
+            return { massCancel.owner, massCancel.minPrice, massCancel.maxPrice,
+                (massCancelSides & 1) != 0, (massCancelSides & 2) != 0 };
+        }
     };
+    static_assert(sizeof(Request) == 32 && std::is_trivially_copyable_v<Request>, "Request is one half cache line");
 
-private:
-    struct OrderEntry
+    using ProducerId = FanInQueue<Request>::ProducerId;
+
+    struct Config
     {
-        OrderPointer order_{ nullptr };
-        OrderPointers::iterator location_;
+        size_t requestQueueSize = 65536; // Per producer lane, rounded up to a power of two
+        size_t creditWindow = 0;         // Default per-producer credit window; 0 = the whole lane
+        size_t maxProducers = 8;
+        FanInPolicy fanInPolicy = FanInPolicy::RoundRobin;
+        size_t orderPoolSize = 100000;   // Order slots allocated up front; the slab grows by chunks after that
+
+        // Most orders that can rest at once. The order index is sized for it
+        // at startup and never rehashes; the remainder of an add that would
+        // rest beyond it is dropped and counted (GetOrdersOverCapacity()).
+        size_t maxLiveOrders = 1'000'000;
+
+        // Price-level queue entries (12 bytes each) reserved per side at
+        // startup. Levels take their arrays from it, and a level that doubles
+        // returns its old block, so only a book that outgrows it allocates
+        // (by 64K-entry chunks) on the engine thread.
+        size_t levelSlots = 262'144;
+
+        // Engine loop: requests drained per queue acquire (1 = one at a time),
+        // and how many requests ahead to prefetch (0 = off).
+        size_t batchSize = 32;
+        size_t prefetchDistance = 4;
+
+        // What the engine thread does when every lane is empty. A Blocking
+        // engine parks until a request arrives or the next expiry is due.
+        WaitStrategy::Config wait{ };
+
+        // GoodForDay orders expire at this local time of day. Expiries are run
+        // from the engine loop, at most expiryBatch per iteration, so a mass
+        // expiry at the close is interleaved with matching.
+        std::chrono::seconds sessionClose{ std::chrono::hours(16) };
+        uint64_t timerTickNs = 1'000'000;
+        size_t expiryBatch = 256;
+
+        // Output event ring (trades and L2 deltas, see GetEvents()) and how
+        // many consumers may attach to it. The slowest attached consumer
+        // holds the engine back once it is a full ring behind.
+        size_t eventRingCapacity = 65536;
+        size_t maxEventConsumers = 8;
+
+        // Levels per side in the published depth snapshot (see GetDepthSnapshot()).
+        size_t snapshotDepth = 10;
+
+        // Owner ids run 1 .. maxOwners - 1 (0 = no owner).
+        size_t maxOwners = 4096;
+
+        // With priorityLanes each producer gets one lane per IngressClass, and
+        // the engine fills a batch in rounds: up to drainWeights.cancels
+        // cancels, then amends, then new orders, and again (a class with
+        // nothing queued gives up its turn). A cancel therefore overtakes a
+        // backlog of new orders. If it overtakes its own order's add (same
+        // producer, submitted earlier), it is held and applied right after
+        // that add, as in FIFO order; amends and mass cancels likewise.
+        // Off, all of a producer's requests share one FIFO lane. Weights must
+        // be non-zero.
+        bool priorityLanes = false;
+        DrainWeights drainWeights{ };
+
+        // Every request that reaches the book is appended here in processed
+        // order (AsyncJournaler format; expiries as cancels), so replaying the
+        // file through a book with priorityLanes off rebuilds this book.
+        // Empty = no journal.
+        std::string journalPath;
+
+        // Shared-memory segment (SharedMemoryMetrics) that gets the event
+        // ring's published count, stalls and each consumer's lag and max lag
+        // once per batch. POSIX only. Empty = not exported.
+        std::string metricsShmName;
     };
 
+private:
     struct LevelData
     {
-        Quantity quantity_{ };
-        Quantity count_{ };
-
         enum class Action
         {
             Add,
             Remove,
             Match,
+            Reduce,
         };
     };
 
-    std::unordered_map<Price, LevelData> data_;
-    std::map<Price, OrderPointers, std::greater<Price>> bids_;
-    std::map<Price, OrderPointers, std::less<Price>> asks_;
-    
-    // SIMD Matchers (Shadowing the maps for fast scan)
-    // SimdPriceMatcher bidMatcher_;
-    // SimdPriceMatcher askMatcher_;
-    
-    // FlatPriceMap bidMap_;
-    // FlatPriceMap askMap_;
-    
-    std::unordered_map<OrderId, OrderEntry> orders_;
+    // One FIFO per tick, indexed by price, plus occupancy bitmaps (best price
+    // and the next level without a tree walk) and resting quantity per tick
+    // (Fenwick tree for FOK/depth queries, plain array for L2). Side-specific
+    // code is instantiated per side and entered once per request.
+    BookSide<Side::Buy> bids_;
+    BookSide<Side::Sell> asks_;
+
+    template<Side S>
+    BookSide<S>& SideOf()
+    {
+        if constexpr (S == Side::Buy) return bids_;
+        else return asks_;
+    }
+
+    template<Side S>
+    const BookSide<S>& SideOf() const
+    {
+        if constexpr (S == Side::Buy) return bids_;
+        else return asks_;
+    }
+
+    // Levels touched since the last publish, one entry each (bit per side+tick).
+    // PublishBookDeltas() turns them into one LevelDelta per level per batch.
+    std::vector<uint32_t> touchedLevels_;
+    std::vector<uint64_t> touchedBits_;
+    uint64_t lastDeltaSequence_{ 0 };
+
+    // Trades (written during matching) and L2 deltas (after each batch), in
+    // the order the engine produced them; see GetEvents(). Built before the
+    // engine thread starts.
+    BroadcastRing<EngineEvent> events_;
+    DepthSnapshot depthSnapshot_; // Republished with the deltas, after each batch that moved the book
     
     // Concurrency & Event Loop
-    LockFreeQueue<Request> requestQueue_;
-    ObjectPool<Order> orderPool_;
+    Config config_;
+    std::vector<const Request*> batch_; // Requests of the current batch, read in place in their lanes; sized once to config_.batchSize
+    std::vector<ProducerId> batchProducers_; // Producer of each batch_ entry
+
+    // Priority lanes: a cancel, amend or mass cancel that may have overtaken
+    // an add its producer queued earlier, kept (oldest first) until that
+    // producer's new-order lane has been drained past it.
+    struct HeldRequest
+    {
+        Request request;
+        ProducerId producer;
+    };
+    std::vector<HeldRequest> heldRequests_; // Engine thread only
+
+    // One fan-in per IngressClass; with priorityLanes off only NewOrders has
+    // lanes and it carries every request. A producer has the same id in each.
+    std::array<FanInQueue<Request>, IngressClassCount> requestQueues_;
+    std::mutex registerMutex_;
+    const std::array<size_t, IngressClassCount> drainWeights_;
+    std::array<size_t, IngressClassCount> drainBudget_; // Left in the current round; engine thread only
+    ProducerId defaultProducer_;
+    WaitStrategy waitStrategy_;
+    OrderPool orderPool_;           // Resting orders; engine thread only, so it takes no lock
+    SharedOrderPool stagingPool_;   // Orders gateways pre-acquire (AcquireOrder) before submitting them
+    FlatOrderMap<OrderHandle> orders_; // Sized for Config::maxLiveOrders
+    TimerWheel<OrderHandle> expiryTimers_; // Wall-clock deadlines, reserved for maxLiveOrders; engine thread only
+    std::vector<OrderHandle> ownerOrders_; // Head of each owner's resting-order list; engine thread only
+
+    std::unique_ptr<AsyncJournaler> journaler_; // Config::journalPath; written by the engine thread
+    std::unique_ptr<SharedMemoryMetrics> metrics_; // Config::metricsShmName; written by the engine thread
+
+    uint64_t sessionCloseNs_{ 0 };
+    std::atomic<bool> shutdown_{ false }; // Before the thread: it is read as soon as the thread starts
     std::thread processingThread_;
-    std::atomic<bool> shutdown_{ false };
     
     RiskManager riskManager_;
-    // AsyncJournaler journaler_{"events.log"};
+
+    uint64_t lastTradeId_{ 0 };
+    std::atomic<uint64_t> tradesExecuted_{ 0 };  // lastTradeId_ as of the last batch
+    std::atomic<uint64_t> eventStalls_{ 0 };     // Events that waited for the slowest consumer
+    std::atomic<uint64_t> eventsDropped_{ 0 };   // Events lost at shutdown to a consumer that stopped reading
+
+    template<typename Fill>
+    void PublishEvent(Fill&& fill);
     // RateLimiter rateLimiter_{2000000, 100000}; // 2M MPS, 100k burst
-    // MetricsPublisher metrics_;
-    
-    // Latency Stats (using simple vector for histogram/percentiles)
-    // In production, use HdrHistogram
-    std::vector<uint64_t> latencies_;
     
-    // Pruning (Keep on separate thread or integrate? For simplicity, integrate into loop or keep separate but careful)
-    // Actually, Pruning GFD orders is time-based. In an event loop, we can check time every N iterations.
-    // For now, let's keep the logic simple and remove the separate pruning thread to avoid locking issues.
+    // Ingress-to-done latency (ns). Fixed size; written by the engine thread
+    // only and readable from any thread while it runs.
+    HdrHistogram<> latencyHistogram_;
+    std::atomic<bool> statsResetRequested_{ false }; // Set by Warmup(), cleared by the engine
+    std::atomic<bool> eventsMuted_{ false };         // Likewise: Warmup()'s events stay out of the ring
     
     void ProcessRequests();
+    void ResetStats();
+    size_t DrainRequests();
+    bool IngressEmpty() const;
+    FanInQueue<Request>& QueueFor(IngressClass ingress);
+    const FanInQueue<Request>& QueueFor(IngressClass ingress) const;
+    static std::array<size_t, IngressClassCount> DrainWeightsOf(const Config& config);
+    static IngressClass IngressClassOf(Request::Type type);
+    template<typename Encode> SubmitResult Submit(ProducerId producer, Request::Type type, Encode&& encode);
+    void ProcessRequest(const Request& req, ProducerId producer);
+    void HoldRequest(const Request& req, ProducerId producer);
+    void ApplyHeldRequests(const Request& add, ProducerId producer);
+    void DropPassedHeldRequests();
+    void Journal(const Request& req);
+    void PrefetchRequest(const Request& req) const;
+    void PrefetchLevel(const Request& req) const;
     
-    void PruneGoodForDayOrders(); // Now called from main loop
+    bool ExpireOrders();
+    std::chrono::nanoseconds NextExpiryWait() const;
+    uint64_t NextSessionClose();
     void CancelOrders(OrderIds orderIds);
-    void CancelOrderInternal(OrderId orderId);
+    bool CancelOrderInternal(OrderId orderId);
+    template<Side S> void RemoveOrder(OrderHandle handle);
+    void RetireOrder(OrderHandle handle);
+    OrderHandle AllocateOrder(OrderType type, OrderId orderId, Side side, Price price, Quantity quantity, OwnerId owner);
+    void LinkOwner(OrderHandle handle);
+    void UnlinkOwner(OrderHandle handle);
+
+    template<Side S> void UpdateLevelData(Price price, Quantity quantity, LevelData::Action action);
+    void PublishBookDeltas();
+    void PublishDepthSnapshot();
+    void PublishEventMetrics();
 
-    void OnOrderCancelled(OrderPointer order);
-    void OnOrderAdded(OrderPointer order);
-    void OnOrderMatched(Price price, Quantity quantity, bool isFullyFilled);
-    void UpdateLevelData(Price price, Quantity quantity, LevelData::Action action);
+    template<Side S> bool CanFullyFill(Price price, Quantity quantity) const;
+    template<Side S> bool CanMatch(Price price) const;
+    template<Side S> Quantity MatchOrders(OrderId orderId, Price price, Quantity quantity);
 
-    bool CanFullyFill(Side side, Price price, Quantity quantity) const;
-    bool CanMatch(Side side, Price price) const;
-    Trades MatchOrders();
+    // An order as it arrives: from an add request or the replace leg of an amend.
+    struct NewOrder
+    {
+        OrderType type;
+        OrderId orderId;
+        Side side;
+        Price price;
+        Quantity quantity;
+        OwnerId owner;
+    };
 
-    // Internal handlers for requests
-    Trades HandleAddOrder(OrderPointer order);
-    void HandleCancelOrder(OrderId orderId);
-    Trades HandleModifyOrder(OrderModify order);
+    // Internal handlers for requests. The untemplated ones pick the side.
+    void HandleAddOrder(const NewOrder& order);
+    template<Side S> void HandleAddOrder(const NewOrder& order);
+    bool HandleCancelOrder(OrderId orderId);
+    bool HandleModifyOrder(OrderModify order);
+    template<Side S> void AmendOrder(OrderHandle handle, Quantity quantity);
+    void HandleMassCancel(const MassCancelFilter& filter);
 
 public:
+    // Highest price (in ticks) the book can rest; orders above it are rejected.
+    static constexpr Price MaxPrice = 1000000;
 
-    Orderbook();
+    Orderbook() : Orderbook(Config{}) {}
+    explicit Orderbook(const Config& config);
     Orderbook(const Orderbook&) = delete;
     void operator=(const Orderbook&) = delete;
     Orderbook(Orderbook&&) = delete;
     void operator=(Orderbook&&) = delete;
     ~Orderbook();
 
-    // These now push to queue
-    void AddOrder(OrderPointer order);
-    void CancelOrder(OrderId orderId);
-    void ModifyOrder(OrderModify order);
+    // Each producer thread registers once and submits on its own lane, so any
+    // number of gateways can feed the engine concurrently. The overloads without
+    // a ProducerId use a built-in lane that only one thread may use at a time.
+    //
+    // Submission never blocks. A producer may have up to its credit window of
+    // requests queued (creditWindow, 0 = Config::creditWindow); past that the
+    // request is rejected on the spot with SubmitResult::Throttled, or
+    // QueueFull if the window is the whole lane. A rejected AddOrder leaves the
+    // handle with the caller: resubmit it or hand it back with ReleaseOrder().
+    ProducerId RegisterProducer(size_t creditWindow = 0);
+
+    // The order's fields travel inline in the request; nothing is allocated
+    // until the engine rests what is left of it. Throws std::out_of_range if
+    // owner >= Config::maxOwners.
+    SubmitResult AddOrder(OrderType type, OrderId orderId, Side side, Price price, Quantity quantity,
+        OwnerId owner = Constants::NoOwner);
+    SubmitResult AddOrder(ProducerId producer, OrderType type, OrderId orderId, Side side, Price price,
+        Quantity quantity, OwnerId owner = Constants::NoOwner);
+
+    // Pre-acquired order (see AcquireOrder): its fields are copied into the
+    // request and the slot is released once the request is accepted.
+    SubmitResult AddOrder(OrderHandle order);
+    SubmitResult AddOrder(ProducerId producer, OrderHandle order);
+
+    SubmitResult CancelOrder(OrderId orderId);
+    SubmitResult ModifyOrder(OrderModify order);
+    SubmitResult CancelOrder(ProducerId producer, OrderId orderId);
+    SubmitResult ModifyOrder(ProducerId producer, OrderModify order);
+
+    // Kill switch: cancels an owner's resting orders, optionally one side and
+    // a price band, in one request. Runs in time proportional to that owner's
+    // orders and the book changes go out in the batch's L2 deltas.
+    SubmitResult MassCancel(const MassCancelFilter& filter);
+    SubmitResult MassCancel(ProducerId producer, const MassCancelFilter& filter);
 
-    // Getters need to be careful now as they read from a moving target. 
-    // In a real lock-free engine, we'd use a snapshot mechanism. 
-    // For this exercise, we will assume Size() and GetOrderInfos() are for debugging 
-    // and might be slightly inconsistent, or we can add a "Request" to get them (Async).
-    // To keep signature, we'll leave them as is but warn they are not thread-safe vs the writer.
+    // Gateway session lost: MassCancel of all the owner's orders on the
+    // gateway's own lane, so it lands after everything the session sent.
+    SubmitResult CancelOnDisconnect(ProducerId producer, OwnerId owner);
+
+    // Requests of a class `producer` can submit right now without a reject.
+    // Each class has its own credits, so a producer throttled on new orders can
+    // still cancel. Producer thread only.
+    size_t GetCredits(ProducerId producer, IngressClass ingress = IngressClass::NewOrders) { return QueueFor(ingress).Credits(producer); }
+    size_t GetCredits() { return GetCredits(defaultProducer_); }
+
+    // Accepted / rejected counts and queue-depth high-water mark for one lane,
+    // or summed over a producer's lanes or all lanes (high-water mark: the
+    // deepest lane). Any thread.
+    using IngressStats = FanInQueue<Request>::LaneStats;
+    IngressStats GetIngressStats(ProducerId producer, IngressClass ingress) const { return QueueFor(ingress).GetLaneStats(producer); }
+    IngressStats GetIngressStats(ProducerId producer) const;
+    IngressStats GetIngressStats() const;
+
+    // Size() and GetOrderInfos() read the live book and race with the engine
+    // thread: use them for debugging or once the engine is idle. Other threads
+    // read a consistent top of book from GetDepthSnapshot().
     std::size_t Size() const;
     OrderbookLevelInfos GetOrderInfos() const;
+
+    // Best Config::snapshotDepth levels per side as of the last batch. Lock-free
+    // and safe from any thread: GetDepthSnapshot().Read(view).
+    const DepthSnapshot& GetDepthSnapshot() const { return depthSnapshot_; }
+
+    // Resting quantity a taker on `side` could reach with limit `price`
+    // (asks <= price for a buy, bids >= price for a sell). O(log n).
+    uint64_t GetDepthAtOrBetter(Side side, Price price) const;
     
-    // Helper to get from pool
-    OrderPointer AcquireOrder(OrderType type, OrderId orderId, Side side, Price price, Quantity quantity);
+    // Builds an order in a staging slab any producer thread may use; the
+    // engine's own slab is never touched off the engine thread. The handle
+    // belongs to the book once an AddOrder of it is accepted. Orders with an
+    // owner can be reached by MassCancel; throws std::out_of_range if
+    // owner >= Config::maxOwners.
+    OrderHandle AcquireOrder(OrderType type, OrderId orderId, Side side, Price price, Quantity quantity,
+        OwnerId owner = Constants::NoOwner);
+
+    // Returns an order that was acquired but never accepted (e.g. its AddOrder was rejected).
+    void ReleaseOrder(OrderHandle order) { stagingPool_.Release(order); }
+
+    // Output stream: every execution, and after each batch the new aggregate
+    // of every level it touched (incremental L2). Each downstream thread
+    // attaches with AddConsumer() before the events it needs and reads them in
+    // place with its own id; see BroadcastRing. An L2 subscriber seeds from
+    // GetOrderInfos() once attached. A consumer that stops reading must
+    // RemoveConsumer(), or the engine stalls when the ring fills (and, at
+    // shutdown, drops what no longer fits: GetEventsDropped()).
+    BroadcastRing<EngineEvent>& GetEvents() { return events_; }
+    uint64_t GetEventStalls() const { return eventStalls_.load(std::memory_order_relaxed); }
+    uint64_t GetEventsDropped() const { return eventsDropped_.load(std::memory_order_relaxed); }
+    uint64_t GetTradesExecuted() const { return tradesExecuted_.load(std::memory_order_relaxed); }
+
+    // Engine thread idle time, parks and wakeup latency.
+    WaitStrategy::Stats GetWaitStats() const { return waitStrategy_.GetStats(); }
 
     std::size_t GetOrdersProcessed() const { return ordersProcessed_.load(std::memory_order_relaxed); }
+    std::size_t GetOrdersExpired() const { return ordersExpired_.load(std::memory_order_relaxed); }
+    std::size_t GetOrdersOverCapacity() const { return ordersOverCapacity_.load(std::memory_order_relaxed); }
     
-    // Warmup
+    // Runs matching pairs through the engine, then has the engine thread
+    // reset the latency histogram, processed and trade counts and event
+    // counters. The pairs' trades and deltas never reach the event ring, and
+    // trade ids and delta sequences start over, so call it before trading
+    // starts. Blocks until done.
     void Warmup();
     
     struct LatencyStats
@@ -144,11 +467,15 @@ public:
         uint64_t p50;
         uint64_t p99;
         uint64_t p999;
+        uint64_t p9999;
         uint64_t max;
     };
     
-    LatencyStats GetLatencyStats(); // Not thread safe, call after shutdown or carefully
+    // Safe to call while the engine is running (values are accurate to ~1.6%).
+    LatencyStats GetLatencyStats() const;
 
 private:
     std::atomic<std::size_t> ordersProcessed_{ 0 };
+    std::atomic<std::size_t> ordersExpired_{ 0 };
+    std::atomic<std::size_t> ordersOverCapacity_{ 0 }; // Adds that found the book at maxLiveOrders
 };
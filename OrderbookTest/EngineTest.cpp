@@ -0,0 +1,469 @@
+#include "pch.h"
+
+#include "../Orderbook.h"
+#if !defined(_WIN32)
+#include "../SharedMemoryMetrics.h"
+#endif
+
+#include <ctime>
+#include <random>
+
+namespace
+{
+    void WaitForProcessed(const Orderbook& orderbook, size_t count)
+    {
+        while (orderbook.GetOrdersProcessed() < count)
+            std::this_thread::yield();
+    }
+
+    size_t RestingAt(const Orderbook& orderbook, Side side, Price price)
+    {
+        const auto infos = orderbook.GetOrderInfos();
+        for (const auto& level : side == Side::Buy ? infos.GetBids() : infos.GetAsks())
+            if (level.price_ == price)
+                return level.quantity_;
+        return 0;
+    }
+
+    // Local time of day `ahead` from now, as a Config::sessionClose.
+    std::chrono::seconds TimeOfDayIn(std::chrono::seconds ahead)
+    {
+        const std::time_t now = std::time(nullptr);
+        std::tm local{ };
+#if defined(_WIN32)
+        localtime_s(&local, &now);
+#else
+        localtime_r(&now, &local);
+#endif
+        const auto timeOfDay = std::chrono::hours(local.tm_hour) + std::chrono::minutes(local.tm_min) + std::chrono::seconds(local.tm_sec);
+        return (timeOfDay + ahead) % std::chrono::hours(24);
+    }
+}
+
+TEST(EngineTest, AddsBeyondMaxLiveOrdersAreDroppedAndCounted)
+{
+    Orderbook::Config config;
+    config.orderPoolSize = 16;
+    config.maxLiveOrders = 100;
+    Orderbook orderbook(config);
+
+    for (OrderId id = 1; id <= 150; ++id)
+        ASSERT_EQ(orderbook.AddOrder(OrderType::GoodTillCancel, id, Side::Buy, 100, 1), SubmitResult::Accepted);
+
+    // A crossing sell still trades against the full book; only resting is refused.
+    ASSERT_EQ(orderbook.AddOrder(OrderType::GoodTillCancel, 1000, Side::Sell, 100, 10), SubmitResult::Accepted);
+    WaitForProcessed(orderbook, 151);
+
+    EXPECT_EQ(orderbook.GetOrdersOverCapacity(), 50u);
+    EXPECT_EQ(orderbook.GetTradesExecuted(), 10u);
+    EXPECT_EQ(orderbook.Size(), 90u);
+}
+
+TEST(EngineTest, BlockingEngineResumesAfterSlowConsumerCatchesUp)
+{
+    Orderbook::Config config;
+    config.eventRingCapacity = 4;
+    config.wait.policy = WaitPolicy::Blocking;
+    config.wait.spinLimit = 16;
+    Orderbook orderbook(config);
+
+    auto& events = orderbook.GetEvents();
+    const auto consumer = events.AddConsumer();
+
+    // 20 resting asks, then one buy that sweeps them: 20 trades into a
+    // 4-slot ring. The consumer reads late and never wakes the engine.
+    for (OrderId id = 1; id <= 20; ++id)
+        ASSERT_EQ(orderbook.AddOrder(OrderType::GoodTillCancel, id, Side::Sell, 100 + static_cast<Price>(id), 1), SubmitResult::Accepted);
+    ASSERT_EQ(orderbook.AddOrder(OrderType::GoodTillCancel, 100, Side::Buy, 200, 20), SubmitResult::Accepted);
+
+    while (orderbook.GetEventStalls() == 0)
+        std::this_thread::yield();
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    size_t trades = 0;
+    while (orderbook.GetOrdersProcessed() < 21 || events.GetConsumerStats(consumer).lag > 0)
+    {
+        events.Consume(consumer, [&](const EngineEvent& event)
+        {
+            trades += event.type == EngineEvent::Type::Trade;
+        });
+        std::this_thread::yield();
+    }
+    events.RemoveConsumer(consumer);
+
+    EXPECT_EQ(trades, 20u);
+    EXPECT_EQ(orderbook.GetTradesExecuted(), 20u);
+    EXPECT_EQ(orderbook.GetEventsDropped(), 0u);
+}
+
+TEST(EngineTest, BlockingEngineExpiresGoodForDayOnQuietBook)
+{
+    Orderbook::Config config;
+    config.wait.policy = WaitPolicy::Blocking;
+    config.wait.spinLimit = 16;
+    config.sessionClose = TimeOfDayIn(std::chrono::seconds(2));
+    Orderbook orderbook(config);
+
+    for (OrderId id = 1; id <= 10; ++id)
+        ASSERT_EQ(orderbook.AddOrder(OrderType::GoodForDay, id, Side::Buy, 100, 1), SubmitResult::Accepted);
+    ASSERT_EQ(orderbook.AddOrder(OrderType::GoodTillCancel, 11, Side::Sell, 200, 1), SubmitResult::Accepted);
+    WaitForProcessed(orderbook, 11);
+
+    // No more requests: only the park timing out at the close can expire them.
+    const auto start = std::chrono::steady_clock::now();
+    while (orderbook.GetOrdersExpired() < 10 && std::chrono::steady_clock::now() - start < std::chrono::seconds(10))
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    EXPECT_EQ(orderbook.GetOrdersExpired(), 10u);
+    EXPECT_GT(orderbook.GetWaitStats().parks, 0u);
+    EXPECT_EQ(orderbook.Size(), 1u);
+}
+
+TEST(EngineTest, WarmupResetsStatsOnEngineThread)
+{
+    Orderbook::Config config;
+    config.wait.policy = WaitPolicy::Blocking;
+    config.eventRingCapacity = 64;
+    Orderbook orderbook(config);
+
+    // Attached throughout; a full ring of warmup events would stall the engine.
+    auto& events = orderbook.GetEvents();
+    const auto consumer = events.AddConsumer();
+
+    orderbook.Warmup();
+    EXPECT_EQ(orderbook.GetOrdersProcessed(), 0u);
+    EXPECT_EQ(orderbook.GetTradesExecuted(), 0u);
+    EXPECT_EQ(orderbook.GetEventStalls(), 0u);
+    EXPECT_EQ(orderbook.GetLatencyStats().max, 0u);
+    EXPECT_EQ(orderbook.Size(), 0u);
+    EXPECT_EQ(events.GetPublished(), 0u);
+
+    // Recording resumes from the cleared histogram, and trade ids start at 1.
+    ASSERT_EQ(orderbook.AddOrder(OrderType::GoodTillCancel, 1, Side::Buy, 100, 1), SubmitResult::Accepted);
+    ASSERT_EQ(orderbook.AddOrder(OrderType::GoodTillCancel, 2, Side::Sell, 100, 1), SubmitResult::Accepted);
+    WaitForProcessed(orderbook, 2);
+    EXPECT_GT(orderbook.GetLatencyStats().max, 0u);
+    EXPECT_EQ(orderbook.GetTradesExecuted(), 1u);
+
+    uint64_t tradeId = 0;
+    events.Consume(consumer, [&](const EngineEvent& event)
+    {
+        if (event.type == EngineEvent::Type::Trade)
+            tradeId = event.trade.tradeId;
+    });
+    events.RemoveConsumer(consumer);
+    EXPECT_EQ(tradeId, 1u);
+}
+
+TEST(EngineTest, LevelTouchedManyTimesInBatchPublishesOneDelta)
+{
+    Orderbook::Config config;
+    config.eventRingCapacity = 1;
+    Orderbook orderbook(config);
+
+    auto& events = orderbook.GetEvents();
+    const auto consumer = events.AddConsumer();
+
+    // Hold the engine: a resting ask fills the one-slot ring, and a trade
+    // against it stalls until the consumer reads.
+    ASSERT_EQ(orderbook.AddOrder(OrderType::GoodTillCancel, 900001, Side::Sell, 10, 1), SubmitResult::Accepted);
+    ASSERT_EQ(orderbook.AddOrder(OrderType::GoodTillCancel, 900002, Side::Buy, 10, 1), SubmitResult::Accepted);
+    while (orderbook.GetEventStalls() == 0)
+        std::this_thread::yield();
+
+    // Queued behind the stall, so drained as one batch: bid 100 is touched
+    // seven times (five adds, a cancel, a fill), bid 99 once.
+    for (OrderId id = 1; id <= 5; ++id)
+        ASSERT_EQ(orderbook.AddOrder(OrderType::GoodTillCancel, id, Side::Buy, 100, 2), SubmitResult::Accepted);
+    ASSERT_EQ(orderbook.CancelOrder(3), SubmitResult::Accepted);
+    ASSERT_EQ(orderbook.AddOrder(OrderType::GoodTillCancel, 6, Side::Sell, 100, 3), SubmitResult::Accepted);
+    ASSERT_EQ(orderbook.AddOrder(OrderType::GoodTillCancel, 7, Side::Buy, 99, 4), SubmitResult::Accepted);
+
+    std::vector<std::vector<LevelDelta>> batches(1);
+    uint64_t lastSequence = 0;
+    while (orderbook.GetOrdersProcessed() < 10 || events.GetConsumerStats(consumer).lag > 0)
+    {
+        events.Consume(consumer, [&](const EngineEvent& event)
+        {
+            if (event.type != EngineEvent::Type::LevelDelta)
+                return;
+            EXPECT_EQ(event.delta.sequence, lastSequence + 1);
+            lastSequence = event.delta.sequence;
+            batches.back().push_back(event.delta);
+            if (event.delta.endOfBatch)
+                batches.emplace_back();
+        });
+        std::this_thread::yield();
+    }
+    events.RemoveConsumer(consumer);
+
+    // Every batch ended on an endOfBatch delta.
+    ASSERT_TRUE(batches.back().empty());
+    batches.pop_back();
+    ASSERT_GE(batches.size(), 2u);
+
+    const std::vector<LevelDelta>& last = batches.back();
+    ASSERT_EQ(last.size(), 2u);
+    const LevelDelta& bid100 = last[0].price == 100 ? last[0] : last[1];
+    const LevelDelta& bid99 = last[0].price == 100 ? last[1] : last[0];
+    EXPECT_EQ(bid100.side, Side::Buy);
+    EXPECT_EQ(bid100.price, 100);
+    EXPECT_EQ(bid100.quantity, 5u); // 5 x 2, less the cancel and a fill of 3
+    EXPECT_EQ(bid100.orderCount, 3u);
+    EXPECT_EQ(bid99.price, 99);
+    EXPECT_EQ(bid99.quantity, 4u);
+    EXPECT_FALSE(last[0].endOfBatch);
+    EXPECT_TRUE(last[1].endOfBatch);
+}
+
+TEST(EngineTest, DepthSnapshotReadsAreConsistentWhilePublishing)
+{
+    Orderbook::Config config;
+    config.snapshotDepth = 5;
+    Orderbook orderbook(config);
+
+    // Bids at 100-149 and asks at 150-199 never cross, and every order at a
+    // price has the same size, so a torn level or side shows up as a broken
+    // invariant.
+    auto sizeAt = [](Price price) { return static_cast<Quantity>(price % 5 + 1); };
+
+    std::atomic<bool> reading{ false };
+    std::atomic<bool> done{ false };
+    std::atomic<size_t> submitted{ 0 };
+    std::thread writer([&]
+    {
+        while (!reading.load())
+            std::this_thread::yield();
+
+        std::mt19937 rng(11);
+        std::vector<OrderId> live;
+        for (OrderId id = 1; id <= 20000; ++id)
+        {
+            if (id % 64 == 0)
+                std::this_thread::yield(); // Let the reader in on a single core
+            if (live.size() > 50 && rng() % 2)
+            {
+                const size_t victim = rng() % live.size();
+                while (orderbook.CancelOrder(live[victim]) != SubmitResult::Accepted)
+                    std::this_thread::yield();
+                live[victim] = live.back();
+                live.pop_back();
+            }
+            else
+            {
+                const Side side = rng() % 2 ? Side::Buy : Side::Sell;
+                const Price price = (side == Side::Buy ? 100 : 150) + static_cast<Price>(rng() % 50);
+                while (orderbook.AddOrder(OrderType::GoodTillCancel, id, side, price, sizeAt(price)) != SubmitResult::Accepted)
+                    std::this_thread::yield();
+                live.push_back(id);
+            }
+            ++submitted;
+        }
+        done = true;
+    });
+
+    auto check = [&](const DepthView& view)
+    {
+        ASSERT_LE(view.bids.size(), 5u);
+        ASSERT_LE(view.asks.size(), 5u);
+        for (size_t i = 0; i < view.bids.size(); ++i)
+        {
+            const DepthLevel& level = view.bids[i];
+            ASSERT_TRUE(level.price >= 100 && level.price < 150);
+            ASSERT_GT(level.orderCount, 0u);
+            ASSERT_EQ(level.quantity, uint64_t{ level.orderCount } * sizeAt(level.price));
+            ASSERT_TRUE(i == 0 || level.price < view.bids[i - 1].price);
+        }
+        for (size_t i = 0; i < view.asks.size(); ++i)
+        {
+            const DepthLevel& level = view.asks[i];
+            ASSERT_TRUE(level.price >= 150 && level.price < 200);
+            ASSERT_GT(level.orderCount, 0u);
+            ASSERT_EQ(level.quantity, uint64_t{ level.orderCount } * sizeAt(level.price));
+            ASSERT_TRUE(i == 0 || level.price > view.asks[i - 1].price);
+        }
+    };
+
+    std::thread reader([&]
+    {
+        DepthView view;
+        uint64_t lastVersion = 0;
+        while (!done.load())
+        {
+            orderbook.GetDepthSnapshot().Read(view);
+            reading = true;
+            EXPECT_GE(view.version, lastVersion);
+            lastVersion = view.version;
+            check(view);
+            std::this_thread::yield();
+        }
+    });
+
+    writer.join();
+    reader.join();
+    WaitForProcessed(orderbook, submitted);
+
+    // Once the engine is idle the snapshot is the top of the live book.
+    DepthView view;
+    orderbook.GetDepthSnapshot().Read(view);
+    check(view);
+    const auto infos = orderbook.GetOrderInfos();
+    ASSERT_EQ(view.bids.size(), std::min<size_t>(5, infos.GetBids().size()));
+    ASSERT_EQ(view.asks.size(), std::min<size_t>(5, infos.GetAsks().size()));
+    for (size_t i = 0; i < view.bids.size(); ++i)
+    {
+        EXPECT_EQ(view.bids[i].price, infos.GetBids()[i].price_);
+        EXPECT_EQ(view.bids[i].quantity, infos.GetBids()[i].quantity_);
+    }
+    for (size_t i = 0; i < view.asks.size(); ++i)
+    {
+        EXPECT_EQ(view.asks[i].price, infos.GetAsks()[i].price_);
+        EXPECT_EQ(view.asks[i].quantity, infos.GetAsks()[i].quantity_);
+    }
+}
+
+TEST(EngineTest, MassCancelHonoursFiltersAndOwnerList)
+{
+    Orderbook orderbook;
+    size_t submitted = 0;
+    auto add = [&](OrderId id, Side side, Price price, Quantity quantity, OwnerId owner)
+    {
+        ASSERT_EQ(orderbook.AddOrder(OrderType::GoodTillCancel, id, side, price, quantity, owner), SubmitResult::Accepted);
+        ++submitted;
+    };
+    auto massCancel = [&](const Orderbook::MassCancelFilter& filter)
+    {
+        ASSERT_EQ(orderbook.MassCancel(filter), SubmitResult::Accepted);
+        WaitForProcessed(orderbook, ++submitted);
+    };
+
+    add(1, Side::Buy, 100, 1, 7);
+    add(2, Side::Buy, 105, 2, 7);
+    add(3, Side::Buy, 110, 4, 7);
+    add(4, Side::Sell, 200, 8, 7);
+    add(5, Side::Buy, 105, 16, 8);
+    add(6, Side::Sell, 200, 32, 8);
+
+    // Bids of owner 7 in [100, 105] only.
+    massCancel({ .owner = 7, .minPrice = 100, .maxPrice = 105, .sells = false });
+    EXPECT_EQ(orderbook.Size(), 4u);
+    EXPECT_EQ(RestingAt(orderbook, Side::Buy, 100), 0u);
+    EXPECT_EQ(RestingAt(orderbook, Side::Buy, 105), 16u);
+    EXPECT_EQ(RestingAt(orderbook, Side::Buy, 110), 4u);
+
+    // Orders that left by a cancel or a fill are off the owner's list; a
+    // partly filled one is still on it.
+    ASSERT_EQ(orderbook.CancelOrder(3), SubmitResult::Accepted);
+    ++submitted;
+    add(7, Side::Buy, 200, 4, 9); // Fills 4 of order 4
+    add(8, Side::Sell, 210, 64, 7);
+    WaitForProcessed(orderbook, submitted);
+
+    massCancel({ .owner = 7 });
+    EXPECT_EQ(orderbook.Size(), 2u);
+    EXPECT_EQ(RestingAt(orderbook, Side::Sell, 200), 32u);
+    EXPECT_EQ(RestingAt(orderbook, Side::Sell, 210), 0u);
+
+    // The list starts over empty: only the new order goes.
+    add(9, Side::Buy, 90, 128, 7);
+    massCancel({ .owner = 7 });
+    EXPECT_EQ(orderbook.Size(), 2u);
+    EXPECT_EQ(RestingAt(orderbook, Side::Buy, 90), 0u);
+    EXPECT_EQ(RestingAt(orderbook, Side::Buy, 105), 16u);
+
+    // No owner and unknown owners cancel nothing.
+    massCancel({ });
+    massCancel({ .owner = 1234 });
+    EXPECT_EQ(orderbook.Size(), 2u);
+}
+
+TEST(EngineTest, AmendKeepsPriorityOnlyWhenQuantityGoesDown)
+{
+    // Orders 1 then 2 bid 5 at 100; after the amend a sell for 3 hits
+    // whichever is first. Returns the order that was hit.
+    auto firstAfter = [](const std::vector<OrderModify>& amends)
+    {
+        Orderbook orderbook;
+        size_t submitted = 0;
+        auto submit = [&](SubmitResult result) { EXPECT_EQ(result, SubmitResult::Accepted); ++submitted; };
+
+        submit(orderbook.AddOrder(OrderType::GoodTillCancel, 1, Side::Buy, 100, 5));
+        submit(orderbook.AddOrder(OrderType::GoodTillCancel, 2, Side::Buy, 100, 5));
+        for (const OrderModify& amend : amends)
+            submit(orderbook.ModifyOrder(amend));
+
+        auto& events = orderbook.GetEvents();
+        const auto consumer = events.AddConsumer();
+        submit(orderbook.AddOrder(OrderType::GoodTillCancel, 3, Side::Sell, 100, 3));
+        WaitForProcessed(orderbook, submitted);
+
+        OrderId hit = 0;
+        events.Consume(consumer, [&](const EngineEvent& event)
+        {
+            if (event.type == EngineEvent::Type::Trade && hit == 0)
+                hit = event.trade.bidOrderId;
+        });
+        events.RemoveConsumer(consumer);
+        return hit;
+    };
+
+    EXPECT_EQ(firstAfter({ }), 1u);
+    EXPECT_EQ(firstAfter({ { 1, Side::Buy, 100, 4 } }), 1u);   // Down in place
+    EXPECT_EQ(firstAfter({ { 1, Side::Buy, 100, 5 } }), 1u);   // Unchanged
+    EXPECT_EQ(firstAfter({ { 1, Side::Buy, 100, 6 } }), 2u);   // Up
+    EXPECT_EQ(firstAfter({ { 1, Side::Buy, 101, 4 }, { 1, Side::Buy, 100, 4 } }), 2u); // Away and back
+}
+
+#if !defined(_WIN32)
+TEST(EngineTest, ConsumerLagIsExportedToSharedMemoryMetrics)
+{
+    // Opened first, so the engine maps a segment that is already initialised.
+    const SharedMemoryMetrics metrics("/orderbook_engine_test_metrics");
+
+    Orderbook::Config config;
+    config.metricsShmName = "/orderbook_engine_test_metrics";
+    Orderbook orderbook(config);
+
+    auto& events = orderbook.GetEvents();
+    const auto reader = events.AddConsumer();
+    const auto idle = events.AddConsumer();
+    ASSERT_LT(idle, SharedMetrics::MAX_EVENT_CONSUMERS);
+
+    // Published once per batch, after the processed count moves.
+    const auto exported = [&](auto&& done)
+    {
+        for (auto snapshot = metrics.GetSnapshot(); ; snapshot = metrics.GetSnapshot())
+        {
+            if (snapshot.events_published == events.GetPublished() && done(snapshot))
+                return snapshot;
+            std::this_thread::yield();
+        }
+    };
+
+    ASSERT_EQ(orderbook.AddOrder(OrderType::GoodTillCancel, 1, Side::Buy, 100, 1), SubmitResult::Accepted);
+    ASSERT_EQ(orderbook.AddOrder(OrderType::GoodTillCancel, 2, Side::Sell, 100, 1), SubmitResult::Accepted);
+    WaitForProcessed(orderbook, 2);
+    const uint64_t backlog = events.GetPublished();
+    ASSERT_GT(backlog, 0u);
+    exported([&](const auto& snapshot) { return snapshot.event_consumer_lag[reader] == backlog; });
+
+    // The reader catches up and the next batch exports its lag as just that batch's events.
+    EXPECT_EQ(events.Consume(reader, [](const EngineEvent&) { }), backlog);
+    ASSERT_EQ(orderbook.AddOrder(OrderType::GoodTillCancel, 3, Side::Buy, 90, 1), SubmitResult::Accepted);
+    WaitForProcessed(orderbook, 3);
+    const uint64_t published = events.GetPublished();
+    auto snapshot = exported([&](const auto& snapshot) { return snapshot.event_consumer_lag[idle] == published; });
+    EXPECT_EQ(snapshot.event_consumer_lag[reader], published - backlog);
+    EXPECT_EQ(snapshot.event_consumer_max_lag[reader], backlog);
+    EXPECT_EQ(snapshot.event_consumer_max_lag[idle], 0u); // Never peeked
+    EXPECT_EQ(snapshot.event_stalls, 0u);
+
+    // A detached consumer's slot reads 0.
+    events.RemoveConsumer(idle);
+    ASSERT_EQ(orderbook.AddOrder(OrderType::GoodTillCancel, 4, Side::Buy, 91, 1), SubmitResult::Accepted);
+    WaitForProcessed(orderbook, 4);
+    snapshot = exported([&](const auto& snapshot) { return snapshot.event_consumer_lag[idle] == 0; });
+    EXPECT_EQ(snapshot.event_consumer_lag[reader], events.GetPublished() - backlog);
+    events.RemoveConsumer(reader);
+}
+#endif
@@ -0,0 +1,163 @@
+#include "pch.h"
+
+#include "../FanInQueue.h"
+
+namespace
+{
+    struct Item
+    {
+        uint64_t timestamp;
+        uint64_t value;
+    };
+
+    using Queue = FanInQueue<Item>;
+
+    // Peeks everything queued, returns the values in order and releases them.
+    std::vector<uint64_t> Drain(Queue& queue)
+    {
+        std::vector<uint64_t> values;
+        const Item* batch[64];
+        for (size_t count; (count = queue.PeekBatch(batch, 64)) > 0; )
+            for (size_t i = 0; i < count; ++i)
+                values.push_back(batch[i]->value);
+        queue.Release();
+        return values;
+    }
+}
+
+TEST(FanInQueueTest, ThrottledAtWindowUntilReleased)
+{
+    Queue queue(8, 1);
+    const auto producer = queue.RegisterProducer(3);
+    EXPECT_EQ(queue.Credits(producer), 3u);
+
+    for (uint64_t i = 0; i < 3; ++i)
+        ASSERT_EQ(queue.TryPush(producer, { 0, i }), SubmitResult::Accepted);
+    EXPECT_EQ(queue.TryPush(producer, { 0, 3 }), SubmitResult::Throttled);
+    EXPECT_EQ(queue.Credits(producer), 0u);
+
+    // Peeked items still hold their credits; only Release returns them.
+    const Item* batch[2];
+    ASSERT_EQ(queue.PeekBatch(batch, 2), 2u);
+    EXPECT_EQ(queue.TryPush(producer, { 0, 3 }), SubmitResult::Throttled);
+    queue.Release();
+    EXPECT_EQ(queue.Credits(producer), 2u);
+    EXPECT_EQ(queue.TryPush(producer, { 0, 3 }), SubmitResult::Accepted);
+
+    EXPECT_EQ(Drain(queue), (std::vector<uint64_t>{ 2, 3 }));
+    EXPECT_EQ(queue.Credits(producer), 3u);
+
+    const auto stats = queue.GetLaneStats(producer);
+    EXPECT_EQ(stats.creditWindow, 3u);
+    EXPECT_EQ(stats.accepted, 4u);
+    EXPECT_EQ(stats.throttled, 2u);
+    EXPECT_EQ(stats.queueFull, 0u);
+}
+
+TEST(FanInQueueTest, WholeLaneWindowReportsQueueFull)
+{
+    Queue queue(5, 1);
+    ASSERT_EQ(queue.SlotsPerLane(), 8u);
+
+    // 0 and anything past the lane's slots both grant the whole lane.
+    const auto producer = queue.RegisterProducer();
+    for (uint64_t i = 0; i < queue.SlotsPerLane(); ++i)
+        ASSERT_EQ(queue.TryPush(producer, { 0, i }), SubmitResult::Accepted);
+    EXPECT_EQ(queue.TryPush(producer, { 0, 8 }), SubmitResult::QueueFull);
+
+    const auto stats = queue.GetLaneStats(producer);
+    EXPECT_EQ(stats.creditWindow, 8u);
+    EXPECT_EQ(stats.queueFull, 1u);
+    EXPECT_EQ(stats.throttled, 0u);
+
+    Queue capped(8, 1);
+    EXPECT_EQ(capped.GetLaneStats(capped.RegisterProducer(1000)).creditWindow, 8u);
+}
+
+TEST(FanInQueueTest, LanesHaveIndependentWindows)
+{
+    Queue queue(8, 2);
+    const auto tight = queue.RegisterProducer(1);
+    const auto wide = queue.RegisterProducer(4);
+
+    EXPECT_EQ(queue.TryPush(tight, { 0, 1 }), SubmitResult::Accepted);
+    EXPECT_EQ(queue.TryPush(tight, { 0, 2 }), SubmitResult::Throttled);
+    for (uint64_t i = 0; i < 4; ++i)
+        EXPECT_EQ(queue.TryPush(wide, { 0, 10 + i }), SubmitResult::Accepted);
+    EXPECT_EQ(queue.TryPush(wide, { 0, 14 }), SubmitResult::Throttled);
+
+    EXPECT_EQ(Drain(queue).size(), 5u);
+    EXPECT_EQ(queue.Credits(tight), 1u);
+    EXPECT_EQ(queue.Credits(wide), 4u);
+    EXPECT_EQ(queue.GetLaneStats(tight).throttled, 1u);
+    EXPECT_EQ(queue.GetLaneStats(wide).throttled, 1u);
+    EXPECT_THROW(queue.RegisterProducer(), std::length_error);
+}
+
+TEST(FanInQueueTest, HighWaterMarkKeepsDeepestPoll)
+{
+    Queue queue(16, 1);
+    const auto producer = queue.RegisterProducer();
+
+    for (uint64_t i = 0; i < 5; ++i)
+        queue.TryPush(producer, { 0, i });
+    Drain(queue);
+    EXPECT_EQ(queue.GetLaneStats(producer).highWaterMark, 5u);
+
+    for (uint64_t i = 0; i < 2; ++i)
+        queue.TryPush(producer, { 0, i });
+    Drain(queue);
+    EXPECT_EQ(queue.GetLaneStats(producer).highWaterMark, 5u);
+}
+
+TEST(FanInQueueTest, MergedPolicyOrdersByTimestamp)
+{
+    Queue queue(8, 2, FanInPolicy::TimestampMerged);
+    const auto first = queue.RegisterProducer();
+    const auto second = queue.RegisterProducer();
+
+    for (const uint64_t timestamp : { 1, 4, 6 })
+        queue.TryPush(first, { timestamp, timestamp });
+    for (const uint64_t timestamp : { 2, 3, 5 })
+        queue.TryPush(second, { timestamp, timestamp });
+
+    EXPECT_EQ(Drain(queue), (std::vector<uint64_t>{ 1, 2, 3, 4, 5, 6 }));
+}
+
+TEST(FanInQueueTest, CreditsBalanceUnderConcurrentDrain)
+{
+    constexpr uint64_t count = 100'000;
+    Queue queue(64, 1);
+    const auto producer = queue.RegisterProducer(16);
+
+    std::thread thread([&]
+    {
+        for (uint64_t i = 0; i < count; )
+        {
+            if (queue.TryPush(producer, { 0, i }) == SubmitResult::Accepted)
+                ++i;
+            else
+                std::this_thread::yield();
+        }
+    });
+
+    uint64_t expected = 0;
+    const Item* batch[32];
+    while (expected < count)
+    {
+        const size_t peeked = queue.PeekBatch(batch, 32);
+        ASSERT_LE(peeked, 16u); // Never more in flight than the window
+        for (size_t i = 0; i < peeked; ++i)
+            ASSERT_EQ(batch[i]->value, expected++);
+        queue.Release();
+        if (peeked == 0)
+            std::this_thread::yield();
+    }
+    thread.join();
+
+    const auto stats = queue.GetLaneStats(producer);
+    EXPECT_EQ(stats.accepted, count);
+    EXPECT_EQ(stats.queueFull, 0u);
+    EXPECT_LE(stats.highWaterMark, 16u);
+    EXPECT_TRUE(queue.IsEmpty());
+}
@@ -0,0 +1,73 @@
+#include "pch.h"
+
+#include "../FenwickTree.h"
+
+#include <random>
+
+TEST(FenwickTreeTest, PrefixSuffixAndRangeSums)
+{
+    FenwickTree tree(10);
+    tree.Add(0, 5);
+    tree.Add(3, 7);
+    tree.Add(9, 11);
+
+    EXPECT_EQ(tree.Total(), 23u);
+    EXPECT_EQ(tree.PrefixSum(0), 5u);
+    EXPECT_EQ(tree.PrefixSum(2), 5u);
+    EXPECT_EQ(tree.PrefixSum(3), 12u);
+    EXPECT_EQ(tree.PrefixSum(100), 23u); // Clamped
+    EXPECT_EQ(tree.SuffixSum(0), 23u);
+    EXPECT_EQ(tree.SuffixSum(4), 11u);
+    EXPECT_EQ(tree.RangeSum(1, 3), 7u);
+    EXPECT_EQ(tree.RangeSum(4, 3), 0u);
+}
+
+TEST(FenwickTreeTest, NegativeDeltasCancelExactly)
+{
+    FenwickTree tree(64);
+    tree.Add(10, 100);
+    tree.Add(20, 50);
+    tree.Add(10, -100);
+
+    EXPECT_EQ(tree.Total(), 50u);
+    EXPECT_EQ(tree.PrefixSum(15), 0u);
+    EXPECT_EQ(tree.PrefixSum(63), 50u);
+}
+
+TEST(FenwickTreeTest, MatchesNaiveSums)
+{
+    constexpr size_t size = 5000;
+    FenwickTree tree(size);
+    std::vector<uint64_t> levels(size, 0);
+    std::mt19937_64 rng(9);
+
+    for (int step = 0; step < 100'000; ++step)
+    {
+        // Add, or take out part of what rests (never below zero, like a book).
+        const size_t index = rng() % size;
+        const int64_t delta = levels[index] > 0 && rng() % 2
+            ? -static_cast<int64_t>(1 + rng() % levels[index])
+            : static_cast<int64_t>(1 + rng() % 1000);
+        tree.Add(index, delta);
+        levels[index] += static_cast<uint64_t>(delta);
+
+        if (step % 97 == 0)
+        {
+            size_t first = rng() % size;
+            size_t last = rng() % size;
+            if (first > last)
+                std::swap(first, last);
+
+            uint64_t expected = 0;
+            for (size_t i = first; i <= last; ++i)
+                expected += levels[i];
+            ASSERT_EQ(tree.RangeSum(first, last), expected);
+
+            uint64_t prefix = 0;
+            for (size_t i = 0; i <= last; ++i)
+                prefix += levels[i];
+            ASSERT_EQ(tree.PrefixSum(last), prefix);
+            ASSERT_EQ(tree.SuffixSum(last + 1), tree.Total() - prefix);
+        }
+    }
+}
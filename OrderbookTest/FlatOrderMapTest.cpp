@@ -0,0 +1,149 @@
+#include "pch.h"
+
+#include "../FlatOrderMap.h"
+
+#include <random>
+#include <unordered_map>
+
+namespace
+{
+    // Home slot of a key in a 16-slot map (mirrors FlatOrderMap's Fibonacci hash).
+    size_t HomeIn16(OrderId key)
+    {
+        return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 60);
+    }
+
+    std::vector<OrderId> KeysWithHome(size_t home, size_t count, OrderId from = 1)
+    {
+        std::vector<OrderId> keys;
+        for (OrderId key = from; keys.size() < count; ++key)
+            if (HomeIn16(key) == home)
+                keys.push_back(key);
+        return keys;
+    }
+}
+
+TEST(FlatOrderMapTest, InsertFindExtract)
+{
+    FlatOrderMap<int> map(4);
+    EXPECT_TRUE(map.Insert(10, 1));
+    EXPECT_FALSE(map.Insert(10, 2)); // Duplicate keeps the stored value
+    ASSERT_NE(map.Find(10), nullptr);
+    EXPECT_EQ(*map.Find(10), 1);
+
+    EXPECT_EQ(map.Extract(10), 1);
+    EXPECT_FALSE(map.Extract(10).has_value());
+    EXPECT_TRUE(map.IsEmpty());
+}
+
+TEST(FlatOrderMapTest, BackwardShiftAcrossWrappedCluster)
+{
+    FlatOrderMap<int> map(4);
+    ASSERT_EQ(map.Capacity(), 16u);
+
+    // Three keys homed in the last slot spill over into slots 0 and 1, and a
+    // key homed in slot 0 lands behind them in slot 2.
+    const std::vector<OrderId> tail = KeysWithHome(15, 3);
+    const OrderId front = KeysWithHome(0, 1).front();
+    for (size_t i = 0; i < tail.size(); ++i)
+        ASSERT_TRUE(map.Insert(tail[i], static_cast<int>(i)));
+    ASSERT_TRUE(map.Insert(front, 99));
+
+    // Deleting the cluster's head must pull the wrapped members back across
+    // the end of the table without losing the one homed after the wrap.
+    EXPECT_TRUE(map.Erase(tail[0]));
+    EXPECT_EQ(map.Find(tail[0]), nullptr);
+    ASSERT_NE(map.Find(tail[1]), nullptr);
+    EXPECT_EQ(*map.Find(tail[1]), 1);
+    ASSERT_NE(map.Find(tail[2]), nullptr);
+    EXPECT_EQ(*map.Find(tail[2]), 2);
+    ASSERT_NE(map.Find(front), nullptr);
+    EXPECT_EQ(*map.Find(front), 99);
+
+    // And from the middle of the wrapped part.
+    EXPECT_TRUE(map.Erase(tail[2]));
+    ASSERT_NE(map.Find(front), nullptr);
+    EXPECT_EQ(*map.Find(front), 99);
+    EXPECT_EQ(map.Size(), 2u);
+}
+
+TEST(FlatOrderMapTest, ReservedKeyIsNeverStored)
+{
+    FlatOrderMap<int> map(4);
+    constexpr OrderId reserved = FlatOrderMap<int>::EmptyKey;
+
+    EXPECT_FALSE(map.Insert(reserved, 1));
+    EXPECT_FALSE(map.Contains(reserved));
+    EXPECT_EQ(map.Find(reserved), nullptr);
+    EXPECT_FALSE(map.Erase(reserved));
+    EXPECT_FALSE(map.Extract(reserved).has_value());
+    EXPECT_TRUE(map.IsEmpty());
+}
+
+TEST(FlatOrderMapTest, FullMapRejectsInsteadOfRehashing)
+{
+    FlatOrderMap<int> map(8);
+    const size_t capacity = map.Capacity();
+    ASSERT_GE(map.MaxEntries(), 8u);
+
+    OrderId key = 1;
+    while (!map.IsFull())
+        ASSERT_TRUE(map.Insert(key++, 0));
+
+    EXPECT_FALSE(map.Insert(key, 0));
+    EXPECT_EQ(map.Capacity(), capacity);
+
+    // Room again after an erase; Reserve grows it explicitly.
+    EXPECT_TRUE(map.Erase(1));
+    EXPECT_TRUE(map.Insert(key++, 0));
+    map.Reserve(4 * map.MaxEntries());
+    EXPECT_GT(map.Capacity(), capacity);
+    EXPECT_TRUE(map.Insert(key, 0));
+    EXPECT_NE(map.Find(2), nullptr);
+}
+
+TEST(FlatOrderMapTest, InsertAfterHeavyChurn)
+{
+    constexpr size_t live = 1000;
+    FlatOrderMap<OrderId> map(live);
+    std::unordered_map<OrderId, OrderId> reference;
+    std::vector<OrderId> keys;
+
+    std::mt19937_64 rng(7);
+    OrderId next = 1;
+    for (size_t i = 0; i < live; ++i)
+    {
+        ASSERT_TRUE(map.Insert(next, next * 3));
+        reference.emplace(next, next * 3);
+        keys.push_back(next++);
+    }
+
+    // Replace random entries many times over: every probe sequence must stay
+    // intact through the backward shifts.
+    for (size_t round = 0; round < 200'000; ++round)
+    {
+        const size_t victim = rng() % keys.size();
+        ASSERT_EQ(map.Extract(keys[victim]), reference.at(keys[victim]));
+        reference.erase(keys[victim]);
+
+        const OrderId key = rng() % 2 ? next++ : rng();
+        if (key == FlatOrderMap<OrderId>::EmptyKey || reference.contains(key))
+        {
+            keys[victim] = keys.back();
+            keys.pop_back();
+            continue;
+        }
+        ASSERT_TRUE(map.Insert(key, key * 3));
+        reference.emplace(key, key * 3);
+        keys[victim] = key;
+    }
+
+    ASSERT_EQ(map.Size(), reference.size());
+    for (const auto& [key, value] : reference)
+    {
+        ASSERT_NE(map.Find(key), nullptr);
+        EXPECT_EQ(*map.Find(key), value);
+    }
+    for (OrderId miss = next; miss < next + 1000; ++miss)
+        EXPECT_FALSE(map.Contains(miss));
+}
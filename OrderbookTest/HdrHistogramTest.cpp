@@ -0,0 +1,91 @@
+#include "pch.h"
+
+#include "../HdrHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+TEST(HdrHistogramTest, EmptyReportsZero)
+{
+    HdrHistogram<> histogram;
+    EXPECT_EQ(histogram.Count(), 0u);
+    EXPECT_EQ(histogram.Max(), 0u);
+    EXPECT_EQ(histogram.ValueAtPercentile(50.0), 0u);
+}
+
+TEST(HdrHistogramTest, SmallValuesAreExact)
+{
+    HdrHistogram<> histogram;
+    for (uint64_t value = 1; value <= 100; ++value)
+        histogram.Record(value);
+
+    EXPECT_EQ(histogram.Count(), 100u);
+    EXPECT_EQ(histogram.ValueAtPercentile(50.0), 50u);
+    EXPECT_EQ(histogram.ValueAtPercentile(99.0), 99u);
+    EXPECT_EQ(histogram.ValueAtPercentile(100.0), 100u);
+    EXPECT_EQ(histogram.ValueAtPercentile(0.0), 1u);
+}
+
+TEST(HdrHistogramTest, BucketsCoverEveryValue)
+{
+    using Histogram = HdrHistogram<>;
+    EXPECT_EQ(Histogram::LowestEquivalentValue(0), 0u);
+    EXPECT_EQ(Histogram::HighestEquivalentValue(Histogram::BucketCount - 1), UINT64_MAX);
+    EXPECT_EQ(Histogram::IndexOf(UINT64_MAX), Histogram::BucketCount - 1);
+
+    // Adjacent buckets meet without gaps, and each value lands in its bucket.
+    for (size_t i = 0; i + 1 < Histogram::BucketCount; ++i)
+        ASSERT_EQ(Histogram::HighestEquivalentValue(i) + 1, Histogram::LowestEquivalentValue(i + 1)) << "bucket " << i;
+
+    std::mt19937_64 rng(11);
+    for (int i = 0; i < 100000; ++i)
+    {
+        const uint64_t value = rng() >> (rng() % 64);
+        const size_t index = Histogram::IndexOf(value);
+        ASSERT_LE(Histogram::LowestEquivalentValue(index), value);
+        ASSERT_GE(Histogram::HighestEquivalentValue(index), value);
+    }
+}
+
+TEST(HdrHistogramTest, PercentilesWithinRelativeError)
+{
+    HdrHistogram<> histogram;
+    std::vector<uint64_t> values;
+    std::mt19937_64 rng(3);
+    std::lognormal_distribution<double> latency(7.0, 1.5);
+    for (int i = 0; i < 200000; ++i)
+    {
+        const uint64_t value = static_cast<uint64_t>(latency(rng));
+        values.push_back(value);
+        histogram.Record(value);
+    }
+    std::sort(values.begin(), values.end());
+
+    // 7 sub-bucket bits: within 2^-6 of the exact nearest-rank value, never below it.
+    for (const double percentile : { 50.0, 90.0, 99.0, 99.9, 99.99 })
+    {
+        const size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * values.size()));
+        const uint64_t exact = values[rank - 1];
+        const uint64_t reported = histogram.ValueAtPercentile(percentile);
+        EXPECT_GE(reported, exact) << "p" << percentile;
+        EXPECT_LE(static_cast<double>(reported), static_cast<double>(exact) * (1.0 + 1.0 / 64)) << "p" << percentile;
+    }
+    EXPECT_EQ(histogram.Max(), values.back());
+    EXPECT_EQ(histogram.ValueAtPercentile(100.0), values.back());
+}
+
+TEST(HdrHistogramTest, ResetClearsEverything)
+{
+    HdrHistogram<> histogram;
+    histogram.Record(5);
+    histogram.Record(1'000'000);
+    histogram.Reset();
+
+    EXPECT_EQ(histogram.Count(), 0u);
+    EXPECT_EQ(histogram.Max(), 0u);
+    EXPECT_EQ(histogram.ValueAtPercentile(99.0), 0u);
+
+    histogram.Record(7);
+    EXPECT_EQ(histogram.ValueAtPercentile(50.0), 7u);
+}
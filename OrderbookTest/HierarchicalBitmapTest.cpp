@@ -0,0 +1,98 @@
+#include "pch.h"
+
+#include "../HierarchicalBitmap.h"
+
+#include <random>
+#include <set>
+
+TEST(HierarchicalBitmapTest, EmptyFindsNothing)
+{
+    HierarchicalBitmap bitmap(1000);
+    EXPECT_TRUE(bitmap.IsEmpty());
+    EXPECT_EQ(bitmap.FindFirst(), HierarchicalBitmap::npos);
+    EXPECT_EQ(bitmap.FindLast(), HierarchicalBitmap::npos);
+    EXPECT_EQ(bitmap.FindNext(500), HierarchicalBitmap::npos);
+    EXPECT_EQ(bitmap.FindPrev(500), HierarchicalBitmap::npos);
+
+    HierarchicalBitmap none(0);
+    EXPECT_EQ(none.FindFirst(), HierarchicalBitmap::npos);
+    EXPECT_EQ(none.FindLast(), HierarchicalBitmap::npos);
+}
+
+TEST(HierarchicalBitmapTest, SetAndClearAreIdempotent)
+{
+    HierarchicalBitmap bitmap(100);
+    bitmap.Set(7);
+    bitmap.Set(7);
+    EXPECT_EQ(bitmap.Count(), 1u);
+    EXPECT_TRUE(bitmap.Test(7));
+
+    bitmap.Clear(7);
+    bitmap.Clear(7);
+    EXPECT_EQ(bitmap.Count(), 0u);
+    EXPECT_FALSE(bitmap.Test(7));
+    EXPECT_EQ(bitmap.FindFirst(), HierarchicalBitmap::npos);
+}
+
+TEST(HierarchicalBitmapTest, FindsAcrossWordAndSummaryBoundaries)
+{
+    // 64^2 indices per middle word: these sit on either side of leaf, middle
+    // and summary word edges.
+    const size_t bits = 3 * 64 * 64 * 64 + 5;
+    HierarchicalBitmap bitmap(bits);
+    const std::vector<size_t> set{ 0, 63, 64, 4095, 4096, 262143, 262144, 500000, bits - 1 };
+    for (const size_t index : set)
+        bitmap.Set(index);
+
+    EXPECT_EQ(bitmap.FindFirst(), 0u);
+    EXPECT_EQ(bitmap.FindLast(), bits - 1);
+    for (size_t i = 0; i + 1 < set.size(); ++i)
+    {
+        EXPECT_EQ(bitmap.FindNext(set[i] + 1), set[i + 1]);
+        EXPECT_EQ(bitmap.FindPrev(set[i + 1] - 1), set[i]);
+    }
+    EXPECT_EQ(bitmap.FindNext(bits - 1), bits - 1);
+    EXPECT_EQ(bitmap.FindNext(bits), HierarchicalBitmap::npos);
+    EXPECT_EQ(bitmap.FindPrev(bits + 100), bits - 1); // Clamped
+
+    bitmap.Clear(0);
+    bitmap.Clear(bits - 1);
+    EXPECT_EQ(bitmap.FindFirst(), 63u);
+    EXPECT_EQ(bitmap.FindLast(), 500000u);
+}
+
+TEST(HierarchicalBitmapTest, MatchesOrderedSet)
+{
+    constexpr size_t bits = 1'000'000;
+    HierarchicalBitmap bitmap(bits);
+    std::set<size_t> reference;
+    std::mt19937_64 rng(21);
+
+    for (int step = 0; step < 200'000; ++step)
+    {
+        // Clustered around a moving mid, like a price ladder.
+        const size_t mid = 500'000 + (step / 1000) * 7 % 200'000;
+        const size_t index = rng() % 8 == 0 ? rng() % bits : (mid + rng() % 4000) % bits;
+        if (rng() % 3 == 0)
+        {
+            bitmap.Clear(index);
+            reference.erase(index);
+        }
+        else
+        {
+            bitmap.Set(index);
+            reference.insert(index);
+        }
+
+        const size_t probe = rng() % bits;
+        const auto next = reference.lower_bound(probe);
+        ASSERT_EQ(bitmap.FindNext(probe), next == reference.end() ? HierarchicalBitmap::npos : *next);
+
+        const auto after = reference.upper_bound(probe);
+        ASSERT_EQ(bitmap.FindPrev(probe), after == reference.begin() ? HierarchicalBitmap::npos : *std::prev(after));
+    }
+
+    EXPECT_EQ(bitmap.Count(), reference.size());
+    EXPECT_EQ(bitmap.FindFirst(), *reference.begin());
+    EXPECT_EQ(bitmap.FindLast(), *reference.rbegin());
+}
@@ -0,0 +1,93 @@
+#include "pch.h"
+
+#include "../ObjectPool.h"
+
+#include <set>
+
+namespace
+{
+    // 8 generation bits, so a slot's generations run out in a few hundred reuses.
+    using SmallHandle = BasicPoolHandle<std::uint32_t, 24>;
+    using SmallPool = ObjectPool<int, void, NoPoolLock, SmallHandle>;
+}
+
+TEST(PoolHandleTest, PacksIndexAndGeneration)
+{
+    const PoolHandle handle{ 0xFFFF'FFFEu, 0xFFFF'FFFEu };
+    EXPECT_EQ(handle.Index(), 0xFFFF'FFFEu);
+    EXPECT_EQ(handle.Generation(), 0xFFFF'FFFEu);
+    EXPECT_TRUE(handle.IsValid());
+    EXPECT_EQ(PoolHandle::FromValue(handle.Value()), handle);
+
+    EXPECT_FALSE(PoolHandle::Invalid().IsValid());
+    EXPECT_FALSE(PoolHandle{}.IsValid());
+    EXPECT_GE(PoolHandle::MaxSlots, 50'000'000u);
+}
+
+TEST(ObjectPoolTest, ReleaseMakesHandleStale)
+{
+    ObjectPool<int> pool(16);
+    const auto first = pool.Acquire();
+    pool[first] = 7;
+    ASSERT_NE(pool.Get(first), nullptr);
+    EXPECT_EQ(*pool.Get(first), 7);
+
+    pool.Release(first);
+    EXPECT_EQ(pool.Get(first), nullptr);
+
+    // Same slot, next generation; the old handle stays stale.
+    const auto second = pool.Acquire();
+    EXPECT_EQ(second.Index(), first.Index());
+    EXPECT_NE(second.Generation(), first.Generation());
+    EXPECT_EQ(pool.Get(first), nullptr);
+
+    // Releasing the stale handle again must not free the new occupant.
+    pool.Release(first);
+    EXPECT_TRUE(pool.IsLive(second));
+}
+
+TEST(ObjectPoolTest, GrowsByChunkUpToMaxSize)
+{
+    ObjectPool<int> pool(1, ObjectPool<int>::ChunkSize);
+    EXPECT_EQ(pool.Capacity(), ObjectPool<int>::ChunkSize);
+
+    std::vector<PoolHandle> handles;
+    for (size_t i = 0; i < ObjectPool<int>::ChunkSize; ++i)
+        handles.push_back(pool.Acquire());
+
+    EXPECT_THROW(pool.Acquire(), std::length_error);
+
+    pool.Release(handles.back());
+    EXPECT_NO_THROW(pool.Acquire());
+}
+
+TEST(ObjectPoolTest, GenerationWraparoundRetiresSlot)
+{
+    SmallPool pool(1);
+    const SmallHandle first = pool.Acquire();
+    std::vector<SmallHandle> stale{ first };
+    pool.Release(first);
+
+    // The freed slot is reused first (LIFO) until its generations run out.
+    for (std::uint32_t generation = 1; generation < SmallHandle::MaxGeneration; ++generation)
+    {
+        const SmallHandle handle = pool.Acquire();
+        ASSERT_EQ(handle.Index(), first.Index());
+        ASSERT_EQ(handle.Generation(), generation);
+        stale.push_back(handle);
+        pool.Release(handle);
+    }
+    EXPECT_EQ(pool.Retired(), 1u);
+
+    // Retired, not wrapped back to generation 0: the slot is never handed out
+    // again and no earlier handle to it comes back to life.
+    const SmallHandle next = pool.Acquire();
+    EXPECT_NE(next.Index(), first.Index());
+    for (const SmallHandle& handle : stale)
+        EXPECT_FALSE(pool.IsLive(handle));
+
+    std::set<std::uint32_t> indexes;
+    for (int i = 0; i < 1000; ++i)
+        indexes.insert(pool.Acquire().Index());
+    EXPECT_EQ(indexes.count(first.Index()), 0u);
+}
@@ -0,0 +1,207 @@
+#include "pch.h"
+
+#include "../OrderQueue.h"
+
+#include <deque>
+#include <random>
+
+namespace
+{
+    OrderHandle NewOrder(OrderPool& pool, OrderId id, Quantity quantity)
+    {
+        const OrderHandle handle = pool.Acquire();
+        pool[handle].Reset(OrderType::GoodTillCancel, id, Side::Sell, 100, quantity);
+        return handle;
+    }
+
+    std::vector<OrderId> Ids(const OrderQueue& queue, const OrderPool& pool)
+    {
+        std::vector<OrderId> ids;
+        queue.ForEach(pool, [&](const Order& order) { ids.push_back(order.GetOrderId()); });
+        return ids;
+    }
+}
+
+TEST(OrderQueueTest, FillsInTimePriorityAndKeepsPartialInPlace)
+{
+    OrderPool pool(64);
+    LevelArena arena;
+    OrderQueue queue;
+    for (OrderId id = 1; id <= 4; ++id)
+        queue.PushBack(pool, arena, NewOrder(pool, id, 10));
+
+    std::vector<std::pair<OrderId, Quantity>> fills;
+    const Quantity filled = queue.Fill(pool, 25, [&](OrderHandle handle, Quantity quantity)
+    {
+        fills.emplace_back(pool[handle].GetOrderId(), quantity);
+    });
+
+    EXPECT_EQ(filled, 25u);
+    EXPECT_EQ(fills, (std::vector<std::pair<OrderId, Quantity>>{ { 1, 10 }, { 2, 10 }, { 3, 5 } }));
+    EXPECT_EQ(queue.Size(), 2u);
+    EXPECT_EQ(pool[queue.Front()].GetOrderId(), 3u);
+    EXPECT_EQ(pool[queue.Front()].GetRemainingQuantity(), 5u);
+
+    // More than rests: fills what is there and empties the queue.
+    EXPECT_EQ(queue.Fill(pool, 100, [](OrderHandle, Quantity) { }), 15u);
+    EXPECT_TRUE(queue.IsEmpty());
+    EXPECT_FALSE(queue.Front().IsValid());
+}
+
+TEST(OrderQueueTest, EraseLeavesTombstoneThatFillSkips)
+{
+    OrderPool pool(64);
+    LevelArena arena;
+    OrderQueue queue;
+    std::vector<OrderHandle> handles;
+    for (OrderId id = 1; id <= 5; ++id)
+    {
+        handles.push_back(NewOrder(pool, id, 10));
+        queue.PushBack(pool, arena, handles.back());
+    }
+
+    queue.Erase(pool, handles[1]);
+    queue.Erase(pool, handles[0]); // Head: Front moves past both
+    EXPECT_EQ(queue.Size(), 3u);
+    EXPECT_EQ(pool[queue.Front()].GetOrderId(), 3u);
+    EXPECT_EQ(Ids(queue, pool), (std::vector<OrderId>{ 3, 4, 5 }));
+
+    queue.Erase(pool, handles[3]);
+    std::vector<OrderId> filled;
+    EXPECT_EQ(queue.Fill(pool, 20, [&](OrderHandle handle, Quantity) { filled.push_back(pool[handle].GetOrderId()); }), 20u);
+    EXPECT_EQ(filled, (std::vector<OrderId>{ 3, 5 }));
+    EXPECT_TRUE(queue.IsEmpty());
+}
+
+TEST(OrderQueueTest, AmendInPlaceKeepsPriority)
+{
+    OrderPool pool(64);
+    LevelArena arena;
+    OrderQueue queue;
+    const OrderHandle first = NewOrder(pool, 1, 10);
+    queue.PushBack(pool, arena, first);
+    queue.PushBack(pool, arena, NewOrder(pool, 2, 10));
+
+    pool[first].ReduceQuantity(4);
+    queue.SyncQuantity(pool, first);
+
+    std::vector<std::pair<OrderId, Quantity>> fills;
+    queue.Fill(pool, 6, [&](OrderHandle handle, Quantity quantity) { fills.emplace_back(pool[handle].GetOrderId(), quantity); });
+    EXPECT_EQ(fills, (std::vector<std::pair<OrderId, Quantity>>{ { 1, 4 }, { 2, 2 } }));
+}
+
+TEST(OrderQueueTest, PackingKeepsSlotsValid)
+{
+    OrderPool pool(1024);
+    LevelArena arena;
+    OrderQueue queue;
+    std::deque<OrderHandle> live;
+    OrderId next = 1;
+
+    // Push and cancel from the middle so the arrays fill with tombstones and
+    // are packed; every later cancel must still find its order's slot.
+    for (int round = 0; round < 200; ++round)
+    {
+        for (int i = 0; i < 8; ++i)
+        {
+            live.push_back(NewOrder(pool, next++, 1));
+            queue.PushBack(pool, arena, live.back());
+        }
+        for (int i = 0; i < 6; ++i)
+        {
+            const size_t victim = live.size() / 2;
+            queue.Erase(pool, live[victim]);
+            pool.Release(live[victim]);
+            live.erase(live.begin() + static_cast<std::ptrdiff_t>(victim));
+        }
+    }
+
+    std::vector<OrderId> expected;
+    for (const OrderHandle handle : live)
+        expected.push_back(pool[handle].GetOrderId());
+    EXPECT_EQ(queue.Size(), live.size());
+    EXPECT_EQ(Ids(queue, pool), expected);
+}
+
+TEST(OrderQueueTest, MatchesReferenceFifo)
+{
+    OrderPool pool(4096);
+    LevelArena arena;
+    OrderQueue queue;
+    std::deque<std::pair<OrderHandle, Quantity>> reference;
+    std::mt19937_64 rng(13);
+    OrderId next = 1;
+
+    for (int step = 0; step < 50'000; ++step)
+    {
+        const unsigned op = rng() % 10;
+        if (op < 5 || reference.empty())
+        {
+            const Quantity quantity = static_cast<Quantity>(1 + rng() % 50);
+            const OrderHandle handle = NewOrder(pool, next++, quantity);
+            queue.PushBack(pool, arena, handle);
+            reference.emplace_back(handle, quantity);
+        }
+        else if (op < 8)
+        {
+            const size_t victim = rng() % reference.size();
+            queue.Erase(pool, reference[victim].first);
+            pool.Release(reference[victim].first);
+            reference.erase(reference.begin() + static_cast<std::ptrdiff_t>(victim));
+        }
+        else
+        {
+            Quantity incoming = static_cast<Quantity>(1 + rng() % 120);
+            std::vector<std::pair<OrderHandle, Quantity>> expected;
+            Quantity expectedFilled = 0;
+            for (auto it = reference.begin(); it != reference.end() && incoming > 0;)
+            {
+                const Quantity take = std::min(incoming, it->second);
+                expected.emplace_back(it->first, take);
+                expectedFilled += take;
+                incoming -= take;
+                it->second -= take;
+                it = it->second == 0 ? reference.erase(it) : it + 1;
+            }
+
+            std::vector<std::pair<OrderHandle, Quantity>> fills;
+            const Quantity filled = queue.Fill(pool, expectedFilled + incoming, [&](OrderHandle handle, Quantity quantity)
+            {
+                fills.emplace_back(handle, quantity);
+            });
+            ASSERT_EQ(filled, expectedFilled);
+            ASSERT_EQ(fills, expected);
+            for (const auto& [handle, quantity] : fills)
+                if (pool[handle].IsFilled())
+                    pool.Release(handle);
+        }
+
+        ASSERT_EQ(queue.Size(), reference.size());
+        if (!reference.empty())
+        {
+            ASSERT_EQ(queue.Front(), reference.front().first);
+            ASSERT_EQ(pool[queue.Front()].GetRemainingQuantity(), reference.front().second);
+        }
+    }
+}
+
+TEST(OrderQueueTest, LevelsReuseArenaBlocks)
+{
+    OrderPool pool(4096);
+    LevelArena arena(4096);
+    const size_t reserved = arena.Capacity();
+
+    // One level grows 8 -> 1024 (2040 entries carved), hands its outgrown
+    // blocks back, and others of up to 512 entries are built from those.
+    std::vector<OrderQueue> levels(4);
+    OrderId id = 1;
+    for (int i = 0; i < 1000; ++i)
+        levels[0].PushBack(pool, arena, NewOrder(pool, id++, 1));
+    for (size_t level = 1; level < levels.size(); ++level)
+        for (int i = 0; i < 300; ++i)
+            levels[level].PushBack(pool, arena, NewOrder(pool, id++, 1));
+
+    EXPECT_EQ(arena.Capacity(), reserved);
+    EXPECT_EQ(levels[0].Size(), 1000u);
+    EXPECT_EQ(Ids(levels[2], pool).front(), 1301u);
+}
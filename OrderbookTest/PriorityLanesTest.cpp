@@ -0,0 +1,279 @@
+#include "pch.h"
+
+#include "../Orderbook.h"
+
+#include <random>
+
+namespace
+{
+    void WaitForProcessed(const Orderbook& orderbook, size_t count)
+    {
+        while (orderbook.GetOrdersProcessed() < count)
+            std::this_thread::yield();
+    }
+
+    template<typename Submit>
+    void SubmitUntilAccepted(Submit&& submit)
+    {
+        while (submit() != SubmitResult::Accepted)
+            std::this_thread::yield();
+    }
+
+    Orderbook::Config GatedConfig(bool priorityLanes)
+    {
+        Orderbook::Config config;
+        config.priorityLanes = priorityLanes;
+        config.eventRingCapacity = 1;
+        return config;
+    }
+
+    // Holds the engine inside a batch while `queue` submits, so everything it
+    // sends is drained together afterwards. A consumer that never reads lets
+    // one event into a one-slot ring; the engine then stalls publishing a
+    // trade until the consumer detaches. Returns the requests processed by then.
+    template<typename Queue>
+    size_t SubmitWhileEngineHeld(Orderbook& orderbook, Queue&& queue)
+    {
+        auto& events = orderbook.GetEvents();
+        const auto consumer = events.AddConsumer();
+        const size_t before = orderbook.GetOrdersProcessed();
+
+        // Rests (one delta fills the ring), then trades against it (stalls).
+        EXPECT_EQ(orderbook.AddOrder(OrderType::GoodTillCancel, 900001, Side::Sell, 10, 1), SubmitResult::Accepted);
+        WaitForProcessed(orderbook, before + 1);
+        EXPECT_EQ(orderbook.AddOrder(OrderType::GoodTillCancel, 900002, Side::Buy, 10, 1), SubmitResult::Accepted);
+        while (orderbook.GetEventStalls() == 0)
+            std::this_thread::yield();
+
+        const size_t submitted = queue();
+        events.RemoveConsumer(consumer);
+        return before + 2 + submitted;
+    }
+
+    size_t RestingAt(const Orderbook& orderbook, Side side, Price price)
+    {
+        const auto infos = orderbook.GetOrderInfos();
+        for (const auto& level : side == Side::Buy ? infos.GetBids() : infos.GetAsks())
+            if (level.price_ == price)
+                return level.quantity_;
+        return 0;
+    }
+}
+
+TEST(PriorityLanesTest, CancelBeforeAdd)
+{
+    for (const bool lanes : { false, true })
+    {
+        Orderbook orderbook(GatedConfig(lanes));
+        const size_t count = SubmitWhileEngineHeld(orderbook, [&]
+        {
+            EXPECT_EQ(orderbook.AddOrder(OrderType::GoodTillCancel, 1, Side::Buy, 100, 5), SubmitResult::Accepted);
+            EXPECT_EQ(orderbook.CancelOrder(1), SubmitResult::Accepted);
+            return 2;
+        });
+        WaitForProcessed(orderbook, count);
+
+        // Lanes: the cancel overtakes its add, is held, and still removes it.
+        EXPECT_EQ(orderbook.Size(), 0u) << "priorityLanes=" << lanes;
+    }
+}
+
+TEST(PriorityLanesTest, AmendBeforeAdd)
+{
+    for (const bool lanes : { false, true })
+    {
+        Orderbook orderbook(GatedConfig(lanes));
+        const size_t count = SubmitWhileEngineHeld(orderbook, [&]
+        {
+            EXPECT_EQ(orderbook.AddOrder(OrderType::GoodTillCancel, 1, Side::Sell, 500, 5), SubmitResult::Accepted);
+            EXPECT_EQ(orderbook.ModifyOrder(OrderModify{ 1, Side::Sell, 600, 3 }), SubmitResult::Accepted);
+            return 2;
+        });
+        WaitForProcessed(orderbook, count);
+
+        EXPECT_EQ(orderbook.Size(), 1u);
+        EXPECT_EQ(RestingAt(orderbook, Side::Sell, 500), 0u) << "priorityLanes=" << lanes;
+        EXPECT_EQ(RestingAt(orderbook, Side::Sell, 600), 3u) << "priorityLanes=" << lanes;
+    }
+}
+
+TEST(PriorityLanesTest, MassCancelBeforeAdd)
+{
+    for (const bool lanes : { false, true })
+    {
+        Orderbook orderbook(GatedConfig(lanes));
+        const size_t count = SubmitWhileEngineHeld(orderbook, [&]
+        {
+            EXPECT_EQ(orderbook.AddOrder(OrderType::GoodTillCancel, 1, Side::Buy, 100, 5, 7), SubmitResult::Accepted);
+            EXPECT_EQ(orderbook.AddOrder(OrderType::GoodTillCancel, 2, Side::Buy, 101, 5, 8), SubmitResult::Accepted);
+            EXPECT_EQ(orderbook.MassCancel({ .owner = 7 }), SubmitResult::Accepted);
+            return 3;
+        });
+        WaitForProcessed(orderbook, count);
+
+        EXPECT_EQ(orderbook.Size(), 1u) << "priorityLanes=" << lanes;
+        EXPECT_EQ(RestingAt(orderbook, Side::Buy, 101), 5u);
+    }
+}
+
+TEST(PriorityLanesTest, CancelOvertakesQueuedAdds)
+{
+    for (const bool lanes : { false, true })
+    {
+        Orderbook orderbook(GatedConfig(lanes));
+        ASSERT_EQ(orderbook.AddOrder(OrderType::GoodTillCancel, 1, Side::Sell, 100, 1), SubmitResult::Accepted);
+        WaitForProcessed(orderbook, 1);
+
+        const size_t count = SubmitWhileEngineHeld(orderbook, [&]
+        {
+            EXPECT_EQ(orderbook.AddOrder(OrderType::GoodTillCancel, 2, Side::Buy, 100, 1), SubmitResult::Accepted);
+            EXPECT_EQ(orderbook.CancelOrder(1), SubmitResult::Accepted);
+            return 2;
+        });
+        WaitForProcessed(orderbook, count);
+
+        // FIFO: the buy fills the quote first. Lanes: the quote is pulled first
+        // and the buy rests.
+        EXPECT_EQ(orderbook.GetTradesExecuted(), lanes ? 1u : 2u) << "priorityLanes=" << lanes;
+        EXPECT_EQ(RestingAt(orderbook, Side::Buy, 100), lanes ? 1u : 0u) << "priorityLanes=" << lanes;
+    }
+}
+
+TEST(PriorityLanesTest, HeldMassCancelCoversOnlyEarlierAdds)
+{
+    Orderbook orderbook(GatedConfig(true));
+    const size_t count = SubmitWhileEngineHeld(orderbook, [&]
+    {
+        EXPECT_EQ(orderbook.AddOrder(OrderType::GoodTillCancel, 1, Side::Buy, 100, 5, 7), SubmitResult::Accepted);
+        EXPECT_EQ(orderbook.AddOrder(OrderType::GoodTillCancel, 2, Side::Sell, 300, 5, 7), SubmitResult::Accepted);
+        EXPECT_EQ(orderbook.MassCancel({ .owner = 7, .sells = false }), SubmitResult::Accepted);
+        EXPECT_EQ(orderbook.AddOrder(OrderType::GoodTillCancel, 3, Side::Buy, 101, 5, 7), SubmitResult::Accepted);
+        return 4;
+    });
+    WaitForProcessed(orderbook, count);
+
+    // Order 1 is covered; 2 is on the wrong side and 3 came after.
+    EXPECT_EQ(orderbook.Size(), 2u);
+    EXPECT_EQ(RestingAt(orderbook, Side::Buy, 100), 0u);
+    EXPECT_EQ(RestingAt(orderbook, Side::Sell, 300), 5u);
+    EXPECT_EQ(RestingAt(orderbook, Side::Buy, 101), 5u);
+}
+
+TEST(PriorityLanesTest, JournalReplayWithLanesOffRebuildsBook)
+{
+    const std::filesystem::path journal = std::filesystem::temp_directory_path() / "priority_lanes_test.journal";
+    OrderbookLevelInfos live{ { }, { } };
+    size_t liveSize = 0;
+
+    {
+        Orderbook::Config config;
+        config.priorityLanes = true;
+        config.journalPath = journal.string();
+        Orderbook orderbook(config);
+
+        std::atomic<size_t> submitted{ 0 };
+        auto run = [&](unsigned seed, OrderId base)
+        {
+            const auto producer = orderbook.RegisterProducer();
+            std::mt19937 rng(seed);
+            for (OrderId i = 1; i <= 20000; ++i)
+            {
+                const unsigned op = rng() % 20;
+                const Side side = rng() % 2 ? Side::Buy : Side::Sell;
+                const Price price = 1000 + rng() % 30;
+                const Quantity quantity = 1 + rng() % 20;
+                const OwnerId owner = 1 + rng() % 4;
+                const OrderId target = base + 1 + rng() % i;
+
+                if (op < 12)
+                    SubmitUntilAccepted([&] { return orderbook.AddOrder(producer, OrderType::GoodTillCancel, base + i, side, price, quantity, owner); });
+                else if (op < 16)
+                    SubmitUntilAccepted([&] { return orderbook.CancelOrder(producer, target); });
+                else if (op < 19)
+                    SubmitUntilAccepted([&] { return orderbook.ModifyOrder(producer, OrderModify{ target, side, price, quantity }); });
+                else
+                    SubmitUntilAccepted([&] { return orderbook.MassCancel(producer, { .owner = owner, .minPrice = price }); });
+                ++submitted;
+            }
+        };
+
+        std::thread first(run, 1, 0);
+        std::thread second(run, 2, 10'000'000);
+        first.join();
+        second.join();
+
+        WaitForProcessed(orderbook, submitted);
+        live = orderbook.GetOrderInfos();
+        liveSize = orderbook.Size();
+    } // Flushes the journal
+
+    // Decode the AsyncJournaler records and replay them in order.
+    std::ifstream file{ journal, std::ios::binary };
+    const std::string bytes{ std::istreambuf_iterator<char>(file), { } };
+    const char* cursor = bytes.data();
+    const char* const end = cursor + bytes.size();
+    auto read = [&]<typename V>(V& value) { std::memcpy(&value, cursor, sizeof(V)); cursor += sizeof(V); };
+
+    Orderbook replay;
+    size_t records = 0;
+    while (cursor < end)
+    {
+        int type;
+        OrderId orderId;
+        read(type);
+        read(orderId);
+
+        switch (static_cast<Orderbook::Request::Type>(type))
+        {
+        case Orderbook::Request::Type::Add:
+        {
+            OrderType orderType;
+            OrderId id;
+            Side side;
+            Price price;
+            Quantity quantity;
+            OwnerId owner;
+            read(orderType); read(id); read(side); read(price); read(quantity); read(owner);
+            SubmitUntilAccepted([&] { return replay.AddOrder(orderType, id, side, price, quantity, owner); });
+            break;
+        }
+        case Orderbook::Request::Type::Cancel:
+            SubmitUntilAccepted([&] { return replay.CancelOrder(orderId); });
+            break;
+        case Orderbook::Request::Type::Modify:
+        {
+            OrderModify modify{ 0, Side::Buy, 0, 0 };
+            read(modify);
+            SubmitUntilAccepted([&] { return replay.ModifyOrder(modify); });
+            break;
+        }
+        case Orderbook::Request::Type::MassCancel:
+        {
+            Orderbook::MassCancelFilter filter;
+            read(filter.owner); read(filter.minPrice); read(filter.maxPrice); read(filter.buys); read(filter.sells);
+            SubmitUntilAccepted([&] { return replay.MassCancel(filter); });
+            break;
+        }
+        }
+        ++records;
+    }
+    ASSERT_EQ(cursor, end);
+    ASSERT_GT(records, 0u);
+    WaitForProcessed(replay, records);
+    std::filesystem::remove(journal);
+
+    const auto rebuilt = replay.GetOrderInfos();
+    EXPECT_EQ(replay.Size(), liveSize);
+    ASSERT_EQ(rebuilt.GetBids().size(), live.GetBids().size());
+    ASSERT_EQ(rebuilt.GetAsks().size(), live.GetAsks().size());
+    for (size_t i = 0; i < live.GetBids().size(); ++i)
+    {
+        EXPECT_EQ(rebuilt.GetBids()[i].price_, live.GetBids()[i].price_);
+        EXPECT_EQ(rebuilt.GetBids()[i].quantity_, live.GetBids()[i].quantity_);
+    }
+    for (size_t i = 0; i < live.GetAsks().size(); ++i)
+    {
+        EXPECT_EQ(rebuilt.GetAsks()[i].price_, live.GetAsks()[i].price_);
+        EXPECT_EQ(rebuilt.GetAsks()[i].quantity_, live.GetAsks()[i].quantity_);
+    }
+}
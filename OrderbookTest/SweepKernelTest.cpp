@@ -0,0 +1,89 @@
+#include "pch.h"
+
+#include "../SweepKernel.h"
+
+#include <random>
+
+// CountFullyFilled takes the AVX2 path when the tests are built with it
+// (/arch:AVX2 in the project, -mavx2 elsewhere); these compare it with the
+// scalar loop it must match exactly.
+
+namespace
+{
+    void ExpectMatchesScalar(const std::vector<Quantity>& quantities, uint64_t budget)
+    {
+        uint64_t consumed = 0;
+        uint64_t expectedConsumed = 0;
+        const size_t filled = CountFullyFilled(quantities.data(), quantities.size(), budget, consumed);
+        const size_t expected = CountFullyFilledScalar(quantities.data(), quantities.size(), budget, expectedConsumed);
+
+        ASSERT_EQ(filled, expected) << "count=" << quantities.size() << " budget=" << budget;
+        ASSERT_EQ(consumed, expectedConsumed) << "count=" << quantities.size() << " budget=" << budget;
+    }
+}
+
+TEST(SweepKernelTest, Basics)
+{
+    const std::vector<Quantity> quantities{ 3, 0, 2, 5, 1 };
+    uint64_t consumed = 0;
+
+    EXPECT_EQ(CountFullyFilled(quantities.data(), quantities.size(), 0, consumed), 0u);
+    EXPECT_EQ(consumed, 0u);
+    EXPECT_EQ(CountFullyFilled(quantities.data(), quantities.size(), 5, consumed), 3u); // Tombstone is free
+    EXPECT_EQ(consumed, 5u);
+    EXPECT_EQ(CountFullyFilled(quantities.data(), quantities.size(), 9, consumed), 3u);
+    EXPECT_EQ(consumed, 5u);
+    EXPECT_EQ(CountFullyFilled(quantities.data(), quantities.size(), 100, consumed), 5u);
+    EXPECT_EQ(consumed, 11u);
+    EXPECT_EQ(CountFullyFilled(quantities.data(), 0, 100, consumed), 0u);
+}
+
+TEST(SweepKernelTest, MatchesScalarOnRandomLevels)
+{
+    RecordProperty("avx2", SweepKernelUsesAvx2 ? "on" : "off");
+
+    std::mt19937_64 rng(17);
+    for (size_t count = 0; count <= 67; ++count) // Every remainder mod 4
+    {
+        for (int round = 0; round < 200; ++round)
+        {
+            // Mostly small lots, some tombstones, now and then a huge order.
+            std::vector<Quantity> quantities(count);
+            uint64_t total = 0;
+            for (Quantity& quantity : quantities)
+            {
+                const unsigned pick = rng() % 10;
+                quantity = pick < 3 ? 0 : pick < 9 ? static_cast<Quantity>(1 + rng() % 100) : static_cast<Quantity>(rng());
+                total += quantity;
+            }
+
+            // Budgets on, just below and just above every prefix sum, plus
+            // random ones and the extremes.
+            uint64_t prefix = 0;
+            for (const Quantity quantity : quantities)
+            {
+                prefix += quantity;
+                ExpectMatchesScalar(quantities, prefix);
+                ExpectMatchesScalar(quantities, prefix + 1);
+                if (prefix > 0)
+                    ExpectMatchesScalar(quantities, prefix - 1);
+            }
+            ExpectMatchesScalar(quantities, 0);
+            ExpectMatchesScalar(quantities, total == 0 ? 0 : rng() % total);
+            ExpectMatchesScalar(quantities, UINT64_MAX);
+        }
+    }
+}
+
+TEST(SweepKernelTest, LargeQuantitiesDoNotWrap)
+{
+    // Sums past 2^32 (and a budget past INT64_MAX) stay exact in 64-bit lanes.
+    const std::vector<Quantity> quantities(13, UINT32_MAX);
+    for (size_t count = 0; count <= quantities.size(); ++count)
+    {
+        const std::vector<Quantity> level(quantities.begin(), quantities.begin() + count);
+        ExpectMatchesScalar(level, uint64_t{ UINT32_MAX } * 5);
+        ExpectMatchesScalar(level, uint64_t{ UINT32_MAX } * 5 - 1);
+        ExpectMatchesScalar(level, UINT64_MAX);
+    }
+}
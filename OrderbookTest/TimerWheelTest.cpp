@@ -0,0 +1,170 @@
+#include "pch.h"
+
+#include "../TimerWheel.h"
+
+#include <map>
+#include <random>
+
+namespace
+{
+    constexpr uint64_t Tick = 1000;
+}
+
+TEST(TimerWheelTest, FiresAtDeadlineNeverEarly)
+{
+    TimerWheel<int> wheel(Tick, 0);
+    wheel.Schedule(5 * Tick + 1, 1); // Rounds up to tick 6
+
+    std::vector<int> fired;
+    auto collect = [&](int payload) { fired.push_back(payload); };
+
+    EXPECT_EQ(wheel.Advance(6 * Tick - 1, 100, collect), 0u);
+    EXPECT_EQ(wheel.Advance(6 * Tick, 100, collect), 1u);
+    EXPECT_EQ(fired, std::vector<int>{ 1 });
+    EXPECT_TRUE(wheel.IsEmpty());
+}
+
+TEST(TimerWheelTest, CancelIsGenerationChecked)
+{
+    TimerWheel<int> wheel(Tick, 0);
+    const auto first = wheel.Schedule(10 * Tick, 1);
+    EXPECT_TRUE(wheel.Cancel(first));
+    EXPECT_FALSE(wheel.Cancel(first));
+
+    // The freed node is reused; the old handle must not cancel the new timer.
+    const auto second = wheel.Schedule(10 * Tick, 2);
+    EXPECT_EQ(second.Index(), first.Index());
+    EXPECT_FALSE(wheel.Cancel(first));
+    EXPECT_EQ(wheel.Size(), 1u);
+
+    size_t fired = wheel.Advance(10 * Tick, 100, [](int) { });
+    EXPECT_EQ(fired, 1u);
+    EXPECT_FALSE(wheel.Cancel(second)); // Already fired
+}
+
+TEST(TimerWheelTest, BudgetSpreadsMassExpiry)
+{
+    TimerWheel<int> wheel(Tick, 0);
+    for (int i = 0; i < 1000; ++i)
+        wheel.Schedule(50 * Tick, i);
+
+    size_t total = 0;
+    size_t calls = 0;
+    for (size_t fired; (fired = wheel.Advance(50 * Tick, 64, [](int) { })) > 0; ++calls)
+    {
+        EXPECT_LE(fired, 64u);
+        total += fired;
+    }
+    EXPECT_EQ(total, 1000u);
+    EXPECT_EQ(calls, 16u);
+}
+
+TEST(TimerWheelTest, FiresInTickOrderAcrossLevels)
+{
+    TimerWheel<uint64_t> wheel(Tick, 0);
+    std::mt19937_64 rng(3);
+    std::multimap<uint64_t, uint64_t> expected; // Tick -> payload
+
+    // Deadlines up to ~2^26 ticks out, so timers start in every level but the
+    // top one and cascade down.
+    for (uint64_t i = 0; i < 5000; ++i)
+    {
+        const uint64_t deadline = rng() % (Tick << 26);
+        wheel.Schedule(deadline, deadline);
+        expected.emplace((deadline + Tick - 1) / Tick, deadline);
+    }
+
+    uint64_t now = 0;
+    uint64_t lastTick = 0;
+    size_t fired = 0;
+    while (!wheel.IsEmpty())
+    {
+        now += rng() % (Tick << 16);
+        wheel.Advance(now, SIZE_MAX, [&](uint64_t deadline)
+        {
+            EXPECT_LE(deadline, now);
+            const uint64_t tick = (deadline + Tick - 1) / Tick;
+            EXPECT_GE(tick, lastTick);
+            lastTick = tick;
+            ++fired;
+        });
+
+        // Nothing due at `now` may be left behind.
+        if (!wheel.IsEmpty())
+        {
+            EXPECT_GT(wheel.NextDeadlineNs(), now - now % Tick);
+        }
+    }
+    EXPECT_EQ(fired, expected.size());
+}
+
+TEST(TimerWheelTest, NextDeadlineIsNeverLate)
+{
+    TimerWheel<uint64_t> wheel(Tick, 0);
+    EXPECT_EQ(wheel.NextDeadlineNs(), UINT64_MAX);
+
+    // Level 0: the exact tick.
+    wheel.Schedule(7 * Tick, 7);
+    EXPECT_EQ(wheel.NextDeadlineNs(), 7 * Tick);
+
+    // Overdue timers report a time that is already due.
+    wheel.Schedule(0, 0);
+    EXPECT_EQ(wheel.NextDeadlineNs(), 0u);
+    wheel.Advance(0, SIZE_MAX, [](uint64_t) { });
+    EXPECT_EQ(wheel.NextDeadlineNs(), 7 * Tick);
+    wheel.Advance(7 * Tick, SIZE_MAX, [](uint64_t) { });
+    EXPECT_EQ(wheel.NextDeadlineNs(), UINT64_MAX);
+
+    // Higher levels: a lower bound, and sleeping to each reported time in
+    // turn reaches the real deadline without passing it.
+    std::mt19937_64 rng(5);
+    for (int round = 0; round < 200; ++round)
+    {
+        uint64_t now = rng() % (Tick << 20);
+        TimerWheel<uint64_t> fresh(Tick, now);
+        const uint64_t deadline = now + rng() % (Tick << (round % 2 ? 30 : 12));
+        fresh.Schedule(deadline, deadline);
+
+        bool done = false;
+        for (int wakes = 0; !done; ++wakes)
+        {
+            ASSERT_LT(wakes, 16);
+            const uint64_t next = fresh.NextDeadlineNs();
+            ASSERT_LE(next, (deadline + Tick - 1) / Tick * Tick);
+            now = std::max(now, next);
+            fresh.Advance(now, SIZE_MAX, [&](uint64_t) { done = true; });
+        }
+        EXPECT_TRUE(fresh.IsEmpty());
+    }
+}
+
+TEST(TimerWheelTest, ParksTimersBeyondTheTopLevel)
+{
+    TimerWheel<int> wheel(1, 0);
+    const uint64_t far = (uint64_t{ 1 } << 32) + 12345;
+    wheel.Schedule(far, 1);
+    EXPECT_LE(wheel.NextDeadlineNs(), far);
+
+    int fired = 0;
+    wheel.Advance(far - 1, SIZE_MAX, [&](int) { ++fired; });
+    EXPECT_EQ(fired, 0);
+    wheel.Advance(far, SIZE_MAX, [&](int) { ++fired; });
+    EXPECT_EQ(fired, 1);
+}
+
+TEST(TimerWheelTest, ReservedSlabDoesNotGrow)
+{
+    TimerWheel<int> wheel(Tick, 0, 1000);
+    const size_t capacity = wheel.Capacity();
+    ASSERT_GE(capacity, 1000u);
+
+    // Fill, drain and refill: freed nodes are reused before the slab grows.
+    for (int round = 0; round < 2; ++round)
+    {
+        const uint64_t start = 300 * Tick * round;
+        for (int i = 0; i < 1000; ++i)
+            wheel.Schedule(start + (1 + i % 300) * Tick, i);
+        EXPECT_EQ(wheel.Advance(start + 300 * Tick, SIZE_MAX, [](int) { }), 1000u);
+    }
+    EXPECT_EQ(wheel.Capacity(), capacity);
+}
@@ -0,0 +1,44 @@
+#include "pch.h"
+
+#include "../TscClock.h"
+
+TEST(TscClockTest, NowNsIsMonotonic)
+{
+    uint64_t last = TscClock::NowNs();
+    for (int i = 0; i < 1'000'000; ++i)
+    {
+        const uint64_t now = TscClock::NowNs();
+        ASSERT_GE(now, last);
+        last = now;
+    }
+}
+
+TEST(TscClockTest, ConversionStaysMonotonicAcrossRecalibrate)
+{
+    uint64_t last = 0;
+    for (int round = 0; round < 200; ++round)
+    {
+        // A counter read before the refit, converted on both sides of it.
+        const uint64_t before = TscClock::Cycles();
+        const uint64_t beforeNs = TscClock::ToMonotonicNs(before);
+        ASSERT_GE(beforeNs, last);
+
+        const uint64_t refits = TscClock::GetCalibration().refits;
+        TscClock::Recalibrate();
+        const uint64_t after = TscClock::Cycles();
+        const uint64_t afterNs = TscClock::ToMonotonicNs(after);
+
+        const uint64_t beforeNsNow = TscClock::ToMonotonicNs(before);
+        EXPECT_LE(beforeNsNow, afterNs) << "round " << round;
+        EXPECT_LE(beforeNs, afterNs) << "round " << round;
+        if (TscClock::GetCalibration().refits == refits + 1) // No background refit in between
+        {
+            EXPECT_EQ(beforeNsNow, beforeNs) << "round " << round;
+        }
+
+        // The mapping itself is monotonic on both sides of the new base.
+        EXPECT_LE(TscClock::ToMonotonicNs(before - 1000), beforeNsNow);
+        EXPECT_LE(TscClock::ToMonotonicNs(after - 1), afterNs);
+        last = afterNs;
+    }
+}
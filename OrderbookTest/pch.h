@@ -6,6 +6,7 @@
 
 #include "gtest/gtest.h"
 
+#include <charconv>
 #include <filesystem>
 #include <iostream>
 #include <fstream>
@@ -216,16 +216,6 @@ TEST_P(OrderbookTestsFixture, OrderbookTestSuite)
     InputHandler handler;
     const auto [actions, result] = handler.GetInformations(file);
 
-    auto GetOrder = [](const Information& action)
-    {
-        return std::make_shared<Order>(
-            action.orderType_,
-            action.orderId_,
-            action.side_,
-            action.price_,
-            action.quantity_);
-    };
-
     auto GetOrderModify = [](const Information& action)
     {
         return OrderModify
@@ -241,28 +231,28 @@ TEST_P(OrderbookTestsFixture, OrderbookTestSuite)
     Orderbook orderbook;
     for (const auto& action : actions)
     {
+        SubmitResult submitted = SubmitResult::Accepted;
         switch (action.type_)
         {
         case ActionType::Add:
-        {
-            const Trades& trades = orderbook.AddOrder(GetOrder(action));
-        }
-        break;
+            submitted = orderbook.AddOrder(action.orderType_, action.orderId_, action.side_, action.price_, action.quantity_);
+            break;
         case ActionType::Modify:
-        {
-            const Trades& trades = orderbook.ModifyOrder(GetOrderModify(action));
-        }
-        break;
+            submitted = orderbook.ModifyOrder(GetOrderModify(action));
+            break;
         case ActionType::Cancel:
-        {
-            orderbook.CancelOrder(action.orderId_);
-        }
-        break;
+            submitted = orderbook.CancelOrder(action.orderId_);
+            break;
         default:
             throw std::logic_error("Unsupported Action.");
         }
+        ASSERT_EQ(submitted, SubmitResult::Accepted);
     }
 
+    // Requests are applied by the engine thread; wait for it to catch up.
+    while (orderbook.GetOrdersProcessed() < actions.size())
+        std::this_thread::yield();
+
     // Assert
     const auto& orderbookInfos = orderbook.GetOrderInfos();
     ASSERT_EQ(orderbook.Size(), result.allCount_);
@@ -16,6 +16,7 @@
 
 #include "Usings.h"
 #include "SharedMemoryMetrics.h"
+#include "TscClock.h"
 
 /**
  * Hardware Performance Monitor Integration (PAPI/PMU)
@@ -702,7 +703,7 @@ public:
         monitor_->ResetMetrics();
         monitor_->StartMonitoring();
         
-        auto start_time = std::chrono::high_resolution_clock::now();
+        const uint64_t start_cycles = TscClock::CyclesOrdered();
         
         for (uint64_t i = 0; i < measurement_iterations_; ++i)
         {
@@ -710,12 +711,12 @@ public:
             monitor_->RecordTradeProcessed();
         }
         
-        auto end_time = std::chrono::high_resolution_clock::now();
+        const uint64_t end_cycles = TscClock::CyclesOrdered();
         
         monitor_->StopMonitoring();
         
         // Calculate results
-        result.duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time);
+        result.duration = std::chrono::nanoseconds(TscClock::ToNs(end_cycles - start_cycles));
         result.iterations = measurement_iterations_;
         result.nanoseconds_per_iteration = static_cast<double>(result.duration.count()) / measurement_iterations_;
         result.performance_snapshot = monitor_->GetSnapshot();
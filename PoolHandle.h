@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+// Reference to a slot in an ObjectPool slab.
+// The low bits index the slot, the high bits carry the slot's generation at the
+// time it was acquired. Releasing a slot bumps its generation, so a handle that
+// outlives its object is detected as stale instead of keeping the object alive.
+// A slot whose generation would wrap is retired rather than reused, so a stale
+// handle can never alias a later object in its slot.
+template<typename Storage, std::uint32_t IndexBitsV>
+class BasicPoolHandle
+{
+public:
+    static_assert(std::is_unsigned_v<Storage>, "Handle storage must be an unsigned integer");
+    static_assert(IndexBitsV > 0 && IndexBitsV <= 32 && sizeof(Storage) * 8 - IndexBitsV <= 32,
+        "Index and generation must each fit in 32 bits");
+
+    using ValueType = Storage;
+
+    static constexpr std::uint32_t IndexBits = IndexBitsV;
+    static constexpr std::uint32_t GenerationBits = sizeof(Storage) * 8 - IndexBits;
+    static constexpr Storage IndexMask = (Storage{ 1 } << IndexBits) - 1;
+    static constexpr Storage GenerationMask = (Storage{ 1 } << GenerationBits) - 1;
+    static constexpr std::uint32_t MaxSlots = static_cast<std::uint32_t>(IndexMask); // All-ones index is reserved for Invalid
+    static constexpr std::uint32_t MaxGeneration = static_cast<std::uint32_t>(GenerationMask); // Never issued: marks a retired slot
+
+    constexpr BasicPoolHandle() = default;
+
+    constexpr BasicPoolHandle(std::uint32_t index, std::uint32_t generation)
+        : value_{ static_cast<Storage>((index & IndexMask) | ((generation & GenerationMask) << IndexBits)) }
+    { }
+
+    static constexpr BasicPoolHandle Invalid() { return BasicPoolHandle{}; }
+    static constexpr BasicPoolHandle FromValue(Storage value) { BasicPoolHandle handle; handle.value_ = value; return handle; }
+
+    constexpr std::uint32_t Index() const { return static_cast<std::uint32_t>(value_ & IndexMask); }
+    constexpr std::uint32_t Generation() const { return static_cast<std::uint32_t>(value_ >> IndexBits); }
+    constexpr Storage Value() const { return value_; }
+    constexpr bool IsValid() const { return value_ != InvalidValue; }
+
+    constexpr bool operator==(const BasicPoolHandle&) const = default;
+
+private:
+    static constexpr Storage InvalidValue = static_cast<Storage>(~Storage{ 0 });
+
+    Storage value_{ InvalidValue };
+};
+
+// 32 index bits (4G slots) and 32 generation bits (4G reuses of a slot
+// before it is retired).
+using PoolHandle = BasicPoolHandle<std::uint64_t, 32>;
+
+static_assert(sizeof(PoolHandle) == 8, "PoolHandle must stay one word");
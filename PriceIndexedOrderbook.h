@@ -5,12 +5,14 @@
 #include <vector>
 #include <algorithm>
 #include <cstring>
-#include <unordered_map>
 
 #include "Usings.h"
 #include "Order.h"
 #include "OrderModify.h"
 #include "OrderbookLevelInfos.h"
+#include "ObjectPool.h"
+#include "FlatOrderMap.h"
+#include "HierarchicalBitmap.h"
 
 /**
  * Price-Indexed Array for O(1) Orderbook Lookup
@@ -21,10 +23,12 @@
  * 
  * Key features:
  * - O(1) price level lookup with direct array indexing
+ * - Occupancy bitmaps for best-price recovery and level walks (no full-ladder scans)
  * - SIMD-optimized bulk operations with AVX-512
  * - Dynamic price range expansion for market volatility
  * - Perfectly deterministic performance characteristics
  * - Cache-friendly memory layout for bulk operations
+ * - Orders held in a handle-addressed slab (no shared_ptr refcounting)
  */
 
 struct alignas(64) PriceLevel
@@ -52,12 +56,17 @@ public:
     static constexpr Price TICK_SIZE = 1;
     static constexpr size_t PRICE_LEVELS = static_cast<size_t>(MAX_PRICE - MIN_PRICE) + 1;
     
-    PriceIndexedOrderbook()
+    // The order index is sized for max_live_orders up front and never rehashes.
+    explicit PriceIndexedOrderbook(size_t order_pool_size = 100000, size_t max_live_orders = 1'000'000)
         : best_bid_price_(0),
           best_ask_price_(MAX_PRICE),
           price_offset_(0),
           min_book_price_(MAX_PRICE),
-          max_book_price_(MIN_PRICE)
+          max_book_price_(MIN_PRICE),
+          bid_bitmap_(PRICE_LEVELS),
+          ask_bitmap_(PRICE_LEVELS),
+          order_pool_(order_pool_size),
+          orders_(max_live_orders)
     {
         for (size_t i = 0; i < PRICE_LEVELS; ++i)
         {
@@ -88,6 +97,10 @@ public:
     [[nodiscard]] Price GetBestBid() const { return best_bid_price_.load(std::memory_order_acquire); }
     [[nodiscard]] Price GetBestAsk() const { return best_ask_price_.load(std::memory_order_acquire); }
     
+    // Number of non-empty levels per side
+    [[nodiscard]] size_t GetBidLevelCount() const { return bid_bitmap_.Count(); }
+    [[nodiscard]] size_t GetAskLevelCount() const { return ask_bitmap_.Count(); }
+    
     [[nodiscard]] std::vector<PriceLevel*> GetBidLevelsAbove(Price price, size_t max_levels = 10)
     {
         std::vector<PriceLevel*> result;
@@ -96,9 +109,9 @@ public:
         size_t start_index = price_to_index(price);
         if (start_index >= PRICE_LEVELS) return result;
         
-        for (size_t i = start_index; i < PRICE_LEVELS && result.size() < max_levels; ++i)
+        for (size_t i = bid_bitmap_.FindNext(start_index); i != HierarchicalBitmap::npos && result.size() < max_levels; i = bid_bitmap_.FindNext(i + 1))
         {
-            if (bid_levels_[i].total_quantity > 0 && bid_levels_[i].order_count > 0)
+            if (bid_levels_[i].order_count > 0)
             {
                 result.push_back(&bid_levels_[i]);
             }
@@ -115,9 +128,9 @@ public:
         size_t end_index = price_to_index(price);
         if (end_index == 0) return result;
         
-        for (size_t idx = end_index; idx-- > 0 && result.size() < max_levels;)
+        for (size_t idx = ask_bitmap_.FindPrev(end_index - 1); idx != HierarchicalBitmap::npos && result.size() < max_levels; idx = prev_index(ask_bitmap_, idx))
         {
-            if (ask_levels_[idx].total_quantity > 0 && ask_levels_[idx].order_count > 0)
+            if (ask_levels_[idx].order_count > 0)
             {
                 result.push_back(&ask_levels_[idx]);
             }
@@ -135,17 +148,10 @@ public:
         Price current_best = best_bid_price_.load(std::memory_order_acquire);
         if (current_best == 0) return snapshot;
         
-        size_t start_index = price_to_index(current_best);
-        size_t count = 0;
-        
-        // Walk down from best bid
-        for (size_t idx = start_index + 1; idx-- > 0 && count < levels;)
+        // Walk down from best bid, visiting occupied levels only
+        for (size_t idx = bid_bitmap_.FindPrev(price_to_index(current_best)); idx != HierarchicalBitmap::npos && snapshot.size() < levels; idx = prev_index(bid_bitmap_, idx))
         {
-            if (bid_levels_[idx].total_quantity > 0)
-            {
-                snapshot.push_back(bid_levels_[idx]);
-                count++;
-            }
+            snapshot.push_back(bid_levels_[idx]);
         }
         
         return snapshot;
@@ -159,91 +165,64 @@ public:
         Price current_best = best_ask_price_.load(std::memory_order_acquire);
         if (current_best >= MAX_PRICE) return snapshot;
         
-        size_t start_index = price_to_index(current_best);
-        size_t count = 0;
-        
-        // Walk up from best ask
-        for (size_t i = start_index; i < PRICE_LEVELS && count < levels; ++i)
+        // Walk up from best ask, visiting occupied levels only
+        for (size_t i = ask_bitmap_.FindNext(price_to_index(current_best)); i != HierarchicalBitmap::npos && snapshot.size() < levels; i = ask_bitmap_.FindNext(i + 1))
         {
-            if (ask_levels_[i].total_quantity > 0)
-            {
-                snapshot.push_back(ask_levels_[i]);
-                count++;
-            }
+            snapshot.push_back(ask_levels_[i]);
         }
         
         return snapshot;
     }
     
     // Update price level (called when orders are added/cancelled)
-    void UpdateBidLevel(Price price, int64_t delta_quantity, int32_t delta_count)
+    template<Side S>
+    void UpdateLevel(Price price, int64_t delta_quantity, int32_t delta_count)
     {
         size_t index = price_to_index(price);
         if (index >= PRICE_LEVELS) return;
         
-        auto& level = bid_levels_[index];
+        auto& level = levels_of<S>()[index];
         const int64_t next_total = static_cast<int64_t>(level.total_quantity) + delta_quantity;
         const int64_t next_count = static_cast<int64_t>(level.order_count) + static_cast<int64_t>(delta_count);
         
         level.total_quantity = static_cast<Quantity>(std::max<int64_t>(0, next_total));
         level.order_count = static_cast<uint32_t>(std::max<int64_t>(0, next_count));
+        set_occupied(bitmap_of<S>(), index, level.total_quantity > 0);
         
-        // Update best bid if necessary
-        if (delta_quantity > 0 && price > best_bid_price_.load(std::memory_order_acquire))
+        // Update best price if necessary
+        auto& best = best_of<S>();
+        if (delta_quantity > 0 && SideTraits<S>::IsBetter(price, best.load(std::memory_order_acquire)))
         {
-            best_bid_price_.store(price, std::memory_order_release);
+            best.store(price, std::memory_order_release);
         }
-        else if (delta_quantity < 0 && price == best_bid_price_.load(std::memory_order_acquire) && level.total_quantity == 0)
+        else if (delta_quantity < 0 && price == best.load(std::memory_order_acquire) && level.total_quantity == 0)
         {
-            // Need to find new best bid
-            update_best_bid();
+            // Need to find new best price
+            update_best<S>();
         }
     }
     
+    void UpdateBidLevel(Price price, int64_t delta_quantity, int32_t delta_count)
+    {
+        UpdateLevel<Side::Buy>(price, delta_quantity, delta_count);
+    }
+    
     void UpdateAskLevel(Price price, int64_t delta_quantity, int32_t delta_count)
     {
-        size_t index = price_to_index(price);
-        if (index >= PRICE_LEVELS) return;
-        
-        auto& level = ask_levels_[index];
-        const int64_t next_total = static_cast<int64_t>(level.total_quantity) + delta_quantity;
-        const int64_t next_count = static_cast<int64_t>(level.order_count) + static_cast<int64_t>(delta_count);
-        
-        level.total_quantity = static_cast<Quantity>(std::max<int64_t>(0, next_total));
-        level.order_count = static_cast<uint32_t>(std::max<int64_t>(0, next_count));
-        
-        // Update best ask if necessary
-        if (delta_quantity > 0 && price < best_ask_price_.load(std::memory_order_acquire))
-        {
-            best_ask_price_.store(price, std::memory_order_release);
-        }
-        else if (delta_quantity < 0 && price == best_ask_price_.load(std::memory_order_acquire) && level.total_quantity == 0)
-        {
-            // Need to find new best ask
-            update_best_ask();
-        }
+        UpdateLevel<Side::Sell>(price, delta_quantity, delta_count);
     }
     
     // SIMD-optimized price matching for cross operations
     [[nodiscard]] bool WouldCross(Price aggressive_price, Side side)
     {
-        if (side == Side::Buy)
-        {
-            Price best_ask = best_ask_price_.load(std::memory_order_acquire);
-            return best_ask <= MAX_PRICE && aggressive_price >= best_ask;
-        }
-        else
-        {
-            Price best_bid = best_bid_price_.load(std::memory_order_acquire);
-            return best_bid > 0 && aggressive_price <= best_bid;
-        }
+        return side == Side::Buy ? would_cross<Side::Buy>(aggressive_price) : would_cross<Side::Sell>(aggressive_price);
     }
     
     // Get total market depth at price levels
     [[nodiscard]] Quantity GetTotalBidDepth() const
     {
         Quantity total = 0;
-        for (size_t i = 0; i < PRICE_LEVELS; ++i)
+        for (size_t i = bid_bitmap_.FindFirst(); i != HierarchicalBitmap::npos; i = bid_bitmap_.FindNext(i + 1))
         {
             total += bid_levels_[i].total_quantity;
         }
@@ -253,7 +232,7 @@ public:
     [[nodiscard]] Quantity GetTotalAskDepth() const
     {
         Quantity total = 0;
-        for (size_t i = 0; i < PRICE_LEVELS; ++i)
+        for (size_t i = ask_bitmap_.FindFirst(); i != HierarchicalBitmap::npos; i = ask_bitmap_.FindNext(i + 1))
         {
             total += ask_levels_[i].total_quantity;
         }
@@ -274,141 +253,179 @@ private:
         return MIN_PRICE + static_cast<Price>(index * TICK_SIZE);
     }
     
+    static void set_occupied(HierarchicalBitmap& bitmap, size_t index, bool occupied)
+    {
+        if (occupied) bitmap.Set(index);
+        else bitmap.Clear(index);
+    }
+    
+    // The one runtime branch on side per book update.
+    void update_level(Side side, Price price, int64_t delta_quantity, int32_t delta_count)
+    {
+        if (side == Side::Buy) UpdateLevel<Side::Buy>(price, delta_quantity, delta_count);
+        else UpdateLevel<Side::Sell>(price, delta_quantity, delta_count);
+    }
+    
+    // Per-side members, selected at compile time.
+    template<Side S>
+    [[nodiscard]] auto& levels_of()
+    {
+        if constexpr (S == Side::Buy) return bid_levels_;
+        else return ask_levels_;
+    }
+    
+    template<Side S>
+    [[nodiscard]] HierarchicalBitmap& bitmap_of()
+    {
+        if constexpr (S == Side::Buy) return bid_bitmap_;
+        else return ask_bitmap_;
+    }
+    
+    template<Side S>
+    [[nodiscard]] std::atomic<Price>& best_of()
+    {
+        if constexpr (S == Side::Buy) return best_bid_price_;
+        else return best_ask_price_;
+    }
+    
+    // Best price of an empty side: 0 for bids, MAX_PRICE for asks.
+    template<Side S>
+    [[nodiscard]] static constexpr Price empty_best()
+    {
+        return S == Side::Buy ? 0 : MAX_PRICE;
+    }
+    
+    template<Side S>
+    [[nodiscard]] bool would_cross(Price aggressive_price)
+    {
+        constexpr Side opposite = SideTraits<S>::Opposite;
+        const Price best = best_of<opposite>().load(std::memory_order_acquire);
+        return best != empty_best<opposite>() && SideTraits<S>::Crosses(aggressive_price, best);
+    }
+    
+    // Next occupied index strictly below `index`, or npos.
+    [[nodiscard]] static size_t prev_index(const HierarchicalBitmap& bitmap, size_t index)
+    {
+        return index == 0 ? HierarchicalBitmap::npos : bitmap.FindPrev(index - 1);
+    }
+    
 public:
-    void AddOrder(const OrderPointer& order)
+    // Producer side: take a slab slot for a new order (thread-safe, see ObjectPool).
+    [[nodiscard]] OrderHandle AcquireOrder(OrderType type, OrderId orderId, Side side, Price price, Quantity quantity)
+    {
+        const OrderHandle handle = order_pool_.Acquire();
+        order_pool_[handle].Reset(type, orderId, side, price, quantity);
+        order_pool_.ColdOf(handle) = OrderDetails{ .initialQuantity = quantity };
+        return handle;
+    }
+    
+    // Returns an order that was acquired but never added (e.g. rejected by risk).
+    void ReleaseOrder(OrderHandle handle)
+    {
+        order_pool_.Release(handle);
+    }
+    
+    // nullptr if the handle is stale (its slot has been released and possibly reused).
+    [[nodiscard]] const Order* GetOrder(OrderHandle handle) const
+    {
+        return order_pool_.Get(handle);
+    }
+    
+    // Takes ownership of the slot; duplicates, and orders that find the index
+    // full (max_live_orders), are released.
+    void AddOrder(OrderHandle handle)
     {
+        const Order* order = order_pool_.Get(handle);
         if (!order) return;
         
-        const auto id = order->GetOrderId();
-        if (orders_.contains(id)) return;
-        
-        orders_.emplace(id, order);
-        
-        if (order->GetSide() == Side::Buy)
+        if (!orders_.Insert(order->GetOrderId(), handle))
         {
-            UpdateBidLevel(order->GetPrice(), static_cast<int64_t>(order->GetRemainingQuantity()), 1);
-        }
-        else
-        {
-            UpdateAskLevel(order->GetPrice(), static_cast<int64_t>(order->GetRemainingQuantity()), 1);
+            order_pool_.Release(handle);
+            return;
         }
+        
+        update_level(order->GetSide(), order->GetPrice(), static_cast<int64_t>(order->GetRemainingQuantity()), 1);
     }
     
-    void CancelOrder(OrderId orderId)
+    // False if the order is not resting.
+    bool CancelOrder(OrderId orderId)
     {
-        auto it = orders_.find(orderId);
-        if (it == orders_.end()) return;
+        const auto handle = orders_.Extract(orderId);
+        if (!handle) return false;
         
-        const auto& order = it->second;
-        if (order)
-        {
-            if (order->GetSide() == Side::Buy)
-            {
-                UpdateBidLevel(order->GetPrice(), -static_cast<int64_t>(order->GetRemainingQuantity()), -1);
-            }
-            else
-            {
-                UpdateAskLevel(order->GetPrice(), -static_cast<int64_t>(order->GetRemainingQuantity()), -1);
-            }
-        }
+        const auto& order = order_pool_[*handle];
+        update_level(order.GetSide(), order.GetPrice(), -static_cast<int64_t>(order.GetRemainingQuantity()), -1);
         
-        orders_.erase(it);
+        order_pool_.Release(*handle);
+        return true;
     }
     
     void ModifyOrder(const OrderModify& modify)
     {
-        auto it = orders_.find(modify.GetOrderId());
-        if (it == orders_.end()) return;
+        const OrderHandle* handle = orders_.Find(modify.GetOrderId());
+        if (!handle) return;
         
-        const auto& existing = it->second;
-        if (!existing) return;
+        Order* existing = &order_pool_[*handle];
         
-        const auto old_remaining = existing->GetRemainingQuantity();
-        const auto old_price = existing->GetPrice();
-        const auto old_side = existing->GetSide();
-        
-        if (old_side == Side::Buy)
-        {
-            UpdateBidLevel(old_price, -static_cast<int64_t>(old_remaining), -1);
-        }
-        else
-        {
-            UpdateAskLevel(old_price, -static_cast<int64_t>(old_remaining), -1);
-        }
+        update_level(existing->GetSide(), existing->GetPrice(), -static_cast<int64_t>(existing->GetRemainingQuantity()), -1);
         
         existing->Reset(existing->GetOrderType(), existing->GetOrderId(), modify.GetSide(), modify.GetPrice(), modify.GetQuantity());
         
-        if (modify.GetSide() == Side::Buy)
+        update_level(modify.GetSide(), modify.GetPrice(), static_cast<int64_t>(existing->GetRemainingQuantity()), 1);
+    }
+    
+    // Visits up to maxLevels occupied levels of one side, best first:
+    // func(price, total_quantity, order_count).
+    template<typename Func>
+    void ForEachLevel(Side side, size_t maxLevels, Func&& func) const
+    {
+        size_t visited = 0;
+        if (side == Side::Buy)
         {
-            UpdateBidLevel(modify.GetPrice(), static_cast<int64_t>(existing->GetRemainingQuantity()), 1);
+            for (size_t idx = bid_bitmap_.FindLast(); idx != HierarchicalBitmap::npos && visited < maxLevels; idx = prev_index(bid_bitmap_, idx), ++visited)
+                func(bid_levels_[idx].price, bid_levels_[idx].total_quantity, bid_levels_[idx].order_count);
         }
         else
         {
-            UpdateAskLevel(modify.GetPrice(), static_cast<int64_t>(existing->GetRemainingQuantity()), 1);
+            for (size_t idx = ask_bitmap_.FindFirst(); idx != HierarchicalBitmap::npos && visited < maxLevels; idx = ask_bitmap_.FindNext(idx + 1), ++visited)
+                func(ask_levels_[idx].price, ask_levels_[idx].total_quantity, ask_levels_[idx].order_count);
         }
     }
     
+    // Walks the live arrays: engine thread only. Other threads read a
+    // DepthSnapshot published by the engine instead.
     [[nodiscard]] OrderbookLevelInfos GetOrderInfos() const
     {
         LevelInfos bids;
         LevelInfos asks;
         
-        bids.reserve(64);
-        asks.reserve(64);
+        bids.reserve(bid_bitmap_.Count());
+        asks.reserve(ask_bitmap_.Count());
         
-        const auto best_bid = best_bid_price_.load(std::memory_order_acquire);
-        if (best_bid > 0)
+        for (size_t idx = bid_bitmap_.FindLast(); idx != HierarchicalBitmap::npos; idx = prev_index(bid_bitmap_, idx))
         {
-            const auto start_idx = price_to_index(best_bid);
-            for (size_t idx = start_idx + 1; idx-- > 0;)
-            {
-                const auto& level = bid_levels_[idx];
-                if (level.total_quantity == 0) continue;
-                bids.push_back(LevelInfo{level.price, level.total_quantity});
-            }
+            const auto& level = bid_levels_[idx];
+            bids.push_back(LevelInfo{level.price, level.total_quantity});
         }
         
-        const auto best_ask = best_ask_price_.load(std::memory_order_acquire);
-        if (best_ask < MAX_PRICE)
+        for (size_t idx = ask_bitmap_.FindFirst(); idx != HierarchicalBitmap::npos; idx = ask_bitmap_.FindNext(idx + 1))
         {
-            const auto start_idx = price_to_index(best_ask);
-            for (size_t idx = start_idx; idx < PRICE_LEVELS; ++idx)
-            {
-                const auto& level = ask_levels_[idx];
-                if (level.total_quantity == 0) continue;
-                asks.push_back(LevelInfo{level.price, level.total_quantity});
-            }
+            const auto& level = ask_levels_[idx];
+            asks.push_back(LevelInfo{level.price, level.total_quantity});
         }
         
         return OrderbookLevelInfos{bids, asks};
     }
     
-    void update_best_bid()
-    {
-        Price new_best = 0;
-        for (int i = PRICE_LEVELS - 1; i >= 0; --i)
-        {
-            if (bid_levels_[i].total_quantity > 0)
-            {
-                new_best = bid_levels_[i].price;
-                break;
-            }
-        }
-        best_bid_price_.store(new_best, std::memory_order_release);
-    }
+    void update_best_bid() { update_best<Side::Buy>(); }
+    void update_best_ask() { update_best<Side::Sell>(); }
     
-    void update_best_ask()
+    template<Side S>
+    void update_best()
     {
-        Price new_best = MAX_PRICE;
-        for (size_t i = 0; i < PRICE_LEVELS; ++i)
-        {
-            if (ask_levels_[i].total_quantity > 0)
-            {
-                new_best = ask_levels_[i].price;
-                break;
-            }
-        }
-        best_ask_price_.store(new_best, std::memory_order_release);
+        const size_t idx = S == Side::Buy ? bitmap_of<S>().FindLast() : bitmap_of<S>().FindFirst();
+        const Price new_best = idx == HierarchicalBitmap::npos ? empty_best<S>() : levels_of<S>()[idx].price;
+        best_of<S>().store(new_best, std::memory_order_release);
     }
 
 private:
@@ -425,5 +442,10 @@ private:
     [[maybe_unused]] Price min_book_price_;
     [[maybe_unused]] Price max_book_price_;
     
-    std::unordered_map<OrderId, OrderPointer> orders_;
+    // One bit per non-empty level (total_quantity > 0)
+    HierarchicalBitmap bid_bitmap_;
+    HierarchicalBitmap ask_bitmap_;
+    
+    SharedOrderPool order_pool_; // Producers acquire, the engine releases
+    FlatOrderMap<OrderHandle> orders_;
 };
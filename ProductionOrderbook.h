@@ -9,6 +9,7 @@
 #include <unordered_map>
 #include <iostream>
 #include <algorithm>
+#include <type_traits>
 
 #include <pthread.h>
 #include <sched.h>
@@ -19,6 +20,11 @@
 #include "OrderbookLevelInfos.h"
 #include "Trade.h"
 #include "LockFreeQueue.h"
+#include "SubmitResult.h"
+#include "WaitStrategy.h"
+#include "TscClock.h"
+#include "TimerWheel.h"
+#include "DepthSnapshot.h"
 #include "ObjectPool.h"
 #include "RiskManager.h"
 #include "PriceIndexedOrderbook.h"
@@ -46,22 +52,38 @@
 class ProductionOrderbook
 {
 public:
-    struct alignas(64) Request
+    // Fixed-size record, written straight into the ring slot by the producer.
+    // Add and Modify carry their fields inline; an advanced order crosses as a
+    // boxed shared_ptr that the engine takes ownership of.
+    struct alignas(32) Request
     {
-        enum class Type { Add, Cancel, Modify, Advanced };
+        enum class Type : uint8_t { Add, Cancel, Modify, Advanced };
+        struct OrderFields { Price price; Quantity quantity; };
+
+        uint64_t timestamp; // For latency tracking
+        OrderId orderId;
+        union
+        {
+            OrderFields order;                          // Add, Modify
+            std::shared_ptr<AdvancedOrder>* advanced;   // Advanced
+        };
         Type type;
-        OrderPointer order{ nullptr };
-        OrderId orderId{ 0 };
-        OrderModify modify{ 0, Side::Buy, 0, 0 };
-        std::shared_ptr<AdvancedOrder> advanced_order{ nullptr };
-        uint64_t timestamp{ 0 }; // For latency tracking
+        uint8_t side;
+        uint8_t orderType;
+
+        Side GetSide() const { return static_cast<Side>(side); }
+        OrderType GetOrderType() const { return static_cast<OrderType>(orderType); }
     };
+    static_assert(sizeof(Request) == 32 && std::is_trivially_copyable_v<Request>,
+        "ProductionOrderbook::Request is copied through the ring as raw bytes");
     
     struct EngineConfig
     {
         // Core configuration
         size_t object_pool_size = 100000;
+        size_t max_live_orders = 1000000;    // Resting orders the book can hold; sizes the order index
         size_t request_queue_size = 65536;
+        size_t credit_window = 0;    // Most requests queued at once before Throttled; 0 = the whole queue
         int cpu_affinity = 7; // CPU core for engine thread
         
         // Journaling configuration
@@ -87,6 +109,10 @@ public:
         bool enable_simd = true;
         bool enable_prefetching = true;
         size_t prefetch_distance = 4;
+        WaitStrategy::Config engine_wait{}; // Idle behaviour of the engine thread
+        uint64_t timer_tick_ns = 1'000'000;  // GTD expiry resolution
+        size_t expiry_batch = 256;            // Max expiries per engine loop iteration
+        size_t snapshot_depth = 10;           // Levels per side in the published depth snapshot
         
         // Risk management
         bool enable_risk_management = true;
@@ -97,13 +123,16 @@ public:
     
     explicit ProductionOrderbook(const EngineConfig& config)
         : config_(config),
-          price_indexed_book_(),
+          price_indexed_book_(config.object_pool_size, config.max_live_orders),
           journaler_(nullptr),
           ingress_(nullptr),
           metrics_(config.enable_metrics ? std::make_unique<SharedMemoryMetrics>(config.metrics_shm_name) : nullptr),
           validator_(config.validate_system_config ? std::make_unique<SystemValidator>() : nullptr),
           risk_manager_(config.enable_risk_management ? std::make_unique<RiskManager>() : nullptr),
           request_queue_(config.request_queue_size),
+          engine_wait_(config.engine_wait),
+          expiry_timers_(config.timer_tick_ns, TscClock::WallNs(), config.max_live_orders), // One timer per resting GTD order
+          depth_snapshot_(config.snapshot_depth),
           shutdown_(false),
           orders_processed_(0),
           engine_thread_(nullptr)
@@ -115,40 +144,101 @@ public:
     ~ProductionOrderbook()
     {
         Shutdown();
+
+        // Advanced orders the engine never got to still own their box.
+        Request req;
+        while (request_queue_.Pop(req))
+            if (req.type == Request::Type::Advanced)
+                delete req.advanced;
     }
     
     // Order submission methods
-    void AddOrder(OrderPointer order)
+    [[nodiscard]] OrderHandle AcquireOrder(OrderType type, OrderId orderId, Side side, Price price, Quantity quantity)
+    {
+        return price_indexed_book_.AcquireOrder(type, orderId, side, price, quantity);
+    }
+    
+    // Returns an order that was acquired but never accepted (e.g. its AddOrder was rejected).
+    void ReleaseOrder(OrderHandle order)
+    {
+        price_indexed_book_.ReleaseOrder(order);
+    }
+    
+    // Submission never blocks: a full queue or a used-up credit window
+    // (EngineConfig::credit_window) is an immediate reject. The order's fields
+    // travel in the request; the engine takes a slab slot only once it passes
+    // the risk check.
+    SubmitResult AddOrder(OrderType type, OrderId orderId, Side side, Price price, Quantity quantity)
+    {
+        return submit_request(Request::Type::Add, [&](Request& slot)
+        {
+            encode_order(slot, orderId, side, price, quantity);
+            slot.orderType = static_cast<uint8_t>(type);
+        });
+    }
+    
+    // The handle is released once the request is accepted; a rejected
+    // AddOrder(OrderHandle) leaves it with the caller.
+    SubmitResult AddOrder(OrderHandle order)
+    {
+        const Order* o = price_indexed_book_.GetOrder(order);
+        const SubmitResult result = AddOrder(o->GetOrderType(), o->GetOrderId(), o->GetSide(),
+                                             o->GetPrice(), o->GetRemainingQuantity());
+        if (result == SubmitResult::Accepted)
+            ReleaseOrder(order);
+        return result;
+    }
+    
+    SubmitResult AddOrder(const OrderPointer& order)
     {
-        submit_request(Request{Request::Type::Add, order, 0, {0, Side::Buy, 0, 0}, nullptr, 
-                              now_ns()});
+        return AddOrder(order->GetOrderType(), order->GetOrderId(), order->GetSide(),
+                        order->GetPrice(), order->GetRemainingQuantity());
     }
     
-    void AddAdvancedOrder(std::shared_ptr<AdvancedOrder> advanced_order)
+    SubmitResult AddAdvancedOrder(std::shared_ptr<AdvancedOrder> advanced_order)
     {
-        submit_request(Request{Request::Type::Advanced, nullptr, 0, {0, Side::Buy, 0, 0}, advanced_order,
-                              now_ns()});
+        // Boxed so the request stays trivially copyable; the engine unboxes it.
+        auto box = std::make_unique<std::shared_ptr<AdvancedOrder>>(std::move(advanced_order));
+        const SubmitResult result = submit_request(Request::Type::Advanced, [&](Request& slot)
+        {
+            slot.orderId = 0;
+            slot.advanced = box.get();
+        });
+        if (result == SubmitResult::Accepted)
+            box.release();
+        return result;
     }
     
-    void CancelOrder(OrderId orderId)
+    SubmitResult CancelOrder(OrderId orderId)
     {
-        submit_request(Request{Request::Type::Cancel, nullptr, orderId, {0, Side::Buy, 0, 0}, nullptr,
-                              now_ns()});
+        return submit_request(Request::Type::Cancel, [&](Request& slot)
+        {
+            slot.orderId = orderId;
+        });
     }
     
-    void ModifyOrder(OrderId orderId, Side side, Price price, Quantity quantity)
+    SubmitResult ModifyOrder(OrderId orderId, Side side, Price price, Quantity quantity)
     {
-        submit_request(Request{Request::Type::Modify, nullptr, orderId, 
-                              {orderId, side, price, quantity}, nullptr,
-                              now_ns()});
+        return submit_request(Request::Type::Modify, [&](Request& slot)
+        {
+            encode_order(slot, orderId, side, price, quantity);
+        });
     }
     
     // Market data access
+    // Full walk of the live book; races with the engine thread while it runs.
     [[nodiscard]] OrderbookLevelInfos GetOrderInfos() const
     {
         return price_indexed_book_.GetOrderInfos();
     }
     
+    // Consistent best snapshot_depth levels per side as of the engine's last
+    // batch. Lock-free and safe from any thread; reuse `view` to avoid allocating.
+    void ReadDepth(DepthView& view) const
+    {
+        depth_snapshot_.Read(view);
+    }
+    
     [[nodiscard]] Price GetBestBid() const
     {
         return price_indexed_book_.GetBestBid();
@@ -179,6 +269,7 @@ public:
     void Shutdown()
     {
         shutdown_.store(true, std::memory_order_release);
+        engine_wait_.Notify();
         if (engine_thread_ && engine_thread_->joinable())
         {
             engine_thread_->join();
@@ -188,9 +279,7 @@ public:
 private:
     static uint64_t now_ns()
     {
-        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
-            std::chrono::high_resolution_clock::now().time_since_epoch()).count();
-        return static_cast<uint64_t>(std::max<long long>(0, ns));
+        return TscClock::NowNs();
     }
     
     void initialize_system()
@@ -268,21 +357,58 @@ private:
         pthread_setschedparam(engine_thread_->native_handle(), SCHED_FIFO, &param);
     }
     
-    void submit_request(const Request& request)
+    static void encode_order(Request& slot, OrderId orderId, Side side, Price price, Quantity quantity)
+    {
+        slot.orderId = orderId;
+        slot.order = { price, quantity };
+        slot.side = static_cast<uint8_t>(side);
+    }
+    
+    // Single producer. Credits come back as the engine drains the queue, and
+    // the queue's depth is only re-read once they run out (the engine publishes
+    // it to the metrics). encode(Request&) fills the request in its ring slot.
+    template<typename Encode>
+    SubmitResult submit_request(Request::Type type, Encode&& encode)
     {
-        if (!request_queue_.Push(request))
+        const size_t slots = request_queue_.Capacity();
+        const size_t window = config_.credit_window == 0 ? slots : std::min(config_.credit_window, slots);
+        
+        SubmitResult result = SubmitResult::Accepted;
+        if (requests_sent_ == credit_limit_ && !refill_credits(window))
+            result = window < slots ? SubmitResult::Throttled : SubmitResult::QueueFull;
+        else if (const auto slot = request_queue_.TryClaim(1); !slot.IsEmpty())
         {
-            if (metrics_) metrics_->IncrementOrdersRejected(1);
-            std::cerr << "Request queue full - dropping request" << std::endl;
+            slot[0].type = type;
+            encode(slot[0]);
+            slot[0].timestamp = now_ns();
+            request_queue_.Commit(1);
+            ++requests_sent_;
         }
         else
+            result = SubmitResult::QueueFull;
+        
+        if (result != SubmitResult::Accepted)
         {
-            if (metrics_) 
+            if (metrics_)
             {
-                metrics_->IncrementOrdersReceived(1);
-                metrics_->UpdateQueueDepth(request_queue_.Size());
+                metrics_->IncrementOrdersRejected(1);
+                if (result == SubmitResult::Throttled) metrics_->IncrementQueueThrottled(1);
+                else metrics_->IncrementQueueDrops(1);
             }
+            return result;
         }
+        
+        engine_wait_.Notify();
+        if (metrics_) metrics_->IncrementOrdersReceived(1);
+        return result;
+    }
+    
+    // Producer: takes back the credits the engine has returned since the last
+    // refill. False if the queue still holds a full window.
+    bool refill_credits(size_t window)
+    {
+        credit_limit_ = requests_sent_ - request_queue_.Size() + window;
+        return credit_limit_ != requests_sent_;
     }
     
     void engine_loop()
@@ -291,51 +417,58 @@ private:
         
         while (!shutdown_.load(std::memory_order_acquire))
         {
-            // Process requests
-            Request req;
-            size_t processed_count = 0;
+            // Process requests where they sit in the ring (batch processing limit: 1000)
+            const auto batch = request_queue_.PeekBatch(1000);
+            const size_t processed_count = batch.Size();
             
-            while (request_queue_.Pop(req))
+            // Depth as the engine found it: this batch and whatever is behind it.
+            if (metrics_ && processed_count > 0)
+                metrics_->UpdateQueueDepth(request_queue_.Size());
+            
+            for (size_t i = 0; i < processed_count; ++i)
             {
-                const auto request_start = std::chrono::high_resolution_clock::now();
+                const Request& req = batch[i];
+                const uint64_t request_start = now_ns();
                 
                 // Record latency from submission
-                uint64_t submission_latency = 
-                    std::chrono::duration_cast<std::chrono::nanoseconds>(
-                        request_start.time_since_epoch()).count() - req.timestamp;
+                const uint64_t submission_latency =
+                    request_start > req.timestamp ? request_start - req.timestamp : 0;
                 
                 // Process request
                 switch (req.type)
                 {
                     case Request::Type::Add:
-                        ProcessAddOrder(req.order);
+                        ProcessNewOrder(req);
                         break;
                     case Request::Type::Cancel:
                         ProcessCancelOrder(req.orderId);
                         break;
                     case Request::Type::Modify:
-                        ProcessModifyOrder(req.modify);
+                        ProcessModifyOrder(OrderModify{ req.orderId, req.GetSide(), req.order.price, req.order.quantity });
                         break;
                     case Request::Type::Advanced:
-                        ProcessAdvancedOrder(req.advanced_order);
+                    {
+                        const std::unique_ptr<std::shared_ptr<AdvancedOrder>> box{ req.advanced };
+                        ProcessAdvancedOrder(std::move(*box));
                         break;
+                    }
                 }
                 
                 // Update metrics
                 if (metrics_)
                 {
-                    auto processing_latency = std::chrono::duration_cast<std::chrono::nanoseconds>(
-                        std::chrono::high_resolution_clock::now() - request_start).count();
+                    const uint64_t processing_latency = now_ns() - request_start;
                     
                     metrics_->RecordLatency(submission_latency + processing_latency);
                     metrics_->IncrementOrdersProcessed(1);
                 }
                 
                 orders_processed_.fetch_add(1, std::memory_order_relaxed);
-                processed_count++;
-                
-                // Batch processing limit
-                if (processed_count >= 1000) break;
+            }
+            
+            if (processed_count > 0)
+            {
+                request_queue_.Release(processed_count);
             }
             
             // Update metrics periodically
@@ -346,35 +479,78 @@ private:
                 last_metrics_update = now;
             }
             
-            // Small yield if no work
-            if (processed_count == 0)
+            const size_t expired = expire_orders();
+            const bool expiry_backlog = expired == std::max<size_t>(1, config_.expiry_batch);
+            
+            if (processed_count > 0 || expired > 0)
+            {
+                publish_depth_snapshot();
+            }
+            
+            if (processed_count == 0 && !expiry_backlog)
+            {
+                // Ends by the next GTD expiry, so a quiet book still expires on time.
+                engine_wait_.Idle([this] {
+                    return shutdown_.load(std::memory_order_relaxed) || !request_queue_.IsEmpty();
+                }, next_expiry_wait());
+            }
+            else
+            {
+                engine_wait_.OnWork();
+            }
+        }
+    }
+    
+    // Add request from a client: risk-checked on the request's fields, so a
+    // rejected order never touches the slab.
+    void ProcessNewOrder(const Request& req)
+    {
+        if (risk_manager_)
+        {
+            auto result = risk_manager_->CheckOrder(req.GetOrderType(), req.order.price, req.order.quantity);
+            if (result != RiskManager::Result::Allowed)
             {
-                std::this_thread::yield();
+                if (metrics_) metrics_->IncrementOrdersRejected(1);
+                return;
             }
         }
+        
+        add_checked_order(price_indexed_book_.AcquireOrder(
+            req.GetOrderType(), req.orderId, req.GetSide(), req.order.price, req.order.quantity));
     }
     
-    void ProcessAddOrder(OrderPointer order)
+    void ProcessAddOrder(OrderHandle handle)
     {
+        const Order* order = price_indexed_book_.GetOrder(handle);
+        if (!order) return;
+        
         // Risk check
         if (risk_manager_)
         {
-            auto result = risk_manager_->CheckOrder(order);
+            auto result = risk_manager_->CheckOrder(*order);
             if (result != RiskManager::Result::Allowed)
             {
                 if (metrics_) metrics_->IncrementOrdersRejected(1);
+                price_indexed_book_.ReleaseOrder(handle);
                 return;
             }
         }
         
+        add_checked_order(handle);
+    }
+    
+    void add_checked_order(OrderHandle handle)
+    {
+        const Order* order = price_indexed_book_.GetOrder(handle);
+        
         // Journal the event
         if (journaler_)
         {
-            journaler_->Log(order);
+            journaler_->Log(*order);
         }
         
         // Add to price-indexed orderbook
-        price_indexed_book_.AddOrder(order);
+        price_indexed_book_.AddOrder(handle);
         
         // Update best prices in metrics
         if (metrics_)
@@ -408,7 +584,7 @@ private:
                 break;
             default:
                 // Convert to regular order for now
-                ProcessAddOrder(std::make_shared<Order>(
+                ProcessAddOrder(price_indexed_book_.AcquireOrder(
                     OrderType::GoodTillCancel,
                     advanced_order->order_id,
                     advanced_order->side,
@@ -421,7 +597,7 @@ private:
     void ProcessIcebergOrder(std::shared_ptr<AdvancedOrder> iceberg_order)
     {
         // Simplified iceberg processing - show visible portion
-        auto visible_order = std::make_shared<Order>(
+        auto visible_order = price_indexed_book_.AcquireOrder(
             OrderType::GoodTillCancel,
             iceberg_order->order_id,
             iceberg_order->side,
@@ -441,7 +617,7 @@ private:
         hidden_orders_[hidden_order->order_id] = hidden_order;
         
         // Still process for matching but don't show in orderbook
-        auto hidden_regular = std::make_shared<Order>(
+        auto hidden_regular = price_indexed_book_.AcquireOrder(
             OrderType::GoodTillCancel,
             hidden_order->order_id,
             hidden_order->side,
@@ -476,11 +652,18 @@ private:
             return;
         }
         
-        // Store for expiration monitoring
-        gtd_orders_[gtd_order->order_id] = gtd_order;
+        // Expires through the cancel path (see expire_orders)
+        TimerWheel<OrderId>::Handle timer{};
+        if (const auto* gtd = std::get_if<GTDOrderData>(&gtd_order->advanced_data))
+        {
+            const auto expiry_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                gtd->expiry_time.time_since_epoch()).count();
+            timer = expiry_timers_.Schedule(static_cast<uint64_t>(std::max<int64_t>(0, expiry_ns)), gtd_order->order_id);
+        }
+        gtd_orders_[gtd_order->order_id] = GtdEntry{gtd_order, timer};
         
         // Process as regular order
-        auto gtd_regular = std::make_shared<Order>(
+        auto gtd_regular = price_indexed_book_.AcquireOrder(
             OrderType::GoodTillCancel,
             gtd_order->order_id,
             gtd_order->side,
@@ -491,16 +674,71 @@ private:
         ProcessAddOrder(gtd_regular);
     }
     
-    void ProcessCancelOrder(OrderId orderId)
+    void ProcessCancelOrder(OrderId orderId, OrderCancelled::Reason reason = OrderCancelled::Reason::Client)
     {
         // Remove from all order types
         iceberg_orders_.erase(orderId);
         hidden_orders_.erase(orderId);
         stop_orders_.erase(orderId);
-        gtd_orders_.erase(orderId);
+        if (auto gtd = gtd_orders_.find(orderId); gtd != gtd_orders_.end())
+        {
+            expiry_timers_.Cancel(gtd->second.timer);
+            gtd_orders_.erase(gtd);
+        }
         
         // Cancel in main orderbook
-        price_indexed_book_.CancelOrder(orderId);
+        if (!price_indexed_book_.CancelOrder(orderId))
+            return;
+        
+        if (journaler_)
+        {
+            journaler_->Log(OrderCancelled{orderId, reason});
+        }
+        
+        if (metrics_)
+        {
+            metrics_->UpdateBestPrices(
+                price_indexed_book_.GetBestBid(),
+                price_indexed_book_.GetBestAsk()
+            );
+        }
+    }
+    
+    // Runs at most expiry_batch due GTD expiries; returns how many ran.
+    size_t expire_orders()
+    {
+        if (expiry_timers_.IsEmpty()) return 0;
+        
+        const size_t budget = std::max<size_t>(1, config_.expiry_batch);
+        return expiry_timers_.Advance(TscClock::WallNs(), budget, [this](OrderId orderId) {
+            ProcessCancelOrder(orderId, OrderCancelled::Reason::Expired);
+        });
+    }
+    
+    // Longest the engine may sleep before expire_orders() has work again.
+    std::chrono::nanoseconds next_expiry_wait() const
+    {
+        if (expiry_timers_.IsEmpty()) return WaitStrategy::NoTimeout;
+        
+        const uint64_t deadline = expiry_timers_.NextDeadlineNs();
+        const uint64_t now = TscClock::WallNs();
+        return std::chrono::nanoseconds(deadline > now ? std::min<uint64_t>(deadline - now, INT64_MAX) : 0);
+    }
+    
+    void publish_depth_snapshot()
+    {
+        const size_t depth = depth_snapshot_.Depth();
+        size_t bids = 0;
+        size_t asks = 0;
+        
+        depth_snapshot_.BeginWrite();
+        price_indexed_book_.ForEachLevel(Side::Buy, depth, [&](Price price, Quantity quantity, uint32_t orders) {
+            depth_snapshot_.SetBid(bids++, DepthLevel{price, orders, quantity});
+        });
+        price_indexed_book_.ForEachLevel(Side::Sell, depth, [&](Price price, Quantity quantity, uint32_t orders) {
+            depth_snapshot_.SetAsk(asks++, DepthLevel{price, orders, quantity});
+        });
+        depth_snapshot_.EndWrite(bids, asks, now_ns());
     }
     
     void ProcessModifyOrder(const OrderModify& modify)
@@ -511,7 +749,7 @@ private:
     void TriggerStopOrder(std::shared_ptr<AdvancedOrder> stop_order)
     {
         // Convert stop order to market order
-        auto market_order = std::make_shared<Order>(
+        auto market_order = price_indexed_book_.AcquireOrder(
             OrderType::Market,
             stop_order->order_id,
             stop_order->side,
@@ -534,19 +772,14 @@ private:
         metrics_->UpdateUptime(static_cast<uint64_t>(std::max<int64_t>(0, uptime)));
         metrics_->UpdateHeartbeat();
         
-        // Update market depth
-        size_t bid_levels = 0, ask_levels = 0;
-        for (size_t i = 0; i < PriceIndexedOrderbook::PRICE_LEVELS; ++i)
-        {
-            if (price_indexed_book_.GetBidLevel(static_cast<Price>(i)) &&
-                price_indexed_book_.GetBidLevel(static_cast<Price>(i))->total_quantity > 0)
-                bid_levels++;
-            if (price_indexed_book_.GetAskLevel(static_cast<Price>(i)) &&
-                price_indexed_book_.GetAskLevel(static_cast<Price>(i))->total_quantity > 0)
-                ask_levels++;
-        }
+        const auto wait = engine_wait_.GetStats();
+        metrics_->UpdateEngineWait(wait.idleNs, wait.blockedNs, wait.wakeups, wait.maxWakeupLatencyNs);
         
-        metrics_->UpdateMarketDepth(bid_levels, ask_levels);
+        const auto snapshot = depth_snapshot_.GetStats();
+        metrics_->UpdateDepthSnapshot(snapshot.publishes, snapshot.reads, snapshot.retries);
+        
+        // Update market depth (level counts are maintained by the occupancy bitmaps)
+        metrics_->UpdateMarketDepth(price_indexed_book_.GetBidLevelCount(), price_indexed_book_.GetAskLevelCount());
         
         // Update memory usage (simplified)
         metrics_->UpdateMemoryUsage(
@@ -571,6 +804,11 @@ private:
     
     // Order management
     LockFreeQueue<Request> request_queue_;
+    uint64_t requests_sent_{0};  // Producer only
+    uint64_t credit_limit_{0};   // requests_sent_ may reach this before the depth is re-read
+    WaitStrategy engine_wait_;
+    TimerWheel<OrderId> expiry_timers_; // GTD deadlines (wall clock); engine thread only
+    DepthSnapshot depth_snapshot_;       // Written by the engine thread after each batch
     std::atomic<bool> shutdown_;
     std::atomic<uint64_t> orders_processed_;
     std::unique_ptr<std::thread> engine_thread_;
@@ -580,5 +818,10 @@ private:
     std::unordered_map<OrderId, std::shared_ptr<AdvancedOrder>> iceberg_orders_;
     std::unordered_map<OrderId, std::shared_ptr<AdvancedOrder>> hidden_orders_;
     std::unordered_map<OrderId, std::shared_ptr<AdvancedOrder>> stop_orders_;
-    std::unordered_map<OrderId, std::shared_ptr<AdvancedOrder>> gtd_orders_;
+    struct GtdEntry
+    {
+        std::shared_ptr<AdvancedOrder> order;
+        TimerWheel<OrderId>::Handle timer;
+    };
+    std::unordered_map<OrderId, GtdEntry> gtd_orders_;
 };
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// A run of consecutive slots of a power-of-two ring, starting at a
+// free-running index; indexing wraps at the end of the buffer.
+template<typename T>
+class RingSpan
+{
+public:
+    RingSpan() = default;
+    RingSpan(T* buffer, size_t mask, uint64_t start, size_t count)
+        : buffer_{ buffer }, mask_{ mask }, start_{ start }, count_{ count }
+    { }
+
+    T& operator[](size_t i) const { return buffer_[(start_ + i) & mask_]; }
+    size_t Size() const { return count_; }
+    bool IsEmpty() const { return count_ == 0; }
+
+private:
+    T* buffer_{ nullptr };
+    size_t mask_{ 0 };
+    uint64_t start_{ 0 };
+    size_t count_{ 0 };
+};
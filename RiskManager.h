@@ -24,22 +24,34 @@ public:
         RejectedPriceRange,
     };
 
-    Result CheckOrder(const OrderPointer& order) const
+    // Checked on the request's fields, before any Order exists.
+    Result CheckOrder(OrderType type, Price price, Quantity quantity) const
     {
-        if (order->GetInitialQuantity() > config_.maxOrderQuantity)
+        if (quantity > config_.maxOrderQuantity)
             return Result::RejectedMaxQty;
 
         // Market orders might have invalid price (or 0), skip price check for them if needed
         // But for this engine, let's assume even Market orders have some constraints or are converted
-        if (order->GetOrderType() != OrderType::Market)
+        if (type != OrderType::Market)
         {
-            if (order->GetPrice() > config_.maxPrice || order->GetPrice() < config_.minPrice)
+            if (price > config_.maxPrice || price < config_.minPrice)
                 return Result::RejectedPriceRange;
         }
 
         return Result::Allowed;
     }
 
+    Result CheckOrder(const Order& order) const
+    {
+        // Checked before the order rests: remaining is the order quantity.
+        return CheckOrder(order.GetOrderType(), order.GetPrice(), order.GetRemainingQuantity());
+    }
+
+    Result CheckOrder(const OrderPointer& order) const
+    {
+        return CheckOrder(*order);
+    }
+
 private:
     Config config_;
 };
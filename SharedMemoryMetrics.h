@@ -43,7 +43,7 @@ struct alignas(64) SharedMetrics
     
     // Queue metrics
     std::atomic<uint64_t> queue_depth;
-    std::atomic<uint64_t> queue_drops;
+    std::atomic<uint64_t> queue_drops;      // Requests rejected with SubmitResult::QueueFull
     std::atomic<uint64_t> max_queue_depth;
     
     // Latency metrics (nanoseconds)
@@ -78,8 +78,30 @@ struct alignas(64) SharedMetrics
     std::atomic<uint64_t> memory_peak_bytes;
     std::atomic<uint64_t> object_pool_utilization;
     
+    // Engine thread idle behaviour (see WaitStrategy)
+    std::atomic<uint64_t> engine_idle_ns;
+    std::atomic<uint64_t> engine_blocked_ns;
+    std::atomic<uint64_t> engine_wakeups;
+    std::atomic<uint64_t> engine_max_wakeup_latency_ns;
+    
+    // Top-N depth snapshot (see DepthSnapshot)
+    std::atomic<uint64_t> snapshot_publishes;
+    std::atomic<uint64_t> snapshot_reads;
+    std::atomic<uint64_t> snapshot_read_retries;
+    
+    // Requests rejected with SubmitResult::Throttled (see queue_drops)
+    std::atomic<uint64_t> queue_throttled;
+    
+    // Output event ring (see BroadcastRing), one slot per consumer id; a slot
+    // with no consumer attached reads 0.
+    static constexpr size_t MAX_EVENT_CONSUMERS = 8;
+    std::atomic<uint64_t> events_published;
+    std::atomic<uint64_t> event_stalls;
+    std::atomic<uint64_t> event_consumer_lag[MAX_EVENT_CONSUMERS];
+    std::atomic<uint64_t> event_consumer_max_lag[MAX_EVENT_CONSUMERS];
+    
     // Reserved for future expansion
-    std::atomic<uint64_t> reserved[16];
+    std::atomic<uint64_t> reserved[8];
 };
 
 static_assert(alignof(SharedMetrics) == 64, "SharedMetrics must be cache-line aligned");
@@ -200,6 +222,16 @@ public:
         }
     }
     
+    void IncrementQueueDrops(uint64_t count = 1)
+    {
+        if (metrics_) metrics_->queue_drops.fetch_add(count, std::memory_order_relaxed);
+    }
+    
+    void IncrementQueueThrottled(uint64_t count = 1)
+    {
+        if (metrics_) metrics_->queue_throttled.fetch_add(count, std::memory_order_relaxed);
+    }
+    
     void UpdateQueueDepth(uint64_t depth)
     {
         if (metrics_)
@@ -298,6 +330,49 @@ public:
         }
     }
     
+    // idle_ns - blocked_ns is time the engine burned CPU while it had no work.
+    void UpdateEngineWait(uint64_t idle_ns, uint64_t blocked_ns, uint64_t wakeups, uint64_t max_wakeup_latency_ns)
+    {
+        if (metrics_)
+        {
+            metrics_->engine_idle_ns.store(idle_ns, std::memory_order_relaxed);
+            metrics_->engine_blocked_ns.store(blocked_ns, std::memory_order_relaxed);
+            metrics_->engine_wakeups.store(wakeups, std::memory_order_relaxed);
+            metrics_->engine_max_wakeup_latency_ns.store(max_wakeup_latency_ns, std::memory_order_relaxed);
+        }
+    }
+    
+    // snapshot_read_retries / snapshot_reads is the reader retry rate.
+    void UpdateDepthSnapshot(uint64_t publishes, uint64_t reads, uint64_t retries)
+    {
+        if (metrics_)
+        {
+            metrics_->snapshot_publishes.store(publishes, std::memory_order_relaxed);
+            metrics_->snapshot_reads.store(reads, std::memory_order_relaxed);
+            metrics_->snapshot_read_retries.store(retries, std::memory_order_relaxed);
+        }
+    }
+    
+    // event_stalls counts events that waited for the slowest consumer.
+    void UpdateEventRing(uint64_t published, uint64_t stalls)
+    {
+        if (metrics_)
+        {
+            metrics_->events_published.store(published, std::memory_order_relaxed);
+            metrics_->event_stalls.store(stalls, std::memory_order_relaxed);
+        }
+    }
+    
+    // Consumers past MAX_EVENT_CONSUMERS are not exported.
+    void UpdateEventConsumer(size_t consumer, uint64_t lag, uint64_t max_lag)
+    {
+        if (metrics_ && consumer < SharedMetrics::MAX_EVENT_CONSUMERS)
+        {
+            metrics_->event_consumer_lag[consumer].store(lag, std::memory_order_relaxed);
+            metrics_->event_consumer_max_lag[consumer].store(max_lag, std::memory_order_relaxed);
+        }
+    }
+    
     void UpdateHeartbeat()
     {
         if (metrics_)
@@ -325,6 +400,8 @@ public:
         
         uint64_t queue_depth{};
         uint64_t max_queue_depth{};
+        uint64_t queue_drops{};
+        uint64_t queue_throttled{};
         
         Price best_bid_price{};
         Price best_ask_price{};
@@ -340,6 +417,20 @@ public:
         uint64_t memory_used_bytes{};
         uint64_t memory_peak_bytes{};
         uint64_t object_pool_utilization{};
+        
+        uint64_t engine_idle_ns{};
+        uint64_t engine_blocked_ns{};
+        uint64_t engine_wakeups{};
+        uint64_t engine_max_wakeup_latency_ns{};
+        
+        uint64_t snapshot_publishes{};
+        uint64_t snapshot_reads{};
+        uint64_t snapshot_read_retries{};
+        
+        uint64_t events_published{};
+        uint64_t event_stalls{};
+        std::array<uint64_t, SharedMetrics::MAX_EVENT_CONSUMERS> event_consumer_lag{};
+        std::array<uint64_t, SharedMetrics::MAX_EVENT_CONSUMERS> event_consumer_max_lag{};
     };
     
     [[nodiscard]] MetricsSnapshot GetSnapshot() const
@@ -355,6 +446,8 @@ public:
             snapshot.total_notional = metrics_->total_notional.load(std::memory_order_acquire);
             snapshot.queue_depth = metrics_->queue_depth.load(std::memory_order_acquire);
             snapshot.max_queue_depth = metrics_->max_queue_depth.load(std::memory_order_acquire);
+            snapshot.queue_drops = metrics_->queue_drops.load(std::memory_order_acquire);
+            snapshot.queue_throttled = metrics_->queue_throttled.load(std::memory_order_acquire);
             snapshot.best_bid_price = metrics_->best_bid_price.load(std::memory_order_acquire);
             snapshot.best_ask_price = metrics_->best_ask_price.load(std::memory_order_acquire);
             snapshot.best_bid_quantity = metrics_->best_bid_quantity.load(std::memory_order_acquire);
@@ -366,6 +459,20 @@ public:
             snapshot.memory_used_bytes = metrics_->memory_used_bytes.load(std::memory_order_acquire);
             snapshot.memory_peak_bytes = metrics_->memory_peak_bytes.load(std::memory_order_acquire);
             snapshot.object_pool_utilization = metrics_->object_pool_utilization.load(std::memory_order_acquire);
+            snapshot.engine_idle_ns = metrics_->engine_idle_ns.load(std::memory_order_acquire);
+            snapshot.engine_blocked_ns = metrics_->engine_blocked_ns.load(std::memory_order_acquire);
+            snapshot.engine_wakeups = metrics_->engine_wakeups.load(std::memory_order_acquire);
+            snapshot.engine_max_wakeup_latency_ns = metrics_->engine_max_wakeup_latency_ns.load(std::memory_order_acquire);
+            snapshot.snapshot_publishes = metrics_->snapshot_publishes.load(std::memory_order_acquire);
+            snapshot.snapshot_reads = metrics_->snapshot_reads.load(std::memory_order_acquire);
+            snapshot.snapshot_read_retries = metrics_->snapshot_read_retries.load(std::memory_order_acquire);
+            snapshot.events_published = metrics_->events_published.load(std::memory_order_acquire);
+            snapshot.event_stalls = metrics_->event_stalls.load(std::memory_order_acquire);
+            for (size_t i = 0; i < SharedMetrics::MAX_EVENT_CONSUMERS; ++i)
+            {
+                snapshot.event_consumer_lag[i] = metrics_->event_consumer_lag[i].load(std::memory_order_acquire);
+                snapshot.event_consumer_max_lag[i] = metrics_->event_consumer_max_lag[i].load(std::memory_order_acquire);
+            }
         }
         return snapshot;
     }
@@ -416,6 +523,7 @@ public:
             metrics_->total_notional.store(0, std::memory_order_relaxed);
             metrics_->queue_depth.store(0, std::memory_order_relaxed);
             metrics_->queue_drops.store(0, std::memory_order_relaxed);
+            metrics_->queue_throttled.store(0, std::memory_order_relaxed);
             metrics_->max_queue_depth.store(0, std::memory_order_relaxed);
             metrics_->memory_used_bytes.store(0, std::memory_order_relaxed);
             metrics_->memory_peak_bytes.store(0, std::memory_order_relaxed);
@@ -1,8 +1,31 @@
 #pragma once
 
+#include "Usings.h"
+
 enum class Side
 {
     Buy,
     Sell
 };
 
+// Compile-time price ordering of one side, so side-specific code is written
+// once and instantiated per side instead of branching on Side at run time.
+template<Side S>
+struct SideTraits
+{
+    static constexpr Side Opposite = S == Side::Buy ? Side::Sell : Side::Buy;
+
+    // `a` is a better price than `b` for an order on this side (higher bid, lower ask).
+    static constexpr bool IsBetter(Price a, Price b)
+    {
+        if constexpr (S == Side::Buy) return a > b;
+        else return a < b;
+    }
+
+    // An order on this side limited at `limit` trades with a resting order at `price`.
+    static constexpr bool Crosses(Price limit, Price price)
+    {
+        if constexpr (S == Side::Buy) return limit >= price;
+        else return limit <= price;
+    }
+};
@@ -0,0 +1,11 @@
+#pragma once
+
+// Outcome of handing a request to an engine. Submission never blocks: a
+// rejected request was not queued and the caller still owns whatever it passed
+// in (e.g. an OrderHandle), so a gateway can NACK upstream straight away.
+enum class SubmitResult
+{
+    Accepted,
+    QueueFull,      // No free slot left in the producer's queue
+    Throttled,      // The producer has its whole credit window in flight
+};
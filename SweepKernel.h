@@ -0,0 +1,72 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "Usings.h"
+
+// How many leading resting orders an aggressor for `budget` fully consumes:
+// the largest k with quantities[0] + ... + quantities[k-1] <= budget. The sum
+// of those k is returned in `consumed`; quantities[k], if any, is the order
+// the aggressor only partly fills. Zero entries (cancelled slots) are free.
+//
+// Built with AVX2 (-mavx2 / -march=native, /arch:AVX2 in the Visual Studio
+// projects) the prefix sum runs four orders per step, widened to 64-bit lanes
+// so it cannot wrap, and one compare per step finds the crossing; the scalar
+// loop finishes the step that crosses. Otherwise it is the scalar loop.
+#if defined(__AVX2__)
+inline constexpr bool SweepKernelUsesAvx2 = true;
+#else
+inline constexpr bool SweepKernelUsesAvx2 = false;
+#endif
+
+// The scalar loop, resuming at order `i` with `sum` already consumed. Also the
+// reference the AVX2 path is tested against.
+inline size_t CountFullyFilledScalar(const Quantity* quantities, size_t count, uint64_t budget, uint64_t& consumed,
+    size_t i = 0, uint64_t sum = 0)
+{
+    for (; i < count; ++i)
+    {
+        if (sum + quantities[i] > budget)
+            break;
+        sum += quantities[i];
+    }
+
+    consumed = sum;
+    return i;
+}
+
+inline size_t CountFullyFilled(const Quantity* quantities, size_t count, uint64_t budget, uint64_t& consumed)
+{
+    size_t i = 0;
+    uint64_t sum = 0;
+
+#if defined(__AVX2__)
+    // Lane values stay below 2^63, so the signed 64-bit compare is exact.
+    const __m256i limit = _mm256_set1_epi64x(static_cast<long long>(std::min<uint64_t>(budget, INT64_MAX)));
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i base = zero;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256i x = _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(quantities + i)));
+        // [a b c d] -> [a, a+b, b+c, c+d] -> [a, a+b, a+b+c, a+b+c+d]
+        x = _mm256_add_epi64(x, _mm256_blend_epi32(_mm256_permute4x64_epi64(x, 0x90), zero, 0x03));
+        x = _mm256_add_epi64(x, _mm256_blend_epi32(_mm256_permute4x64_epi64(x, 0x40), zero, 0x0F));
+        x = _mm256_add_epi64(x, base);
+
+        if (_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(x, limit))) != 0)
+            break; // Crossing is in this step; the scalar loop pins it down
+
+        base = _mm256_permute4x64_epi64(x, 0xFF);
+    }
+    sum = static_cast<uint64_t>(_mm256_extract_epi64(base, 0));
+#endif
+
+    return CountFullyFilledScalar(quantities, count, budget, consumed, i, sum);
+}
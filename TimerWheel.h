@@ -0,0 +1,318 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "PoolHandle.h"
+
+// Hierarchical hashed timer wheel (Varghese & Lauck), single-threaded.
+//
+// Time is cut into ticks of tickNs. Four levels of 256 slots cover 2^32 ticks
+// (about 49 days at 1 ms); a timer sits in the lowest level whose slot span
+// still contains its deadline and moves down a level each time the wheel
+// reaches that slot (a "cascade"). Timers further out than the top level are
+// parked in the top level and re-filed when it comes round.
+//
+//   Schedule / Cancel - O(1): link / unlink in a doubly linked slot list.
+//   Advance           - fires due timers, at most `budget` per call. A mass
+//                       expiry (e.g. every GoodForDay order at the close) is
+//                       spread over as many calls as it needs; the rest stay
+//                       queued in the current slot.
+//
+// Empty stretches are skipped with per-level occupancy bitmaps, so a wheel
+// that sat idle does not walk every tick it missed.
+//
+// Nodes live in a slab reserved for initialCapacity timers and are referred to
+// by generation-checked PoolHandles, so cancelling a timer that has already
+// fired is a no-op. Past initialCapacity live timers Schedule grows the slab,
+// which copies it: size it for the most timers the owner can hold.
+template<typename T>
+class TimerWheel
+{
+public:
+    using Handle = PoolHandle;
+
+    static constexpr uint32_t SlotBits = 8;
+    static constexpr uint32_t SlotCount = 1u << SlotBits;
+    static constexpr uint32_t SlotMask = SlotCount - 1;
+    static constexpr uint32_t Levels = 4;
+
+    TimerWheel(uint64_t tickNs, uint64_t startNs, size_t initialCapacity = 0)
+        : tickNs_{ tickNs }
+        , current_{ tickNs ? startNs / tickNs : 0 }
+    {
+        if (tickNs == 0)
+            throw std::invalid_argument("TimerWheel tick must be non-zero");
+
+        heads_.fill(Nil);
+        for (auto& level : occupied_)
+            level.fill(0);
+
+        nodes_.reserve(initialCapacity);
+        freeList_.reserve(initialCapacity);
+    }
+
+    // Fires from the first Advance() at or after deadlineNs (past deadlines
+    // fire on the next call).
+    Handle Schedule(uint64_t deadlineNs, const T& payload)
+    {
+        const uint32_t index = AllocateNode();
+        Node& node = nodes_[index];
+        node.payload = payload;
+        node.deadline = deadlineNs / tickNs_ + (deadlineNs % tickNs_ != 0 ? 1 : 0); // Never early
+        node.live = true;
+
+        Insert(index);
+        ++size_;
+        return Handle{ index, node.generation };
+    }
+
+    // False if the timer already fired or was cancelled.
+    bool Cancel(Handle handle)
+    {
+        if (!handle.IsValid() || handle.Index() >= nodes_.size())
+            return false;
+
+        Node& node = nodes_[handle.Index()];
+        if (!node.live || node.generation != handle.Generation())
+            return false;
+
+        Unlink(handle.Index());
+        FreeNode(handle.Index());
+        --size_;
+        return true;
+    }
+
+    // Runs onExpire(payload) for up to `budget` timers due at nowNs, in tick
+    // order (a timer scheduled already overdue counts as due at the tick it was
+    // scheduled in). Returns how many fired; a result equal to `budget` means more may
+    // be due. onExpire may Schedule() or Cancel() on this wheel.
+    template<typename OnExpire>
+    size_t Advance(uint64_t nowNs, size_t budget, OnExpire&& onExpire)
+    {
+        const uint64_t target = nowNs / tickNs_;
+        size_t fired = 0;
+
+        for (;;)
+        {
+            const uint32_t slot = static_cast<uint32_t>(current_ & SlotMask);
+            while (heads_[slot] != Nil)
+            {
+                if (fired == budget)
+                    return fired;
+
+                const uint32_t index = heads_[slot];
+                Unlink(index);
+                const T payload = nodes_[index].payload;
+                FreeNode(index);
+                --size_;
+
+                onExpire(payload);
+                ++fired;
+            }
+
+            if (current_ >= target)
+                return fired;
+
+            if (size_ == 0)
+            {
+                current_ = target;
+                return fired;
+            }
+
+            // Jump to the next occupied slot in this level-0 span, else to the
+            // start of the next span (which cascades the levels above).
+            const uint32_t next = slot + 1 < SlotCount ? NextOccupied(0, slot + 1) : SlotCount;
+            if (next < SlotCount)
+            {
+                current_ = std::min((current_ & ~uint64_t{ SlotMask }) | next, target);
+                continue;
+            }
+
+            const uint64_t spanEnd = current_ | SlotMask;
+            if (spanEnd >= target)
+            {
+                current_ = target;
+                return fired;
+            }
+
+            current_ = spanEnd + 1;
+            Cascade();
+        }
+    }
+
+    // Earliest wall-clock ns at which Advance() may have work: the next due
+    // tick, or for a timer still in a higher level, the start of its slot's
+    // span (where it cascades). Never later than the next deadline, so a
+    // thread that sleeps until then never misses one. UINT64_MAX if empty.
+    uint64_t NextDeadlineNs() const
+    {
+        if (size_ == 0)
+            return UINT64_MAX;
+
+        for (uint32_t level = 0; level < Levels; ++level)
+        {
+            const uint32_t shift = SlotBits * level;
+            const uint32_t index = static_cast<uint32_t>((current_ >> shift) & SlotMask);
+            const uint64_t span = current_ >> (shift + SlotBits) << (shift + SlotBits);
+
+            // Level 0 includes the current slot (overdue timers); higher
+            // levels only hold slots ahead of it.
+            const uint32_t from = level == 0 ? index : index + 1;
+            const uint32_t next = from < SlotCount ? NextOccupied(level, from) : SlotCount;
+            if (next < SlotCount)
+                return TicksToNs(span | (uint64_t{ next } << shift));
+        }
+
+        // Only the top level's wrapped or parked slots are left: they come
+        // round in the next turn of the wheel.
+        const uint32_t top = SlotBits * (Levels - 1);
+        const uint64_t turn = (current_ >> (top + SlotBits)) + 1;
+        return TicksToNs((turn << (top + SlotBits)) | (uint64_t{ NextOccupied(Levels - 1, 0) } << top));
+    }
+
+    size_t Size() const { return size_; }
+    bool IsEmpty() const { return size_ == 0; }
+    size_t Capacity() const { return nodes_.capacity(); } // Timers the slab holds without growing
+    uint64_t TickNs() const { return tickNs_; }
+
+private:
+    static constexpr uint32_t Nil = UINT32_MAX;
+    static constexpr uint32_t Words = SlotCount / 64;
+
+    struct Node
+    {
+        T payload{ };
+        uint64_t deadline{ 0 }; // In ticks
+        uint32_t prev{ Nil };
+        uint32_t next{ Nil };
+        uint16_t slot{ 0 };     // level * SlotCount + slot index
+        uint32_t generation{ 0 };
+        bool live{ false };
+    };
+
+    uint32_t AllocateNode()
+    {
+        if (!freeList_.empty())
+        {
+            const uint32_t index = freeList_.back();
+            freeList_.pop_back();
+            return index;
+        }
+
+        if (nodes_.size() >= PoolHandle::MaxSlots)
+            throw std::length_error("TimerWheel exhausted: no free slots left for handles");
+
+        nodes_.emplace_back();
+        return static_cast<uint32_t>(nodes_.size() - 1);
+    }
+
+    void FreeNode(uint32_t index)
+    {
+        Node& node = nodes_[index];
+        node.live = false;
+        node.generation = (node.generation + 1) & static_cast<uint32_t>(PoolHandle::GenerationMask);
+        freeList_.push_back(index);
+    }
+
+    // File a node under the lowest level whose span around current_ holds its deadline.
+    void Insert(uint32_t index)
+    {
+        Node& node = nodes_[index];
+        const uint64_t tick = std::max(node.deadline, current_);
+
+        uint32_t level = 0;
+        while (level + 1 < Levels && (tick >> (SlotBits * (level + 1))) != (current_ >> (SlotBits * (level + 1))))
+            ++level;
+
+        // Out of range: park in the current top slot, which comes round (and
+        // re-files it) once the wheel has turned fully.
+        const bool beyond = tick - current_ >= (uint64_t{ 1 } << (SlotBits * Levels));
+        const uint64_t position = beyond ? current_ : tick;
+        const uint32_t slot = level * SlotCount + static_cast<uint32_t>((position >> (SlotBits * level)) & SlotMask);
+
+        node.slot = static_cast<uint16_t>(slot);
+        node.prev = Nil;
+        node.next = heads_[slot];
+        if (node.next != Nil)
+            nodes_[node.next].prev = index;
+        heads_[slot] = index;
+        occupied_[level][(slot & SlotMask) / 64] |= uint64_t{ 1 } << (slot & 63);
+    }
+
+    void Unlink(uint32_t index)
+    {
+        Node& node = nodes_[index];
+        if (node.prev != Nil)
+            nodes_[node.prev].next = node.next;
+        else
+            heads_[node.slot] = node.next;
+
+        if (node.next != Nil)
+            nodes_[node.next].prev = node.prev;
+
+        if (heads_[node.slot] == Nil)
+        {
+            const uint32_t level = node.slot / SlotCount;
+            occupied_[level][(node.slot & SlotMask) / 64] &= ~(uint64_t{ 1 } << (node.slot & 63));
+        }
+    }
+
+    // current_ just entered a new level-0 span: re-file the matching slot of
+    // each higher level whose own span also just started.
+    void Cascade()
+    {
+        for (uint32_t level = 1; level < Levels; ++level)
+        {
+            const uint32_t index = static_cast<uint32_t>((current_ >> (SlotBits * level)) & SlotMask);
+            const uint32_t slot = level * SlotCount + index;
+
+            uint32_t node = heads_[slot];
+            heads_[slot] = Nil;
+            occupied_[level][index / 64] &= ~(uint64_t{ 1 } << (index & 63));
+
+            while (node != Nil)
+            {
+                const uint32_t next = nodes_[node].next;
+                Insert(node);
+                node = next;
+            }
+
+            if (index != 0)
+                break;
+        }
+    }
+
+    uint64_t TicksToNs(uint64_t tick) const
+    {
+        return tick > UINT64_MAX / tickNs_ ? UINT64_MAX : tick * tickNs_;
+    }
+
+    uint32_t NextOccupied(uint32_t level, uint32_t from) const
+    {
+        for (uint32_t word = from / 64; word < Words; ++word)
+        {
+            uint64_t bits = occupied_[level][word];
+            if (word == from / 64)
+                bits &= ~uint64_t{ 0 } << (from & 63);
+            if (bits)
+                return word * 64 + static_cast<uint32_t>(std::countr_zero(bits));
+        }
+        return SlotCount;
+    }
+
+    const uint64_t tickNs_;
+    uint64_t current_;          // Tick whose level-0 slot fires next
+    size_t size_{ 0 };
+
+    std::array<uint32_t, Levels * SlotCount> heads_;
+    std::array<std::array<uint64_t, Words>, Levels> occupied_;
+
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> freeList_;
+};
@@ -0,0 +1,383 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
+#if defined(__linux__)
+#include <time.h>
+#endif
+
+// Process-wide clock backed by the invariant TSC.
+//
+// Reading the time is one `rdtsc` plus a fixed-point multiply:
+//
+//   ns = baseNs + ((cycles - baseCycles) * mult) >> 32
+//
+// The (baseCycles, baseNs, mult) triple is calibrated against
+// CLOCK_MONOTONIC_RAW at first use and refitted every second by a background
+// thread. Refits are continuous: the monotonic mapping never steps back, and
+// any drift against the kernel clock is slewed out over the next interval.
+// Counter values from before a refit keep converting with the mapping they
+// were read under, so a timestamp taken just before a refit and converted just
+// after it cannot come out later than one taken after it.
+// Wall-clock time is the monotonic time plus an offset sampled from
+// CLOCK_REALTIME at each refit, so it follows NTP steps.
+//
+// Without an invariant TSC (or off x86) Cycles() is the raw monotonic clock in
+// ns and every conversion is the identity.
+class TscClock
+{
+public:
+    // Raw counter. Cheapest read; use for intervals and convert with ToNs().
+    static uint64_t Cycles()
+    {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+        if (Instance().tscBacked_)
+            return __rdtsc();
+#endif
+        return RawMonotonicNs();
+    }
+
+    // Waits for earlier instructions to retire before reading (rdtscp).
+    static uint64_t CyclesOrdered()
+    {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+        if (Instance().tscBacked_)
+        {
+            unsigned int aux;
+            return __rdtscp(&aux);
+        }
+#endif
+        return RawMonotonicNs();
+    }
+
+    // Nanoseconds on the CLOCK_MONOTONIC_RAW timebase.
+    static uint64_t NowNs() { return ToMonotonicNs(Cycles()); }
+
+    // Nanoseconds since the Unix epoch, for journal and regulatory records.
+    static uint64_t WallNs() { return ToWallNs(Cycles()); }
+
+    // Duration of a cycle interval.
+    static uint64_t ToNs(uint64_t cycles) { return MulShift(cycles, Instance().Load().mult); }
+
+    static uint64_t ToMonotonicNs(uint64_t cycles) { return Convert(Instance().Load(), cycles); }
+
+    static uint64_t ToWallNs(uint64_t cycles)
+    {
+        const Params params = Instance().Load();
+        return Convert(params, cycles) + static_cast<uint64_t>(params.wallOffsetNs);
+    }
+
+    struct Calibration
+    {
+        bool tscBacked;
+        double cyclesPerNs;
+        uint64_t refits;
+        int64_t lastErrorNs;    // Kernel clock minus our clock at the last refit
+    };
+
+    static Calibration GetCalibration()
+    {
+        TscClock& clock = Instance();
+        const Params params = clock.Load();
+        return {
+            clock.tscBacked_,
+            params.mult ? static_cast<double>(uint64_t{ 1 } << 32) / static_cast<double>(params.mult) : 0.0,
+            clock.refits_.load(std::memory_order_relaxed),
+            clock.lastErrorNs_.load(std::memory_order_relaxed),
+        };
+    }
+
+    // Refit now rather than waiting for the background thread.
+    static void Recalibrate() { Instance().Refit(); }
+
+    TscClock(const TscClock&) = delete;
+    TscClock& operator=(const TscClock&) = delete;
+
+private:
+    static constexpr auto RefitInterval = std::chrono::seconds(1);
+    static constexpr auto InitialWindow = std::chrono::milliseconds(10);
+    static constexpr int64_t StepThresholdNs = 1'000'000;  // Larger forward drift is stepped, not slewed
+    static constexpr int64_t MaxSlewPpm = 500;
+
+    struct Params
+    {
+        uint64_t baseCycles;
+        uint64_t baseNs;
+        uint64_t mult;          // ns per cycle, 32.32 fixed point
+        int64_t wallOffsetNs;
+        uint64_t prevBaseCycles; // The mapping before the last refit, for counters behind baseCycles
+        uint64_t prevBaseNs;
+        uint64_t prevMult;
+    };
+
+    struct Sample
+    {
+        uint64_t cycles;
+        uint64_t rawNs;
+        uint64_t wallNs;
+    };
+
+    static TscClock& Instance()
+    {
+        static TscClock clock;
+        return clock;
+    }
+
+    TscClock()
+        : tscBacked_(HasInvariantTsc())
+    {
+        anchor_ = TakeSample();
+        if (tscBacked_)
+            std::this_thread::sleep_for(InitialWindow);
+        const Sample sample = TakeSample();
+
+        const uint64_t mult = tscBacked_ ? Slope(anchor_, sample) : uint64_t{ 1 } << 32;
+        Store({ sample.cycles, sample.rawNs, mult, static_cast<int64_t>(sample.wallNs - sample.rawNs),
+            sample.cycles, sample.rawNs, mult });
+
+        if (tscBacked_)
+            refitThread_ = std::jthread([this](std::stop_token stop) { RefitLoop(stop); });
+    }
+
+    // jthread's destructor stops and joins the refit thread.
+    void RefitLoop(std::stop_token stop)
+    {
+        std::unique_lock lock(refitMutex_);
+        while (!stop.stop_requested())
+        {
+            refitWakeup_.wait_for(lock, stop, RefitInterval, [] { return false; });
+            if (stop.stop_requested())
+                break;
+            lock.unlock();
+            Refit();
+            lock.lock();
+        }
+    }
+
+    void Refit()
+    {
+        std::lock_guard lock(writerMutex_);
+        const Sample sample = TakeSample();
+        const Params old = Load();
+
+        // Continue from where the old mapping is now, so readers never see a jump back.
+        const uint64_t current = Convert(old, sample.cycles);
+        const int64_t error = static_cast<int64_t>(sample.rawNs - current);
+
+        Params next{ sample.cycles, current, old.mult, static_cast<int64_t>(sample.wallNs - sample.rawNs),
+            old.baseCycles, old.baseNs, old.mult };
+        if (tscBacked_)
+        {
+            // Slope over the whole run is the best frequency estimate; then bend it
+            // so the remaining error is gone by the next refit.
+            const uint64_t slope = Slope(anchor_, sample);
+            const int64_t interval = std::chrono::duration_cast<std::chrono::nanoseconds>(RefitInterval).count();
+
+            if (error > StepThresholdNs)
+                next.baseNs = sample.rawNs;
+            else
+            {
+                const int64_t limit = interval / 1'000'000 * MaxSlewPpm;
+                const int64_t slew = std::clamp(error, -limit, limit);
+                next.mult = static_cast<uint64_t>(static_cast<double>(slope) *
+                    static_cast<double>(interval + slew) / static_cast<double>(interval));
+            }
+        }
+        else
+            next.baseNs = std::max(current, sample.rawNs);
+
+        Store(next);
+        lastErrorNs_.store(error, std::memory_order_relaxed);
+        refits_.store(refits_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    // Seqlock read: retry if a refit was in progress or completed meanwhile.
+    Params Load() const
+    {
+        for (;;)
+        {
+            const uint32_t begin = seq_.load(std::memory_order_acquire);
+            if (begin & 1)
+                continue;
+
+            const Params params{
+                baseCycles_.load(std::memory_order_relaxed),
+                baseNs_.load(std::memory_order_relaxed),
+                mult_.load(std::memory_order_relaxed),
+                wallOffsetNs_.load(std::memory_order_relaxed),
+                prevBaseCycles_.load(std::memory_order_relaxed),
+                prevBaseNs_.load(std::memory_order_relaxed),
+                prevMult_.load(std::memory_order_relaxed),
+            };
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq_.load(std::memory_order_relaxed) == begin)
+                return params;
+        }
+    }
+
+    // Caller holds writerMutex_ (or is the constructor).
+    void Store(const Params& params)
+    {
+        const uint32_t seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        baseCycles_.store(params.baseCycles, std::memory_order_relaxed);
+        baseNs_.store(params.baseNs, std::memory_order_relaxed);
+        mult_.store(params.mult, std::memory_order_relaxed);
+        wallOffsetNs_.store(params.wallOffsetNs, std::memory_order_relaxed);
+        prevBaseCycles_.store(params.prevBaseCycles, std::memory_order_relaxed);
+        prevBaseNs_.store(params.prevBaseNs, std::memory_order_relaxed);
+        prevMult_.store(params.prevMult, std::memory_order_relaxed);
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    static uint64_t Convert(const Params& params, uint64_t cycles)
+    {
+        if (cycles >= params.baseCycles)
+            return params.baseNs + MulShift(cycles - params.baseCycles, params.mult);
+
+        // Read before the last refit: keep the mapping it was read under. The
+        // new mult is bent to slew out drift, so running it backwards from the
+        // new base could put an older counter past a newer one. Counters from
+        // before the refit before that extrapolate the same mapping back.
+        const uint64_t ns = cycles >= params.prevBaseCycles
+            ? params.prevBaseNs + MulShift(cycles - params.prevBaseCycles, params.prevMult)
+            : params.prevBaseNs - MulShift(params.prevBaseCycles - cycles, params.prevMult);
+        return std::min(ns, params.baseNs);
+    }
+
+    static uint64_t MulShift(uint64_t value, uint64_t mult)
+    {
+#if defined(_MSC_VER)
+        uint64_t high;
+        const uint64_t low = _umul128(value, mult, &high);
+        return __shiftright128(low, high, 32);
+#else
+        return static_cast<uint64_t>((static_cast<unsigned __int128>(value) * mult) >> 32);
+#endif
+    }
+
+    static uint64_t Slope(const Sample& from, const Sample& to)
+    {
+        const uint64_t cycles = to.cycles - from.cycles;
+        const uint64_t ns = to.rawNs - from.rawNs;
+        if (cycles == 0)
+            return uint64_t{ 1 } << 32;
+#if defined(_MSC_VER)
+        uint64_t remainder;
+        return _udiv128(ns >> 32, ns << 32, cycles, &remainder);
+#else
+        return static_cast<uint64_t>((static_cast<unsigned __int128>(ns) << 32) / cycles);
+#endif
+    }
+
+    // Best of a few reads: the pair bracketed by the shortest kernel-clock window.
+    Sample TakeSample() const
+    {
+        Sample best{};
+        uint64_t bestWindow = UINT64_MAX;
+        for (int i = 0; i < 8; ++i)
+        {
+            const uint64_t before = RawMonotonicNs();
+            const uint64_t cycles = CyclesOrderedUnchecked();
+            const uint64_t after = RawMonotonicNs();
+            const uint64_t wall = RealtimeNs();
+            if (after - before < bestWindow)
+            {
+                bestWindow = after - before;
+                best = { cycles, before + (after - before) / 2, wall };
+            }
+        }
+        return best;
+    }
+
+    uint64_t CyclesOrderedUnchecked() const
+    {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+        if (tscBacked_)
+        {
+            unsigned int aux;
+            return __rdtscp(&aux);
+        }
+#endif
+        return RawMonotonicNs();
+    }
+
+    static bool HasInvariantTsc()
+    {
+#if defined(_MSC_VER) && defined(_M_X64)
+        int regs[4];
+        __cpuid(regs, 0x80000000);
+        if (static_cast<unsigned>(regs[0]) < 0x80000007u)
+            return false;
+        __cpuid(regs, 0x80000007);
+        return (regs[3] & (1 << 8)) != 0;
+#elif defined(__x86_64__) || defined(__i386__)
+        unsigned int eax, ebx, ecx, edx;
+        if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx))
+            return false;
+        return (edx & (1u << 8)) != 0;
+#else
+        return false;
+#endif
+    }
+
+    static uint64_t RawMonotonicNs()
+    {
+#if defined(__linux__)
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000ull + static_cast<uint64_t>(ts.tv_nsec);
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    static uint64_t RealtimeNs()
+    {
+#if defined(__linux__)
+        timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000ull + static_cast<uint64_t>(ts.tv_nsec);
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    const bool tscBacked_;
+    Sample anchor_{};
+
+    // Published mapping, guarded by seq_
+    alignas(64) std::atomic<uint32_t> seq_{ 0 };
+    std::atomic<uint64_t> baseCycles_{ 0 };
+    std::atomic<uint64_t> baseNs_{ 0 };
+    std::atomic<uint64_t> mult_{ 0 };
+    std::atomic<int64_t> wallOffsetNs_{ 0 };
+    std::atomic<uint64_t> prevBaseCycles_{ 0 };
+    std::atomic<uint64_t> prevBaseNs_{ 0 };
+    std::atomic<uint64_t> prevMult_{ 0 };
+
+    alignas(64) std::atomic<uint64_t> refits_{ 0 };
+    std::atomic<int64_t> lastErrorNs_{ 0 };
+
+    std::mutex writerMutex_;
+    std::mutex refitMutex_;
+    std::condition_variable_any refitWakeup_;
+    std::jthread refitThread_;
+};
@@ -5,4 +5,5 @@
 using Price = std::int32_t;
 using Quantity = std::uint32_t;
 using OrderId = std::uint64_t;
+using OwnerId = std::uint32_t; // Trading session / strategy that entered the order
 using OrderIds = std::vector<OrderId>;
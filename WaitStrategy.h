@@ -0,0 +1,265 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+// What a polling thread does when its poll comes back empty.
+//
+//   BusySpin      - `pause` and poll again. Lowest wakeup latency, burns the core.
+//                   For the engine on an isolated core.
+//   SpinThenYield - spin for spinLimit polls, then yield each idle poll.
+//   Backoff       - spin with exponentially growing pause runs, then sleep with
+//                   exponentially growing intervals capped at maxBackoff.
+//   Blocking      - spin for spinLimit polls, then park on a condition
+//                   variable until a producer calls Notify() (or the caller's
+//                   maxWait runs out). Near-zero idle CPU for journal/metrics
+//                   threads.
+enum class WaitPolicy
+{
+    BusySpin,
+    SpinThenYield,
+    Backoff,
+    Blocking,
+};
+
+inline const char* ToString(WaitPolicy policy)
+{
+    switch (policy)
+    {
+    case WaitPolicy::BusySpin: return "BusySpin";
+    case WaitPolicy::SpinThenYield: return "SpinThenYield";
+    case WaitPolicy::Backoff: return "Backoff";
+    case WaitPolicy::Blocking: return "Blocking";
+    }
+    return "Unknown";
+}
+
+// CPU hint for spin loops (x86 `pause`, ARM `yield`).
+inline void CpuRelax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield");
+#endif
+}
+
+// One instance per polling thread (the consumer); any number of producers may
+// call Notify(). Usage in the consumer loop:
+//
+//   if (poll() == 0) wait.Idle([&] { return hasWork(); });
+//   else             wait.OnWork();
+//
+// `hasWork` is re-checked after announcing a park, so a push that races with
+// parking is never lost. Owners must Notify() after setting their stop flag and
+// include that flag in `hasWork`.
+class WaitStrategy
+{
+public:
+    struct Config
+    {
+        WaitPolicy policy = WaitPolicy::SpinThenYield;
+        uint32_t spinLimit = 1024;                          // Idle polls before yielding/sleeping/parking
+        std::chrono::microseconds maxBackoff{ 1000 };       // Backoff sleep cap
+    };
+
+    // Counters are written by the consumer and readable from any thread.
+    struct Stats
+    {
+        uint64_t idleNs;            // Wall time between running out of work and finding more
+        uint64_t blockedNs;         // Part of idleNs spent off-CPU (sleeping or parked)
+        uint64_t idleStreaks;       // Number of times the thread went idle
+        uint64_t parks;             // Parked waits (Blocking) or sleeps (Backoff)
+        uint64_t wakeups;           // Parks ended by a producer Notify()
+        uint64_t maxWakeupLatencyNs; // Notify() to consumer running again
+        uint64_t totalWakeupLatencyNs;
+    };
+
+    WaitStrategy() : WaitStrategy(Config{}) {}
+    explicit WaitStrategy(const Config& config) : config_(config) {}
+
+    WaitPolicy Policy() const { return config_.policy; }
+
+    static constexpr std::chrono::nanoseconds NoTimeout = std::chrono::nanoseconds::max();
+
+    // Consumer: the last poll found nothing. maxWait bounds a Blocking park or
+    // a Backoff sleep, for a caller that also has a deadline to meet (timers)
+    // or waits on something that never calls Notify().
+    template<typename HasWork>
+    void Idle(HasWork&& hasWork, std::chrono::nanoseconds maxWait = NoTimeout)
+    {
+        if (idlePolls_ == 0)
+            idleStart_ = NowNs();
+        if (idlePolls_ != UINT32_MAX)
+            ++idlePolls_;
+
+        switch (config_.policy)
+        {
+        case WaitPolicy::BusySpin:
+            CpuRelax();
+            break;
+
+        case WaitPolicy::SpinThenYield:
+            if (idlePolls_ <= config_.spinLimit) CpuRelax();
+            else std::this_thread::yield();
+            break;
+
+        case WaitPolicy::Backoff:
+            Backoff(maxWait);
+            break;
+
+        case WaitPolicy::Blocking:
+            if (idlePolls_ <= config_.spinLimit) CpuRelax();
+            else Park(hasWork, maxWait);
+            break;
+        }
+    }
+
+    // Consumer: the last poll found work. Closes the idle streak, if any.
+    void OnWork()
+    {
+        if (idlePolls_ == 0)
+            return;
+
+        Add(idleNs_, NowNs() - idleStart_);
+        Add(idleStreaks_, 1);
+        idlePolls_ = 0;
+    }
+
+    // Producer: call after publishing work. Free unless the policy is Blocking.
+    void Notify()
+    {
+        if (config_.policy != WaitPolicy::Blocking)
+            return;
+
+        // Pairs with the fence in Park(): either the consumer sees the new work
+        // in hasWork(), or we see it registered as a sleeper.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers_.load(std::memory_order_relaxed) == 0)
+            return;
+
+        notifyNs_.store(NowNs(), std::memory_order_relaxed);
+        {
+            // Under the lock, so the bump cannot fall between the sleeper's
+            // check and its wait.
+            std::lock_guard lock(parkMutex_);
+            epoch_.fetch_add(1, std::memory_order_release);
+        }
+        parkCv_.notify_one();
+    }
+
+    Stats GetStats() const
+    {
+        return {
+            idleNs_.load(std::memory_order_relaxed),
+            blockedNs_.load(std::memory_order_relaxed),
+            idleStreaks_.load(std::memory_order_relaxed),
+            parks_.load(std::memory_order_relaxed),
+            wakeups_.load(std::memory_order_relaxed),
+            maxWakeupLatencyNs_.load(std::memory_order_relaxed),
+            totalWakeupLatencyNs_.load(std::memory_order_relaxed),
+        };
+    }
+
+private:
+    static uint64_t NowNs()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    // Single-writer counters: load + store, no RMW.
+    static void Add(std::atomic<uint64_t>& counter, uint64_t value)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    void Backoff(std::chrono::nanoseconds maxWait)
+    {
+        if (idlePolls_ <= config_.spinLimit)
+        {
+            // 1, 2, 4 ... 64 pauses per idle poll
+            const uint32_t spins = 1u << std::min<uint32_t>(6, idlePolls_ / 16);
+            for (uint32_t i = 0; i < spins; ++i)
+                CpuRelax();
+            return;
+        }
+
+        // 1us, 2us, 4us ... capped at maxBackoff
+        const uint32_t step = std::min<uint32_t>(20, idlePolls_ - config_.spinLimit - 1);
+        const auto sleep = std::min<std::chrono::nanoseconds>(
+            std::min<std::chrono::nanoseconds>(std::chrono::microseconds(1u << step), config_.maxBackoff), maxWait);
+
+        const uint64_t start = NowNs();
+        std::this_thread::sleep_for(sleep);
+        Add(blockedNs_, NowNs() - start);
+        Add(parks_, 1);
+    }
+
+    template<typename HasWork>
+    void Park(HasWork& hasWork, std::chrono::nanoseconds maxWait)
+    {
+        const uint32_t epoch = epoch_.load(std::memory_order_acquire);
+        sleepers_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (!hasWork())
+        {
+            const uint64_t start = NowNs();
+            bool timedOut = false;
+            {
+                std::unique_lock lock(parkMutex_);
+                const auto woken = [&] { return epoch_.load(std::memory_order_acquire) != epoch; };
+                if (maxWait == NoTimeout)
+                    parkCv_.wait(lock, woken);
+                else
+                    timedOut = !parkCv_.wait_for(lock, maxWait, woken);
+            }
+            const uint64_t end = NowNs();
+
+            Add(blockedNs_, end - start);
+            Add(parks_, 1);
+            if (timedOut)
+            {
+                sleepers_.fetch_sub(1, std::memory_order_relaxed);
+                return; // Timed out
+            }
+            Add(wakeups_, 1);
+
+            const uint64_t notified = notifyNs_.load(std::memory_order_relaxed);
+            const uint64_t latency = end > notified ? end - notified : 0;
+            Add(totalWakeupLatencyNs_, latency);
+            if (latency > maxWakeupLatencyNs_.load(std::memory_order_relaxed))
+                maxWakeupLatencyNs_.store(latency, std::memory_order_relaxed);
+        }
+
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    const Config config_;
+
+    // Consumer-local state
+    uint32_t idlePolls_{ 0 };
+    uint64_t idleStart_{ 0 };
+
+    // Shared with producers
+    alignas(64) std::atomic<uint32_t> epoch_{ 0 };
+    std::atomic<uint32_t> sleepers_{ 0 };
+    std::atomic<uint64_t> notifyNs_{ 0 };
+    std::mutex parkMutex_;
+    std::condition_variable parkCv_;
+
+    // Published stats
+    alignas(64) std::atomic<uint64_t> idleNs_{ 0 };
+    std::atomic<uint64_t> blockedNs_{ 0 };
+    std::atomic<uint64_t> idleStreaks_{ 0 };
+    std::atomic<uint64_t> parks_{ 0 };
+    std::atomic<uint64_t> wakeups_{ 0 };
+    std::atomic<uint64_t> maxWakeupLatencyNs_{ 0 };
+    std::atomic<uint64_t> totalWakeupLatencyNs_{ 0 };
+};
@@ -0,0 +1,122 @@
+#include "Orderbook.h"
+
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <format>
+
+// Engine drain benchmark: throughput vs Orderbook::Config batch size / prefetch.
+//
+// Bursty open-auction flow: the producer fires bursts of requests back to back
+// (adds clustered around a reference price so both sides cross heavily, plus
+// cancels of recently added ids), then waits for the engine to go idle before
+// the next burst. Only the busy time of each burst is counted.
+//
+// Usage: ./batch_drain_benchmark [requests] [burst]   (default: 1000000 16384)
+
+namespace
+{
+    constexpr Price ReferencePrice = 10000;
+    constexpr Price AuctionBand = 50;
+    constexpr double CancelRatio = 0.3;
+
+    struct Step
+    {
+        bool isCancel;
+        OrderId orderId;
+        Side side;
+        Price price;
+        Quantity quantity;
+    };
+
+    // Same script for every configuration.
+    std::vector<Step> BuildScript(size_t requests)
+    {
+        std::mt19937_64 rng(7);
+        std::uniform_real_distribution<double> coin(0.0, 1.0);
+        std::uniform_int_distribution<Price> offset(-AuctionBand, AuctionBand);
+        std::uniform_int_distribution<Quantity> quantity(1, 100);
+
+        std::vector<Step> script;
+        script.reserve(requests);
+        OrderId nextId = 1;
+        for (size_t i = 0; i < requests; ++i)
+        {
+            if (nextId > 64 && coin(rng) < CancelRatio)
+            {
+                const OrderId id = nextId - 1 - static_cast<OrderId>(rng() % 64);
+                script.push_back({ true, id, Side::Buy, 0, 0 });
+                continue;
+            }
+
+            const Side side = coin(rng) < 0.5 ? Side::Buy : Side::Sell;
+            script.push_back({ false, nextId++, side, ReferencePrice + offset(rng), quantity(rng) });
+        }
+        return script;
+    }
+
+    double Run(const std::vector<Step>& script, size_t burst, size_t batchSize, size_t prefetchDistance)
+    {
+        Orderbook::Config config;
+        config.requestQueueSize = burst + 1;
+        config.batchSize = batchSize;
+        config.prefetchDistance = prefetchDistance;
+        auto orderbook = std::make_unique<Orderbook>(config);
+
+        std::chrono::nanoseconds busy{ 0 };
+        size_t submitted = 0;
+
+        for (size_t begin = 0; begin < script.size(); begin += burst)
+        {
+            const size_t end = std::min(script.size(), begin + burst);
+
+            const auto start = std::chrono::steady_clock::now();
+            for (size_t i = begin; i < end; ++i)
+            {
+                const Step& step = script[i];
+                if (step.isCancel)
+                    orderbook->CancelOrder(step.orderId);
+                else
+                    orderbook->AddOrder(OrderType::GoodTillCancel, step.orderId, step.side, step.price, step.quantity);
+            }
+
+            submitted += end - begin;
+            while (orderbook->GetOrdersProcessed() < submitted)
+                ; // Spin: yielding here would add scheduler noise to the burst time
+            busy += std::chrono::steady_clock::now() - start;
+        }
+
+        return static_cast<double>(script.size()) * 1e3 / static_cast<double>(busy.count()); // M req/s
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const size_t requests = argc > 1 ? std::stoull(argv[1]) : 1'000'000;
+    const size_t burst = argc > 2 ? std::stoull(argv[2]) : 16'384;
+
+    const auto script = BuildScript(requests);
+
+    std::cout << "===================================================" << std::endl;
+    std::cout << "   Engine Drain Benchmark (bursty open auction)    " << std::endl;
+    std::cout << "===================================================" << std::endl;
+    std::cout << std::format("{} requests, bursts of {}", requests, burst) << std::endl;
+    std::cout << std::format("{:>8} {:>10} {:>14}", "Batch", "Prefetch", "M req/s") << std::endl;
+
+    for (size_t batchSize : { 1, 4, 16, 32, 64, 256 })
+    {
+        for (size_t prefetchDistance : { 0, 4 })
+        {
+            if (batchSize == 1 && prefetchDistance > 0)
+                continue; // No lookahead within a single-request batch
+
+            const double throughput = Run(script, burst, batchSize, prefetchDistance);
+            std::cout << std::format("{:>8} {:>10} {:>14.2f}", batchSize, prefetchDistance, throughput) << std::endl;
+        }
+    }
+
+    return 0;
+}
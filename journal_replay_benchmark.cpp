@@ -0,0 +1,508 @@
+#include "Orderbook.h"
+#include "ProductionOrderbook.h"
+#include "IoUringJournaler.h"
+
+#include <iostream>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Journal replay benchmark: recorded order flow through the engines at full speed.
+//
+// The journal is memory-mapped and decoded up front into a flat event list
+// (adds, cancels and modifies; trade and system records are outputs and are
+// skipped), then replayed into Orderbook and/or ProductionOrderbook by one
+// producer as fast as the engine accepts it. At most `window` events are in
+// flight, which keeps the request queue from overflowing.
+//
+// Latency is measured per event from the producer's submit until the engine's
+// processed counter passes it, so it includes queueing behind the window; a
+// window of 1 gives the bare service time. The book checksum (FNV-1a over the
+// final levels) is the same on every replay of a journal into the same engine
+// unless matching behaviour changed. The two engines' checksums differ:
+// ProductionOrderbook's price-indexed book aggregates levels without matching.
+//
+// ProductionOrderbook runs its engine thread SCHED_FIFO on cpu_affinity, so
+// give the replay its own core (taskset); on a shared core the producer only
+// runs in the real-time throttling slack.
+//
+// Formats:
+//   iouring  fixed 64-byte JournalEntry records (IoUringJournaler)
+//   async    AsyncJournaler records (Orderbook's Config::journalPath): int type,
+//            OrderId, then for an add OrderType, OrderId, Side, Price, Quantity,
+//            OwnerId, for a modify OrderModify, for a mass cancel OwnerId,
+//            min/max Price and buys/sells flags. The journal is in processed
+//            order, so Orderbook replays it with priority lanes off.
+//            ProductionOrderbook has no mass cancel and skips those records.
+//
+// If the journal file does not exist, a seeded synthetic day is written to it
+// first (iouring format), so later runs replay exactly the same flow.
+//
+// Usage: ./journal_replay_benchmark [journal] [iouring|async] [orderbook|production|both] [window]
+//        (default: replay.journal iouring both 4096)
+
+namespace
+{
+    constexpr Price ReferencePrice = 10000;
+    constexpr Price Levels = 100;               // Per side
+    constexpr size_t SyntheticEvents = 2'000'000;
+
+    enum class EventType { Add, Cancel, Modify, MassCancel };
+    constexpr std::array<const char*, 4> EventNames{ "add", "cancel", "modify", "masscancel" };
+
+    struct Event
+    {
+        EventType type;
+        OrderType orderType;
+        OrderId orderId;
+        Side side;
+        Price price;
+        Quantity quantity;
+        OwnerId owner{ Constants::NoOwner };
+        Orderbook::MassCancelFilter massCancel{ };
+    };
+
+    // Read-only mapping of a whole file.
+    class MappedFile
+    {
+    public:
+        explicit MappedFile(const std::string& path)
+        {
+            const int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+                throw std::runtime_error(std::format("Cannot open journal {}", path));
+
+            struct stat info;
+            if (::fstat(fd, &info) != 0)
+            {
+                ::close(fd);
+                throw std::runtime_error(std::format("Cannot stat journal {}", path));
+            }
+
+            size_ = static_cast<size_t>(info.st_size);
+            if (size_ > 0)
+            {
+                void* data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (data == MAP_FAILED)
+                {
+                    ::close(fd);
+                    throw std::runtime_error(std::format("Cannot map journal {}", path));
+                }
+                data_ = static_cast<const std::byte*>(data);
+                ::madvise(data, size_, MADV_SEQUENTIAL);
+            }
+            ::close(fd);
+        }
+
+        ~MappedFile()
+        {
+            if (data_)
+                ::munmap(const_cast<std::byte*>(data_), size_);
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        std::span<const std::byte> Bytes() const { return { data_, size_ }; }
+
+    private:
+        const std::byte* data_{ nullptr };
+        size_t size_{ 0 };
+    };
+
+    template<typename T>
+    T ReadAt(std::span<const std::byte> bytes, size_t& offset)
+    {
+        if (bytes.size() - offset < sizeof(T))
+            throw std::runtime_error(std::format("Truncated journal record at byte {}", offset));
+
+        std::array<std::byte, sizeof(T)> raw;
+        std::memcpy(raw.data(), bytes.data() + offset, sizeof(T));
+        offset += sizeof(T);
+        return std::bit_cast<T>(raw);
+    }
+
+    std::vector<Event> DecodeIoUring(std::span<const std::byte> bytes)
+    {
+        if (bytes.size() % sizeof(JournalEntry) != 0)
+            throw std::runtime_error(std::format("Journal size {} is not a multiple of {}", bytes.size(), sizeof(JournalEntry)));
+
+        // Modify records carry no side; take it from the order's add.
+        std::unordered_map<OrderId, Side> sides;
+        std::vector<Event> events;
+        events.reserve(bytes.size() / sizeof(JournalEntry));
+
+        for (size_t offset = 0; offset < bytes.size();)
+        {
+            JournalEntry entry;
+            std::memcpy(&entry, bytes.data() + offset, sizeof(entry));
+            offset += sizeof(entry);
+
+            switch (entry.type)
+            {
+            case JournalEntry::Type::Add:
+            {
+                const auto& add = entry.data.add;
+                sides[add.order_id] = add.side;
+                events.push_back({ EventType::Add, add.order_type, add.order_id, add.side, add.price, add.quantity });
+                break;
+            }
+            case JournalEntry::Type::Cancel:
+                events.push_back({ EventType::Cancel, OrderType::GoodTillCancel, entry.data.cancel.order_id, Side::Buy, 0, 0 });
+                break;
+            case JournalEntry::Type::Modify:
+            {
+                const auto& modify = entry.data.modify;
+                const auto side = sides.find(modify.order_id);
+                if (side == sides.end())
+                    break; // Never added, so the engine would ignore it
+                events.push_back({ EventType::Modify, OrderType::GoodTillCancel, modify.order_id, side->second, modify.new_price, modify.new_quantity });
+                break;
+            }
+            case JournalEntry::Type::Trade:
+            case JournalEntry::Type::System:
+                break;
+            default:
+                throw std::runtime_error(std::format("Unknown journal record type {} at byte {}",
+                    static_cast<int>(entry.type), offset - sizeof(entry)));
+            }
+        }
+        return events;
+    }
+
+    std::vector<Event> DecodeAsync(std::span<const std::byte> bytes)
+    {
+        std::vector<Event> events;
+        for (size_t offset = 0; offset < bytes.size();)
+        {
+            const size_t start = offset;
+            const int type = ReadAt<int>(bytes, offset);
+            const OrderId orderId = ReadAt<OrderId>(bytes, offset);
+
+            switch (type)
+            {
+            case 0: // Add
+            {
+                const auto orderType = ReadAt<OrderType>(bytes, offset);
+                const auto addId = ReadAt<OrderId>(bytes, offset);
+                const auto side = ReadAt<Side>(bytes, offset);
+                const auto price = ReadAt<Price>(bytes, offset);
+                const auto quantity = ReadAt<Quantity>(bytes, offset);
+                const auto owner = ReadAt<OwnerId>(bytes, offset);
+                events.push_back({ EventType::Add, orderType, addId, side, price, quantity, owner });
+                break;
+            }
+            case 1: // Cancel
+                events.push_back({ EventType::Cancel, OrderType::GoodTillCancel, orderId, Side::Buy, 0, 0 });
+                break;
+            case 2: // Modify
+            {
+                const auto modify = ReadAt<OrderModify>(bytes, offset);
+                events.push_back({ EventType::Modify, OrderType::GoodTillCancel, modify.GetOrderId(),
+                    modify.GetSide(), modify.GetPrice(), modify.GetQuantity() });
+                break;
+            }
+            case 3: // MassCancel
+            {
+                Orderbook::MassCancelFilter filter;
+                filter.owner = ReadAt<OwnerId>(bytes, offset);
+                filter.minPrice = ReadAt<Price>(bytes, offset);
+                filter.maxPrice = ReadAt<Price>(bytes, offset);
+                filter.buys = ReadAt<bool>(bytes, offset);
+                filter.sells = ReadAt<bool>(bytes, offset);
+                events.push_back({ EventType::MassCancel, OrderType::GoodTillCancel, 0, Side::Buy, 0, 0, filter.owner, filter });
+                break;
+            }
+            default:
+                throw std::runtime_error(std::format("Unknown journal record type {} at byte {}", type, start));
+            }
+        }
+        return events;
+    }
+
+    // A seeded day of flow around one reference price: passive adds, crossing
+    // adds that trade through a few levels, cancels and amends of live orders.
+    void WriteSyntheticJournal(const std::string& path, size_t count)
+    {
+        std::mt19937_64 rng(19);
+        std::uniform_int_distribution<Price> level(1, Levels);
+        std::uniform_int_distribution<Quantity> quantity(1, 100);
+        std::uniform_int_distribution<int> action(0, 99);
+
+        std::vector<OrderId> live;
+        OrderId nextId = 1;
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file)
+            throw std::runtime_error(std::format("Cannot create journal {}", path));
+
+        for (uint64_t sequence = 1; sequence <= count; ++sequence)
+        {
+            JournalEntry entry;
+            std::memset(&entry, 0, sizeof(entry));
+            entry.timestamp = sequence * 1000;
+            entry.sequence_number = sequence;
+
+            const int roll = action(rng);
+            if (roll < 65 || live.empty())
+            {
+                const Side side = rng() % 2 ? Side::Sell : Side::Buy;
+                const bool crossing = roll < 10;
+                const Price offset = crossing ? -(level(rng) % 5) : level(rng);
+                entry.type = JournalEntry::Type::Add;
+                entry.data.add.order_id = nextId;
+                entry.data.add.side = side;
+                entry.data.add.price = side == Side::Buy ? ReferencePrice - offset : ReferencePrice + offset;
+                entry.data.add.quantity = quantity(rng);
+                entry.data.add.order_type = crossing && roll % 2 ? OrderType::FillAndKill : OrderType::GoodTillCancel;
+                live.push_back(nextId++);
+            }
+            else
+            {
+                const size_t pick = rng() % live.size();
+                const OrderId orderId = live[pick];
+                if (roll < 90)
+                {
+                    entry.type = JournalEntry::Type::Cancel;
+                    entry.data.cancel.order_id = orderId;
+                    live[pick] = live.back();
+                    live.pop_back();
+                }
+                else
+                {
+                    // Amends keep the order on its side of the reference.
+                    entry.type = JournalEntry::Type::Modify;
+                    entry.data.modify.order_id = orderId;
+                    entry.data.modify.new_price = ReferencePrice + (rng() % 2 ? level(rng) : -level(rng));
+                    entry.data.modify.new_quantity = quantity(rng);
+                }
+            }
+
+            file.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+        }
+    }
+
+    void Submit(Orderbook& orderbook, const Event& event)
+    {
+        switch (event.type)
+        {
+        case EventType::Add:
+            orderbook.AddOrder(event.orderType, event.orderId, event.side, event.price, event.quantity, event.owner);
+            break;
+        case EventType::Cancel:
+            orderbook.CancelOrder(event.orderId);
+            break;
+        case EventType::Modify:
+            orderbook.ModifyOrder(OrderModify{ event.orderId, event.side, event.price, event.quantity });
+            break;
+        case EventType::MassCancel:
+            orderbook.MassCancel(event.massCancel);
+            break;
+        }
+    }
+
+    void Submit(ProductionOrderbook& orderbook, const Event& event)
+    {
+        switch (event.type)
+        {
+        case EventType::Add:
+            orderbook.AddOrder(event.orderType, event.orderId, event.side, event.price, event.quantity);
+            break;
+        case EventType::Cancel:
+            orderbook.CancelOrder(event.orderId);
+            break;
+        case EventType::Modify:
+            orderbook.ModifyOrder(event.orderId, event.side, event.price, event.quantity);
+            break;
+        case EventType::MassCancel:
+            break; // Filtered out before the replay
+        }
+    }
+
+    struct ReplayResult
+    {
+        int64_t elapsedNs;
+        std::array<HdrHistogram<>, 4> latency; // Per EventType
+        uint64_t checksum;
+        size_t bidLevels;
+        size_t askLevels;
+    };
+
+    uint64_t Checksum(const OrderbookLevelInfos& infos)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        auto mix = [&hash](uint64_t value)
+        {
+            for (int i = 0; i < 8; ++i, value >>= 8)
+            {
+                hash ^= value & 0xFF;
+                hash *= 1099511628211ull;
+            }
+        };
+
+        for (const auto& level : infos.GetBids())
+        {
+            mix(static_cast<uint32_t>(level.price_));
+            mix(level.quantity_);
+        }
+        mix(~0ull); // Side separator
+        for (const auto& level : infos.GetAsks())
+        {
+            mix(static_cast<uint32_t>(level.price_));
+            mix(level.quantity_);
+        }
+        return hash;
+    }
+
+    // Book is Orderbook or ProductionOrderbook; both count every request they
+    // finish in GetOrdersProcessed(), in submission order.
+    template<typename Book>
+    std::unique_ptr<ReplayResult> Replay(Book& orderbook, const std::vector<Event>& events, size_t window)
+    {
+        auto result = std::make_unique<ReplayResult>();
+        std::vector<uint64_t> submittedAt(events.size());
+        size_t completed = 0;
+
+        auto collect = [&]()
+        {
+            const size_t processed = orderbook.GetOrdersProcessed();
+            if (processed == completed)
+                return;
+
+            const uint64_t now = TscClock::NowNs();
+            for (; completed < processed; ++completed)
+                result->latency[static_cast<size_t>(events[completed].type)].Record(now - submittedAt[completed]);
+        };
+
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < events.size(); ++i)
+        {
+            while (i - completed >= window)
+                collect();
+
+            submittedAt[i] = TscClock::NowNs();
+            Submit(orderbook, events[i]);
+            collect();
+        }
+        while (completed < events.size())
+            collect();
+        result->elapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+        const auto infos = orderbook.GetOrderInfos();
+        result->checksum = Checksum(infos);
+        result->bidLevels = infos.GetBids().size();
+        result->askLevels = infos.GetAsks().size();
+        return result;
+    }
+
+    void Report(const char* engine, const ReplayResult& result, size_t events)
+    {
+        const double seconds = static_cast<double>(result.elapsedNs) / 1e9;
+        std::cout << std::format("{}: {:.2f} M events/s ({:.3f} s), book {} bids / {} asks, checksum {:016x}",
+            engine, static_cast<double>(events) / seconds / 1e6, seconds,
+            result.bidLevels, result.askLevels, result.checksum) << std::endl;
+
+        std::cout << std::format("{:>10} {:>10} {:>10} {:>10} {:>10} {:>10} {:>10}",
+            "event", "count", "p50 ns", "p99 ns", "p99.9 ns", "p99.99 ns", "max ns") << std::endl;
+        for (size_t type = 0; type < result.latency.size(); ++type)
+        {
+            const auto& latency = result.latency[type];
+            if (latency.Count() == 0)
+                continue;
+            std::cout << std::format("{:>10} {:>10} {:>10} {:>10} {:>10} {:>10} {:>10}",
+                EventNames[type], latency.Count(),
+                latency.ValueAtPercentile(50.0), latency.ValueAtPercentile(99.0),
+                latency.ValueAtPercentile(99.9), latency.ValueAtPercentile(99.99),
+                latency.Max()) << std::endl;
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const std::string path = argc > 1 ? argv[1] : "replay.journal";
+    const std::string format = argc > 2 ? argv[2] : "iouring";
+    const std::string engine = argc > 3 ? argv[3] : "both";
+    const size_t window = argc > 4 ? std::stoull(argv[4]) : 4096;
+
+    if (format != "iouring" && format != "async")
+        throw std::invalid_argument(std::format("Unknown journal format {}", format));
+    if (engine != "orderbook" && engine != "production" && engine != "both")
+        throw std::invalid_argument(std::format("Unknown engine {}", engine));
+    if (window == 0)
+        throw std::invalid_argument("Window must be non-zero");
+
+    if (!std::filesystem::exists(path))
+    {
+        if (format != "iouring")
+            throw std::runtime_error(std::format("Journal {} not found", path));
+        std::cout << std::format("Writing synthetic journal {} ({} events)", path, SyntheticEvents) << std::endl;
+        WriteSyntheticJournal(path, SyntheticEvents);
+    }
+
+    std::vector<Event> events;
+    size_t bytes = 0;
+    {
+        const MappedFile journal(path);
+        bytes = journal.Bytes().size();
+        events = format == "iouring" ? DecodeIoUring(journal.Bytes()) : DecodeAsync(journal.Bytes());
+    }
+
+    // Every add or modify may need a pool slot while earlier orders still rest.
+    size_t poolSize = 1;
+    for (const Event& event : events)
+        if (event.type == EventType::Add || event.type == EventType::Modify)
+            ++poolSize;
+
+    [[maybe_unused]] const uint64_t clockWarm = TscClock::NowNs(); // Start the clock's refit thread first
+
+    std::cout << "===================================================" << std::endl;
+    std::cout << "   Journal Replay Benchmark                        " << std::endl;
+    std::cout << "===================================================" << std::endl;
+    std::cout << std::format("{} ({} format, {} bytes): {} events, window {}",
+        path, format, bytes, events.size(), window) << std::endl;
+
+    if (engine != "production")
+    {
+        Orderbook::Config config;
+        config.orderPoolSize = poolSize;
+        config.priorityLanes = false; // Replay in journal order
+        config.requestQueueSize = std::max(config.requestQueueSize, window + 1);
+        auto orderbook = std::make_unique<Orderbook>(config);
+        Report("Orderbook", *Replay(*orderbook, events, window), events.size());
+    }
+
+    if (engine != "orderbook")
+    {
+        // Matching only: no journal of the replay, no risk checks, no shared
+        // memory metrics, and no host validation.
+        ProductionOrderbook::EngineConfig config;
+        config.object_pool_size = poolSize;
+        config.request_queue_size = std::max(config.request_queue_size, window + 1);
+        config.enable_journaling = false;
+        config.enable_risk_management = false;
+        config.enable_metrics = false;
+        config.validate_system_config = false;
+        std::erase_if(events, [](const Event& event) { return event.type == EventType::MassCancel; });
+        auto orderbook = std::make_unique<ProductionOrderbook>(config);
+        Report("ProductionOrderbook", *Replay(*orderbook, events, window), events.size());
+    }
+
+    return 0;
+}
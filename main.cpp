@@ -2,6 +2,7 @@
 #include <iostream>
 #include <vector>
 #include <thread>
+#include <atomic>
 #include <chrono>
 #include <format>
 
@@ -26,7 +27,40 @@ int main()
     std::cout << "[Test] Starting Load Generator (1 Producer -> 1 Consumer)..." << std::endl;
     std::cout << "[Test] Generating " << NUM_ORDERS << " orders..." << std::endl;
 
-    auto start = std::chrono::high_resolution_clock::now();
+    // Downstream readers (drop copy, market data), each reading the engine's
+    // output events in place at its own pace. Attached before any order so
+    // neither misses an event.
+    auto& events = orderbook.GetEvents();
+    const auto dropCopy = events.AddConsumer();
+    const auto marketData = events.AddConsumer();
+
+    std::atomic<bool> producerDone{ false };
+    auto startReader = [&](BroadcastRing<EngineEvent>::ConsumerId consumer, auto onEvent) {
+        return std::thread([&, consumer, onEvent]() mutable {
+            while (!producerDone.load(std::memory_order_acquire))
+            {
+                if (events.Consume(consumer, onEvent) == 0)
+                    std::this_thread::yield();
+            }
+            events.Consume(consumer, onEvent);
+        });
+    };
+
+    uint64_t tradeCount = 0;
+    uint64_t tradedVolume = 0;
+    std::thread tradeReader = startReader(dropCopy, [&](const EngineEvent& event) {
+        if (event.type != EngineEvent::Type::Trade)
+            return;
+        ++tradeCount;
+        tradedVolume += event.trade.quantity;
+    });
+
+    uint64_t deltaCount = 0;
+    std::thread deltaReader = startReader(marketData, [&](const EngineEvent& event) {
+        deltaCount += event.type == EngineEvent::Type::LevelDelta;
+    });
+
+    const uint64_t start = TscClock::NowNs();
 
     std::thread producer([&]() {
         for (int i = 0; i < NUM_ORDERS; ++i)
@@ -36,9 +70,8 @@ int main()
             Side side = (i % 2 == 0) ? Side::Buy : Side::Sell;
             Price price = 100; 
             
-            // Use Object Pool!
-            auto order = orderbook.AcquireOrder(OrderType::GoodTillCancel, i+1, side, price, 10);
-            orderbook.AddOrder(order);
+            while (orderbook.AddOrder(OrderType::GoodTillCancel, i+1, side, price, 10) != SubmitResult::Accepted)
+                std::this_thread::yield(); // Out of credits: wait for the engine to drain
         }
     });
 
@@ -50,14 +83,24 @@ int main()
         std::this_thread::yield();
     }
 
-    auto end = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::nanoseconds(TscClock::NowNs() - start));
+
+    producerDone.store(true, std::memory_order_release);
+    tradeReader.join();
+    deltaReader.join();
 
     std::cout << "---------------------------------------------------" << std::endl;
     std::cout << "Results:" << std::endl;
     std::cout << "  Count:      " << NUM_ORDERS << " orders" << std::endl;
     std::cout << "  Time:       " << duration.count() << " ms" << std::endl;
     std::cout << "  Throughput: " << (NUM_ORDERS * 1000.0 / duration.count()) << " ops/sec" << std::endl;
+    std::cout << "  Trades:     " << tradeCount << " (" << tradedVolume << " qty)" << std::endl;
+    std::cout << "  L2 deltas:  " << deltaCount << std::endl;
+    std::cout << "  Event ring: " << events.GetPublished() << " published, engine waited on "
+              << orderbook.GetEventStalls() << std::endl;
+    std::cout << "  Max lag:    drop copy " << events.GetConsumerStats(dropCopy).maxLag
+              << ", market data " << events.GetConsumerStats(marketData).maxLag << " events" << std::endl;
     std::cout << "---------------------------------------------------" << std::endl;
     
     auto stats = orderbook.GetLatencyStats();
@@ -65,6 +108,7 @@ int main()
     std::cout << "  p50 (Median):   " << stats.p50 << " ns" << std::endl;
     std::cout << "  p99:            " << stats.p99 << " ns" << std::endl;
     std::cout << "  p99.9 (Tail):   " << stats.p999 << " ns" << std::endl;
+    std::cout << "  p99.99:         " << stats.p9999 << " ns" << std::endl;
     std::cout << "  Max:            " << stats.max << " ns" << std::endl;
     std::cout << "---------------------------------------------------" << std::endl;
 
@@ -0,0 +1,83 @@
+#include "Orderbook.h"
+
+#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <format>
+
+// Multi-producer ingress benchmark.
+//
+// N gateway threads each register their own lane and submit a crossing
+// buy/sell flow concurrently. Slab slots are acquired before the clock starts
+// so only the ingress path and the engine are measured. Reports end-to-end
+// throughput for both fan-in policies.
+//
+// Usage: ./multi_producer_benchmark [orders_per_producer]   (default: 250000)
+
+namespace
+{
+    double Run(size_t producers, size_t ordersPerProducer, FanInPolicy policy)
+    {
+        Orderbook::Config config;
+        config.maxProducers = producers + 1; // +1 for the built-in lane
+        config.fanInPolicy = policy;
+        auto orderbook = std::make_unique<Orderbook>(config);
+
+        std::atomic<bool> go{ false };
+        std::vector<std::thread> threads;
+        for (size_t p = 0; p < producers; ++p)
+        {
+            threads.emplace_back([&, p]() {
+                const auto lane = orderbook->RegisterProducer();
+                while (!go.load(std::memory_order_acquire))
+                    ;
+                for (size_t i = 0; i < ordersPerProducer; ++i)
+                {
+                    const OrderId id = static_cast<OrderId>(p * ordersPerProducer + i + 1);
+                    const Side side = (i % 2 == 0) ? Side::Buy : Side::Sell;
+                    while (orderbook->AddOrder(lane, OrderType::GoodTillCancel, id, side, 100, 10) != SubmitResult::Accepted)
+                        ; // Lane full: retry until the engine frees a slot
+                }
+            });
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        go.store(true, std::memory_order_release);
+
+        const size_t total = producers * ordersPerProducer;
+        while (orderbook->GetOrdersProcessed() < total)
+            std::this_thread::yield();
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+
+        for (auto& thread : threads)
+            thread.join();
+
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+        return static_cast<double>(total) * 1e3 / static_cast<double>(ns); // M orders/s
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const size_t ordersPerProducer = argc > 1 ? std::stoull(argv[1]) : 250'000;
+
+    std::cout << "===================================================" << std::endl;
+    std::cout << "   Multi-Producer Ingress Benchmark (N -> 1)       " << std::endl;
+    std::cout << "===================================================" << std::endl;
+    std::cout << std::format("{} orders per producer, {} hardware threads", ordersPerProducer, std::thread::hardware_concurrency()) << std::endl;
+    std::cout << std::format("{:>10} {:>18} {:>14}", "Producers", "Policy", "M orders/s") << std::endl;
+
+    for (size_t producers : { 1, 2, 4, 8 })
+    {
+        const double roundRobin = Run(producers, ordersPerProducer, FanInPolicy::RoundRobin);
+        std::cout << std::format("{:>10} {:>18} {:>14.2f}", producers, "RoundRobin", roundRobin) << std::endl;
+
+        const double merged = Run(producers, ordersPerProducer, FanInPolicy::TimestampMerged);
+        std::cout << std::format("{:>10} {:>18} {:>14.2f}", producers, "TimestampMerged", merged) << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,132 @@
+#include "FlatOrderMap.h"
+#include "Order.h"
+
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <format>
+
+// Order-id index benchmark: FlatOrderMap vs std::unordered_map.
+//
+// For each live-order count N the book is filled with N orders, then driven
+// with a cancel-heavy flow (95% cancel of a random live order, 5% lookup miss),
+// each cancel immediately followed by an add so the live count stays at N.
+// Reports ns per operation for the steady-state mix.
+//
+// Usage: ./order_index_benchmark [N ...]   (default: 1000000 10000000 50000000)
+
+namespace
+{
+    constexpr double CancelRatio = 0.95;
+
+    struct Result
+    {
+        double fillNsPerOp;
+        double mixNsPerOp;
+        size_t cancelHits;
+    };
+
+    double NsPerOp(std::chrono::steady_clock::time_point start, size_t ops)
+    {
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        return static_cast<double>(elapsed) / static_cast<double>(ops);
+    }
+
+    // Adapters so both containers run the identical workload.
+    struct FlatIndex
+    {
+        explicit FlatIndex(size_t n) : map(n) { }
+        bool Insert(OrderId id, OrderHandle h) { return map.Insert(id, h); }
+        bool Cancel(OrderId id) { return map.Extract(id).has_value(); }
+        FlatOrderMap<OrderHandle> map;
+    };
+
+    struct StdIndex
+    {
+        explicit StdIndex(size_t n) { map.reserve(n); }
+        bool Insert(OrderId id, OrderHandle h) { return map.insert({ id, h }).second; }
+        bool Cancel(OrderId id)
+        {
+            // Mirrors the original Orderbook::CancelOrderInternal access pattern.
+            if (!map.contains(id)) return false;
+            [[maybe_unused]] auto h = map.at(id);
+            map.erase(id);
+            return true;
+        }
+        std::unordered_map<OrderId, OrderHandle> map;
+    };
+
+    template<typename Index>
+    Result Run(size_t liveOrders, size_t mixOps)
+    {
+        Index index(liveOrders);
+        std::vector<OrderId> live(liveOrders);
+        OrderId nextId = 1;
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < liveOrders; ++i)
+        {
+            live[i] = nextId++;
+            index.Insert(live[i], OrderHandle{ static_cast<std::uint32_t>(i & PoolHandle::IndexMask), 0 });
+        }
+        const double fill = NsPerOp(start, liveOrders);
+
+        std::mt19937_64 rng(42);
+        std::uniform_real_distribution<double> coin(0.0, 1.0);
+        std::vector<std::pair<bool, size_t>> script(mixOps);
+        for (auto& [isCancel, slot] : script)
+        {
+            isCancel = coin(rng) < CancelRatio;
+            slot = static_cast<size_t>(rng() % liveOrders);
+        }
+
+        size_t hits = 0;
+        start = std::chrono::steady_clock::now();
+        for (const auto& [isCancel, slot] : script)
+        {
+            if (isCancel)
+            {
+                hits += index.Cancel(live[slot]);
+                live[slot] = nextId++;
+                index.Insert(live[slot], OrderHandle{ static_cast<std::uint32_t>(slot & PoolHandle::IndexMask), 0 });
+            }
+            else
+            {
+                hits += index.Cancel(nextId + slot); // Unknown id: miss path
+            }
+        }
+        const double mix = NsPerOp(start, mixOps);
+
+        return { fill, mix, hits };
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<size_t> sizes;
+    for (int i = 1; i < argc; ++i)
+        sizes.push_back(std::stoull(argv[i]));
+    if (sizes.empty())
+        sizes = { 1'000'000, 10'000'000, 50'000'000 };
+
+    constexpr size_t MixOps = 10'000'000;
+
+    std::cout << "===================================================" << std::endl;
+    std::cout << "   Order Index Benchmark (95% cancel flow)         " << std::endl;
+    std::cout << "===================================================" << std::endl;
+    std::cout << std::format("{:>12} {:>22} {:>14} {:>14} {:>12}", "Live", "Index", "Fill ns/op", "Mix ns/op", "Hits") << std::endl;
+
+    for (size_t n : sizes)
+    {
+        const auto flat = Run<FlatIndex>(n, MixOps);
+        std::cout << std::format("{:>12} {:>22} {:>14.1f} {:>14.1f} {:>12}", n, "FlatOrderMap", flat.fillNsPerOp, flat.mixNsPerOp, flat.cancelHits) << std::endl;
+
+        const auto std_ = Run<StdIndex>(n, MixOps);
+        std::cout << std::format("{:>12} {:>22} {:>14.1f} {:>14.1f} {:>12}", n, "std::unordered_map", std_.fillNsPerOp, std_.mixNsPerOp, std_.cancelHits) << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,270 @@
+#include "Orderbook.h"
+
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <optional>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Order layout benchmark: matching throughput and cache misses on the engine thread.
+//
+// The book is seeded with deep queues on both sides, then driven with a
+// match-heavy flow: each step is a FillAndKill that sweeps several resting
+// orders, followed by passive adds that put the swept quantity back. The
+// matching loop therefore walks long runs of resting Order records, which is
+// where the size of the record shows up.
+//
+// Cache misses are read from the PMU (perf_event_open) for the engine thread
+// only, over the timed phase. Run it on the tree before and after a layout
+// change and compare; without PMU access the counters print as n/a.
+//
+// Usage: ./order_layout_benchmark [resting] [steps]   (default: 1000000 200000)
+
+namespace
+{
+    constexpr Price ReferencePrice = 10000;
+    constexpr Price Levels = 200;           // Per side
+    constexpr Quantity SweepQuantity = 40;  // About eight resting orders per step
+
+    struct Step
+    {
+        OrderType type;
+        OrderId orderId;
+        Side side;
+        Price price;
+        Quantity quantity;
+    };
+
+    enum class PmuEvent
+    {
+        CacheMisses,        // Last-level cache
+        L1dReadMisses,
+    };
+
+    // Counts one event on a set of threads (user space only).
+    class PmuCounter
+    {
+    public:
+        PmuCounter(PmuEvent event, const std::vector<int>& threads)
+        {
+#if defined(__linux__)
+            for (int tid : threads)
+            {
+                perf_event_attr attr;
+                std::memset(&attr, 0, sizeof(attr));
+                attr.size = sizeof(attr);
+                if (event == PmuEvent::CacheMisses)
+                {
+                    attr.type = PERF_TYPE_HARDWARE;
+                    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+                }
+                else
+                {
+                    attr.type = PERF_TYPE_HW_CACHE;
+                    attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+                }
+                attr.disabled = 1;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+
+                const int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, tid, -1, -1, 0));
+                if (fd < 0)
+                {
+                    Close();
+                    return;
+                }
+                fds_.push_back(fd);
+            }
+#else
+            (void)event; (void)threads;
+#endif
+        }
+
+        ~PmuCounter() { Close(); }
+
+        void Start()
+        {
+#if defined(__linux__)
+            for (int fd : fds_)
+            {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+#endif
+        }
+
+        void Stop()
+        {
+#if defined(__linux__)
+            for (int fd : fds_)
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+#endif
+        }
+
+        std::optional<uint64_t> Read() const
+        {
+            if (fds_.empty())
+                return std::nullopt;
+
+            uint64_t total = 0;
+#if defined(__linux__)
+            for (int fd : fds_)
+            {
+                uint64_t value = 0;
+                if (::read(fd, &value, sizeof(value)) != sizeof(value))
+                    return std::nullopt;
+                total += value;
+            }
+#endif
+            return total;
+        }
+
+    private:
+        void Close()
+        {
+#if defined(__linux__)
+            for (int fd : fds_)
+                ::close(fd);
+#endif
+            fds_.clear();
+        }
+
+        std::vector<int> fds_;
+    };
+
+    std::set<int> ThreadIds()
+    {
+        std::set<int> ids;
+#if defined(__linux__)
+        for (const auto& entry : std::filesystem::directory_iterator("/proc/self/task"))
+            ids.insert(std::stoi(entry.path().filename().string()));
+#endif
+        return ids;
+    }
+
+    std::vector<Step> BuildSeed(size_t resting, OrderId& nextId, std::mt19937_64& rng)
+    {
+        std::uniform_int_distribution<Price> level(1, Levels);
+        std::uniform_int_distribution<Quantity> quantity(1, 9);
+
+        std::vector<Step> seed;
+        seed.reserve(resting);
+        for (size_t i = 0; i < resting; ++i)
+        {
+            const Side side = i % 2 ? Side::Sell : Side::Buy;
+            const Price price = side == Side::Buy ? ReferencePrice - level(rng) : ReferencePrice + level(rng);
+            seed.push_back({ OrderType::GoodTillCancel, nextId++, side, price, quantity(rng) });
+        }
+        return seed;
+    }
+
+    std::vector<Step> BuildFlow(size_t steps, OrderId& nextId, std::mt19937_64& rng)
+    {
+        std::uniform_int_distribution<Price> level(1, Levels);
+        std::uniform_int_distribution<Quantity> quantity(1, 9);
+
+        std::vector<Step> flow;
+        flow.reserve(steps * 10);
+        for (size_t i = 0; i < steps; ++i)
+        {
+            // Sweep one side through the touch...
+            const Side aggressor = i % 2 ? Side::Sell : Side::Buy;
+            const Price limit = aggressor == Side::Buy ? ReferencePrice + Levels : ReferencePrice - Levels;
+            flow.push_back({ OrderType::FillAndKill, nextId++, aggressor, limit, SweepQuantity });
+
+            // ...and refill it behind the touch.
+            const Side passive = aggressor == Side::Buy ? Side::Sell : Side::Buy;
+            for (Quantity refilled = 0; refilled < SweepQuantity;)
+            {
+                const Quantity q = quantity(rng);
+                const Price price = passive == Side::Buy ? ReferencePrice - level(rng) : ReferencePrice + level(rng);
+                flow.push_back({ OrderType::GoodTillCancel, nextId++, passive, price, q });
+                refilled += q;
+            }
+        }
+        return flow;
+    }
+
+    void Submit(Orderbook& orderbook, const std::vector<Step>& steps, size_t& submitted)
+    {
+        for (const Step& step : steps)
+        {
+            orderbook.AddOrder(step.type, step.orderId, step.side, step.price, step.quantity);
+            ++submitted;
+            if (submitted % 4096 == 0)
+                while (orderbook.GetOrdersProcessed() + 16384 < submitted)
+                    ; // Keep the request lane from overflowing
+        }
+        while (orderbook.GetOrdersProcessed() < submitted)
+            ;
+    }
+
+    std::string PerRequest(const std::optional<uint64_t>& count, size_t requests)
+    {
+        return count ? std::format("{:.3f}", static_cast<double>(*count) / static_cast<double>(requests)) : std::string("n/a");
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const size_t resting = argc > 1 ? std::stoull(argv[1]) : 1'000'000;
+    const size_t steps = argc > 2 ? std::stoull(argv[2]) : 200'000;
+
+    std::mt19937_64 rng(11);
+    OrderId nextId = 1;
+    const auto seed = BuildSeed(resting, nextId, rng);
+    const auto flow = BuildFlow(steps, nextId, rng);
+
+    [[maybe_unused]] const uint64_t clockWarm = TscClock::NowNs(); // Start the clock's refit thread first
+    const auto before = ThreadIds();
+
+    Orderbook::Config config;
+    config.orderPoolSize = resting + flow.size();
+    auto orderbook = std::make_unique<Orderbook>(config);
+
+    std::vector<int> engineThreads;
+    for (int tid : ThreadIds())
+        if (!before.contains(tid))
+            engineThreads.push_back(tid);
+
+    size_t submitted = 0;
+    Submit(*orderbook, seed, submitted);
+
+    PmuCounter cacheMisses(PmuEvent::CacheMisses, engineThreads);
+    PmuCounter l1dMisses(PmuEvent::L1dReadMisses, engineThreads);
+
+    cacheMisses.Start();
+    l1dMisses.Start();
+    const auto start = std::chrono::steady_clock::now();
+    Submit(*orderbook, flow, submitted);
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    l1dMisses.Stop();
+    cacheMisses.Stop();
+
+    const uint64_t executions = orderbook->GetTradesExecuted(); // No consumer attached: nothing gates the engine
+
+    std::cout << "===================================================" << std::endl;
+    std::cout << "   Order Layout Benchmark (match-heavy flow)       " << std::endl;
+    std::cout << "===================================================" << std::endl;
+    std::cout << std::format("sizeof(Order) {}, {} resting, {} requests, {} executions",
+        sizeof(Order), resting, flow.size(), executions) << std::endl;
+    std::cout << std::format("{:>14} {:>16} {:>16}", "ns/request", "LLC miss/req", "L1D miss/req") << std::endl;
+    std::cout << std::format("{:>14.1f} {:>16} {:>16}",
+        static_cast<double>(elapsed) / static_cast<double>(flow.size()),
+        PerRequest(cacheMisses.Read(), flow.size()),
+        PerRequest(l1dMisses.Read(), flow.size())) << std::endl;
+
+    return 0;
+}
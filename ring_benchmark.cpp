@@ -0,0 +1,247 @@
+#include "LockFreeQueue.h"
+
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <format>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// SPSC ring benchmark: LockFreeQueue against the modulo ring it replaced.
+//
+// Same thread: ns per push+pop pair with the ring kept shallow, so the cost
+// is the index arithmetic and the loads of the other side's index.
+// Cross core: a producer and a consumer thread (pinned to the two given
+// cores) move a stream of 32-byte items, one at a time and in batches of
+// `batch` (claim/commit and peek/release). Reports M items/s and ns/item.
+//
+// Usage: ./ring_benchmark [items] [batch] [producer cpu] [consumer cpu]
+//        (default: 50000000 32 0 1; a cpu of -1 leaves that thread unpinned)
+
+namespace
+{
+    // Request-sized payload.
+    struct Item
+    {
+        uint64_t sequence;
+        uint64_t payload[3];
+    };
+
+    // The previous LockFreeQueue: modulo indexing, both indices on one line,
+    // and the other side's index re-read on every operation.
+    template<typename T>
+    class ModuloRing
+    {
+    public:
+        explicit ModuloRing(size_t size) : buffer_(size), capacity_(size) { }
+
+        bool Push(const T& item)
+        {
+            const size_t tail = tail_.load(std::memory_order_relaxed);
+            const size_t next = (tail + 1) % capacity_;
+            if (next == head_.load(std::memory_order_acquire))
+                return false;
+            buffer_[tail] = item;
+            tail_.store(next, std::memory_order_release);
+            return true;
+        }
+
+        bool Pop(T& item)
+        {
+            const size_t head = head_.load(std::memory_order_relaxed);
+            if (head == tail_.load(std::memory_order_acquire))
+                return false;
+            item = buffer_[head];
+            head_.store((head + 1) % capacity_, std::memory_order_release);
+            return true;
+        }
+
+    private:
+        std::vector<T> buffer_;
+        size_t capacity_;
+        std::atomic<size_t> head_{ 0 };
+        std::atomic<size_t> tail_{ 0 };
+    };
+
+    constexpr size_t RingSize = 65536;
+
+    void Pin(int cpu)
+    {
+#if defined(__linux__)
+        if (cpu < 0)
+            return;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+        (void)cpu;
+#endif
+    }
+
+    double NsPerItem(std::chrono::steady_clock::duration elapsed, size_t items)
+    {
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count())
+            / static_cast<double>(items);
+    }
+
+    template<typename Ring>
+    double SameThread(size_t items)
+    {
+        auto ring = std::make_unique<Ring>(RingSize);
+        Item item{ };
+        uint64_t sum = 0;
+
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < items; ++i)
+        {
+            item.sequence = i;
+            ring->Push(item);
+            ring->Pop(item);
+            sum += item.sequence;
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+
+        if (sum != items * (items - 1) / 2)
+            std::cerr << "same-thread checksum mismatch\n";
+        return NsPerItem(elapsed, items);
+    }
+
+    // Runs produce() and consume() on their cores; both return once `items`
+    // have gone through. Returns the wall-clock ns.
+    template<typename Produce, typename Consume>
+    double CrossCore(int producerCpu, int consumerCpu, Produce&& produce, Consume&& consume)
+    {
+        std::atomic<int> ready{ 0 };
+        std::atomic<bool> go{ false };
+
+        std::thread consumer([&] {
+            Pin(consumerCpu);
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire))
+                ;
+            consume();
+        });
+        std::thread producer([&] {
+            Pin(producerCpu);
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire))
+                ;
+            produce();
+        });
+
+        while (ready.load() < 2)
+            std::this_thread::yield();
+        const auto start = std::chrono::steady_clock::now();
+        go.store(true, std::memory_order_release);
+
+        producer.join();
+        consumer.join();
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count());
+    }
+
+    template<typename Ring>
+    double OneAtATime(size_t items, int producerCpu, int consumerCpu)
+    {
+        auto ring = std::make_unique<Ring>(RingSize);
+        uint64_t errors = 0;
+
+        const double ns = CrossCore(producerCpu, consumerCpu,
+            [&] {
+                Item item{ };
+                for (size_t i = 0; i < items; ++i)
+                {
+                    item.sequence = i;
+                    while (!ring->Push(item))
+                        ;
+                }
+            },
+            [&] {
+                Item item{ };
+                for (size_t i = 0; i < items; ++i)
+                {
+                    while (!ring->Pop(item))
+                        ;
+                    errors += item.sequence != i;
+                }
+            });
+
+        if (errors != 0)
+            std::cerr << "one-at-a-time: " << errors << " items out of order\n";
+        return ns / static_cast<double>(items);
+    }
+
+    // Producer writes spans in place, consumer reads them in place.
+    double Batched(size_t items, size_t batch, int producerCpu, int consumerCpu)
+    {
+        auto ring = std::make_unique<LockFreeQueue<Item>>(RingSize);
+        uint64_t errors = 0;
+
+        const double ns = CrossCore(producerCpu, consumerCpu,
+            [&] {
+                size_t sent = 0;
+                while (sent < items)
+                {
+                    const auto slots = ring->TryClaim(std::min(batch, items - sent));
+                    for (size_t i = 0; i < slots.Size(); ++i)
+                        slots[i].sequence = sent + i;
+                    if (!slots.IsEmpty())
+                        ring->Commit(slots.Size());
+                    sent += slots.Size();
+                }
+            },
+            [&] {
+                size_t received = 0;
+                while (received < items)
+                {
+                    const auto slots = ring->PeekBatch(batch);
+                    for (size_t i = 0; i < slots.Size(); ++i)
+                        errors += slots[i].sequence != received + i;
+                    if (!slots.IsEmpty())
+                        ring->Release(slots.Size());
+                    received += slots.Size();
+                }
+            });
+
+        if (errors != 0)
+            std::cerr << "batched: " << errors << " items out of order\n";
+        return ns / static_cast<double>(items);
+    }
+
+    void Report(const std::string& name, double nsPerItem)
+    {
+        std::cout << std::format("{:<34} {:>8.2f} ns/item {:>9.1f} M items/s\n", name, nsPerItem, 1e3 / nsPerItem);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const size_t items = argc > 1 ? std::stoull(argv[1]) : 50'000'000;
+    const size_t batch = argc > 2 ? std::stoull(argv[2]) : 32;
+    const int producerCpu = argc > 3 ? std::stoi(argv[3]) : 0;
+    const int consumerCpu = argc > 4 ? std::stoi(argv[4]) : 1;
+
+    std::cout << std::format("{} items of {} bytes, ring of {}, producer cpu {}, consumer cpu {}\n\n",
+        items, sizeof(Item), RingSize, producerCpu, consumerCpu);
+
+    std::cout << "Same thread (push + pop)\n";
+    Report("  modulo ring", SameThread<ModuloRing<Item>>(items));
+    Report("  LockFreeQueue", SameThread<LockFreeQueue<Item>>(items));
+
+    std::cout << "\nCross core\n";
+    Report("  modulo ring, one at a time", OneAtATime<ModuloRing<Item>>(items, producerCpu, consumerCpu));
+    Report("  LockFreeQueue, one at a time", OneAtATime<LockFreeQueue<Item>>(items, producerCpu, consumerCpu));
+    Report(std::format("  LockFreeQueue, batches of {}", batch), Batched(items, batch, producerCpu, consumerCpu));
+
+    return 0;
+}